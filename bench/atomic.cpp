@@ -0,0 +1,68 @@
+#include <mutex>
+#include <benchmark/benchmark.h>
+#include <wide_integer/atomic.h>
+
+namespace
+{
+
+using U128 = wide::integer<128, unsigned>;
+using U256 = wide::integer<256, unsigned>;
+
+/// The usual replacement for a missing atomic: a plain value under a mutex.
+template <typename T>
+struct MutexCounter
+{
+    void add(const T & delta)
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        value += delta;
+    }
+
+    std::mutex mutex;
+    T value = 0;
+};
+
+template <typename T>
+struct AtomicCounter
+{
+    void add(const T & delta) { value.fetch_add(delta); }
+
+    wide::atomic<T> value;
+};
+
+template <size_t Bits>
+struct ShardedCounter
+{
+    void add(const wide::integer<Bits, unsigned> & delta) { value.add(delta); }
+
+    wide::sharded_counter<Bits, unsigned> value;
+};
+
+}
+
+/// All threads add into one shared counter; the delta carries into the high item on most additions.
+template <typename Counter, typename T>
+static void BM_Contended(benchmark::State & state)
+{
+    static Counter * counter = nullptr;
+    if (state.thread_index() == 0)
+        counter = new Counter;
+    const T delta = (T(1) << 64) - T(state.thread_index() + 1);
+    for (auto _ : state)
+        counter->add(delta);
+    state.SetItemsProcessed(state.iterations());
+    if (state.thread_index() == 0)
+    {
+        delete counter;
+        counter = nullptr;
+    }
+}
+
+BENCHMARK_TEMPLATE(BM_Contended, MutexCounter<U128>, U128)->ThreadRange(1, 4)->UseRealTime();
+BENCHMARK_TEMPLATE(BM_Contended, AtomicCounter<U128>, U128)->ThreadRange(1, 4)->UseRealTime();
+BENCHMARK_TEMPLATE(BM_Contended, ShardedCounter<128>, U128)->ThreadRange(1, 4)->UseRealTime();
+BENCHMARK_TEMPLATE(BM_Contended, MutexCounter<U256>, U256)->ThreadRange(1, 4)->UseRealTime();
+BENCHMARK_TEMPLATE(BM_Contended, AtomicCounter<U256>, U256)->ThreadRange(1, 4)->UseRealTime();
+BENCHMARK_TEMPLATE(BM_Contended, ShardedCounter<256>, U256)->ThreadRange(1, 4)->UseRealTime();
+
+BENCHMARK_MAIN();
@@ -0,0 +1,167 @@
+#include <random>
+#include <vector>
+#include <benchmark/benchmark.h>
+#include <wide_integer/batch.h>
+
+using Int256 = wide::integer<256, signed>;
+
+namespace
+{
+
+constexpr size_t count = 4096;
+
+std::vector<int64_t> random_int64()
+{
+    std::mt19937_64 rng(40);
+    std::vector<int64_t> values(count);
+    for (auto & x : values)
+        x = static_cast<int64_t>(rng());
+    return values;
+}
+
+}
+
+/// Widening one element at a time through the converting constructor.
+static void BM_WidenConstructor(benchmark::State & state)
+{
+    const auto in = random_int64();
+    std::vector<Int256> out(count);
+    for (auto _ : state)
+    {
+        for (size_t i = 0; i < count; ++i)
+            out[i] = Int256(in[i]);
+        benchmark::DoNotOptimize(out.data());
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * count);
+}
+
+static void BM_WidenConvert(benchmark::State & state)
+{
+    const auto in = random_int64();
+    std::vector<Int256> out(count);
+    for (auto _ : state)
+    {
+        wide::batch::convert(in.data(), out.data(), count);
+        benchmark::DoNotOptimize(out.data());
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * count);
+}
+
+/// Narrowing with a per-element range check against numeric_limits.
+static void BM_NarrowCompare(benchmark::State & state)
+{
+    const auto narrow = random_int64();
+    const std::vector<Int256> in(narrow.begin(), narrow.end());
+    std::vector<int64_t> out(count);
+    for (auto _ : state)
+    {
+        size_t bad = count;
+        for (size_t i = 0; i < count; ++i)
+        {
+            if (in[i] < std::numeric_limits<int64_t>::min() || in[i] > std::numeric_limits<int64_t>::max())
+            {
+                bad = i;
+                break;
+            }
+            out[i] = static_cast<int64_t>(in[i]);
+        }
+        benchmark::DoNotOptimize(bad);
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * count);
+}
+
+static void BM_NarrowChecked(benchmark::State & state)
+{
+    const auto narrow = random_int64();
+    const std::vector<Int256> in(narrow.begin(), narrow.end());
+    std::vector<int64_t> out(count);
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(wide::batch::narrow_checked(in.data(), out.data(), count));
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * count);
+}
+
+/// Big-endian bytes written one at a time with shifts, as protocol code does without store_be.
+static void BM_StoreBeShifts(benchmark::State & state)
+{
+    const auto narrow = random_int64();
+    const std::vector<Int256> in(narrow.begin(), narrow.end());
+    std::vector<uint8_t> out(count * 32);
+    for (auto _ : state)
+    {
+        for (size_t i = 0; i < count; ++i)
+            for (int b = 0; b < 32; ++b)
+                out[i * 32 + b] = static_cast<uint8_t>(in[i] >> (8 * (31 - b)));
+        benchmark::DoNotOptimize(out.data());
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * count);
+}
+
+static void BM_StoreBe(benchmark::State & state)
+{
+    const auto narrow = random_int64();
+    const std::vector<Int256> in(narrow.begin(), narrow.end());
+    std::vector<uint8_t> out(count * 32);
+    for (auto _ : state)
+    {
+        wide::batch::store_be(in.data(), out.data(), count);
+        benchmark::DoNotOptimize(out.data());
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * count);
+}
+
+static void BM_LoadBeShifts(benchmark::State & state)
+{
+    std::vector<uint8_t> in(count * 32);
+    std::mt19937_64 rng(41);
+    for (auto & byte : in)
+        byte = static_cast<uint8_t>(rng());
+    std::vector<Int256> out(count);
+    for (auto _ : state)
+    {
+        for (size_t i = 0; i < count; ++i)
+        {
+            Int256 x = 0;
+            for (int b = 0; b < 32; ++b)
+                x = (x << 8) | Int256(in[i * 32 + b]);
+            out[i] = x;
+        }
+        benchmark::DoNotOptimize(out.data());
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * count);
+}
+
+static void BM_LoadBe(benchmark::State & state)
+{
+    std::vector<uint8_t> in(count * 32);
+    std::mt19937_64 rng(41);
+    for (auto & byte : in)
+        byte = static_cast<uint8_t>(rng());
+    std::vector<Int256> out(count);
+    for (auto _ : state)
+    {
+        wide::batch::load_be(in.data(), out.data(), count);
+        benchmark::DoNotOptimize(out.data());
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * count);
+}
+
+BENCHMARK(BM_WidenConstructor);
+BENCHMARK(BM_WidenConvert);
+BENCHMARK(BM_NarrowCompare);
+BENCHMARK(BM_NarrowChecked);
+BENCHMARK(BM_StoreBeShifts);
+BENCHMARK(BM_StoreBe);
+BENCHMARK(BM_LoadBeShifts);
+BENCHMARK(BM_LoadBe);
+
+BENCHMARK_MAIN();
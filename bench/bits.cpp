@@ -0,0 +1,223 @@
+#include <array>
+#include <random>
+#include <vector>
+#include <benchmark/benchmark.h>
+#include <wide_integer/bits.h>
+
+template <size_t Bits>
+using UInt = wide::integer<Bits, unsigned>;
+
+namespace
+{
+
+constexpr size_t count = 1024;
+
+template <size_t Bits>
+std::vector<UInt<Bits>> random_values(uint64_t seed)
+{
+    std::mt19937_64 rng(seed);
+    std::vector<UInt<Bits>> values(count);
+    for (auto & x : values)
+        for (auto & item : x.items)
+            item = rng();
+    return values;
+}
+
+template <unsigned Dims>
+std::vector<std::array<uint64_t, Dims>> random_coords()
+{
+    std::mt19937_64 rng(35);
+    std::vector<std::array<uint64_t, Dims>> coords(count);
+    for (auto & c : coords)
+        for (auto & x : c)
+            x = rng();
+    return coords;
+}
+
+}
+
+/// The bit-at-a-time loop that the keys used to be built with.
+template <unsigned Dims, size_t Bits>
+static void BM_MortonLoop(benchmark::State & state)
+{
+    constexpr unsigned coordinate_bits = Bits / Dims < 64 ? Bits / Dims : 64;
+    const auto coords = random_coords<Dims>();
+    for (auto _ : state)
+    {
+        for (const auto & c : coords)
+        {
+            UInt<Bits> key = 0;
+            for (unsigned j = 0; j < coordinate_bits; ++j)
+                for (unsigned d = 0; d < Dims; ++d)
+                    key |= UInt<Bits>((c[d] >> j) & 1) << int(j * Dims + d);
+            benchmark::DoNotOptimize(key);
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * count);
+}
+
+template <unsigned Dims, size_t Bits>
+static void BM_MortonEncode(benchmark::State & state)
+{
+    const auto coords = random_coords<Dims>();
+    for (auto _ : state)
+    {
+        for (const auto & c : coords)
+        {
+            auto key = wide::morton_encode<Dims, Bits>(c);
+            benchmark::DoNotOptimize(key);
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * count);
+}
+
+template <unsigned Dims, size_t Bits>
+static void BM_MortonDecode(benchmark::State & state)
+{
+    std::vector<UInt<Bits>> keys;
+    for (const auto & c : random_coords<Dims>())
+        keys.push_back(wide::morton_encode<Dims, Bits>(c));
+    for (auto _ : state)
+    {
+        for (const auto & key : keys)
+        {
+            auto c = wide::morton_decode<Dims>(key);
+            benchmark::DoNotOptimize(c);
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * count);
+}
+
+template <size_t Bits>
+static void BM_Pdep(benchmark::State & state)
+{
+    const auto values = random_values<Bits>(1);
+    const auto masks = random_values<Bits>(2);
+    for (auto _ : state)
+    {
+        for (size_t i = 0; i < count; ++i)
+        {
+            auto res = wide::pdep(values[i], masks[i]);
+            benchmark::DoNotOptimize(res);
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * count);
+}
+
+template <size_t Bits>
+static void BM_Pext(benchmark::State & state)
+{
+    const auto values = random_values<Bits>(1);
+    const auto masks = random_values<Bits>(2);
+    for (auto _ : state)
+    {
+        for (size_t i = 0; i < count; ++i)
+        {
+            auto res = wide::pext(values[i], masks[i]);
+            benchmark::DoNotOptimize(res);
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * count);
+}
+
+/// Bits [offset, offset + 64) of each value, shifting the whole value first.
+template <size_t Bits>
+static void BM_ExtractShiftMask(benchmark::State & state)
+{
+    const auto values = random_values<Bits>(3);
+    for (auto _ : state)
+    {
+        for (size_t i = 0; i < count; ++i)
+        {
+            uint64_t bits = static_cast<uint64_t>(values[i] >> int(i % (Bits - 64)));
+            benchmark::DoNotOptimize(bits);
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * count);
+}
+
+template <size_t Bits>
+static void BM_ExtractBits(benchmark::State & state)
+{
+    const auto values = random_values<Bits>(3);
+    for (auto _ : state)
+    {
+        for (size_t i = 0; i < count; ++i)
+        {
+            uint64_t bits = wide::extract_bits<64>(values[i], unsigned(i % (Bits - 64)));
+            benchmark::DoNotOptimize(bits);
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * count);
+}
+
+template <size_t Bits>
+static void BM_InsertBits(benchmark::State & state)
+{
+    auto values = random_values<Bits>(3);
+    for (auto _ : state)
+    {
+        for (size_t i = 0; i < count; ++i)
+            wide::insert_bits<64>(values[i], unsigned(i % (Bits - 64)), i);
+        benchmark::DoNotOptimize(values.data());
+    }
+    state.SetItemsProcessed(state.iterations() * count);
+}
+
+/// Window of the concatenation of two values through a double-width shift.
+template <size_t Bits>
+static void BM_FunnelShiftWide(benchmark::State & state)
+{
+    const auto hi = random_values<Bits>(4);
+    const auto lo = random_values<Bits>(5);
+    for (auto _ : state)
+    {
+        for (size_t i = 0; i < count; ++i)
+        {
+            const UInt<2 * Bits> concat = (UInt<2 * Bits>(hi[i]) << int(Bits)) | UInt<2 * Bits>(lo[i]);
+            auto res = UInt<Bits>(concat >> int(i % Bits));
+            benchmark::DoNotOptimize(res);
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * count);
+}
+
+template <size_t Bits>
+static void BM_FunnelShift(benchmark::State & state)
+{
+    const auto hi = random_values<Bits>(4);
+    const auto lo = random_values<Bits>(5);
+    for (auto _ : state)
+    {
+        for (size_t i = 0; i < count; ++i)
+        {
+            auto res = wide::funnel_shift(hi[i], lo[i], unsigned(i % Bits));
+            benchmark::DoNotOptimize(res);
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * count);
+}
+
+BENCHMARK_TEMPLATE(BM_MortonLoop, 2, 128);
+BENCHMARK_TEMPLATE(BM_MortonEncode, 2, 128);
+BENCHMARK_TEMPLATE(BM_MortonDecode, 2, 128);
+BENCHMARK_TEMPLATE(BM_MortonLoop, 3, 192);
+BENCHMARK_TEMPLATE(BM_MortonEncode, 3, 192);
+BENCHMARK_TEMPLATE(BM_MortonDecode, 3, 192);
+BENCHMARK_TEMPLATE(BM_MortonLoop, 4, 256);
+BENCHMARK_TEMPLATE(BM_MortonEncode, 4, 256);
+BENCHMARK_TEMPLATE(BM_MortonDecode, 4, 256);
+BENCHMARK_TEMPLATE(BM_MortonLoop, 8, 512);
+BENCHMARK_TEMPLATE(BM_MortonEncode, 8, 512);
+BENCHMARK_TEMPLATE(BM_MortonDecode, 8, 512);
+BENCHMARK_TEMPLATE(BM_Pdep, 256);
+BENCHMARK_TEMPLATE(BM_Pext, 256);
+BENCHMARK_TEMPLATE(BM_Pdep, 512);
+BENCHMARK_TEMPLATE(BM_Pext, 512);
+BENCHMARK_TEMPLATE(BM_ExtractShiftMask, 1024);
+BENCHMARK_TEMPLATE(BM_ExtractBits, 1024);
+BENCHMARK_TEMPLATE(BM_InsertBits, 1024);
+BENCHMARK_TEMPLATE(BM_FunnelShiftWide, 256);
+BENCHMARK_TEMPLATE(BM_FunnelShift, 256);
+
+BENCHMARK_MAIN();
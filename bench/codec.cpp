@@ -0,0 +1,94 @@
+#include <cstring>
+#include <random>
+#include <vector>
+#include <benchmark/benchmark.h>
+#include <wide_integer/codec.h>
+
+using Int256 = wide::integer<256, signed>;
+
+namespace
+{
+
+constexpr size_t count = 4096;
+
+/// 0: readings within +-2^20 of a large base, 1: increasing IDs, 2: timestamps at a jittered step,
+/// 3: amounts of up to 64 bits with one in twenty up to 192 bits.
+std::vector<Int256> column(int64_t kind)
+{
+    std::mt19937_64 rng(43);
+    const Int256 base = (Int256(1) << 200) + Int256(987654321);
+    std::vector<Int256> values(count);
+    Int256 id = base;
+    for (size_t i = 0; i < count; ++i)
+    {
+        if (kind == 0)
+            values[i] = base + Int256(static_cast<int64_t>(rng() % (1 << 21))) - Int256(1 << 20);
+        else if (kind == 1)
+            values[i] = id += Int256(1 + rng() % 5000);
+        else if (kind == 2)
+            values[i] = base + Int256(static_cast<int64_t>(i * 1000000 + rng() % 16));
+        else
+            values[i] = rng() % 20 ? Int256(rng() >> (rng() % 64)) : (Int256(rng()) << 128) + Int256(rng());
+    }
+    return values;
+}
+
+}
+
+/// The uncompressed column, copied as is.
+static void BM_DecodeCopy(benchmark::State & state)
+{
+    const auto values = column(state.range(0));
+    std::vector<Int256> out(count);
+    for (auto _ : state)
+    {
+        std::memcpy(out.data(), values.data(), count * sizeof(Int256));
+        benchmark::ClobberMemory();
+    }
+    state.counters["ratio"] = 1;
+    state.SetBytesProcessed(state.iterations() * count * sizeof(Int256));
+}
+
+template <wide::codec::scheme Scheme>
+static void BM_Encode(benchmark::State & state)
+{
+    const auto values = column(state.range(0));
+    std::vector<uint8_t> bytes(wide::codec::max_encoded_size<256>(count));
+    size_t size = 0;
+    for (auto _ : state)
+    {
+        size = wide::codec::encode(values.data(), count, bytes.data(), Scheme);
+        benchmark::ClobberMemory();
+    }
+    state.counters["ratio"] = double(count * sizeof(Int256)) / double(size);
+    state.SetBytesProcessed(state.iterations() * count * sizeof(Int256));
+}
+
+/// Throughput counts the decoded bytes.
+template <wide::codec::scheme Scheme>
+static void BM_Decode(benchmark::State & state)
+{
+    const auto values = column(state.range(0));
+    std::vector<uint8_t> bytes(wide::codec::max_encoded_size<256>(count));
+    const size_t size = wide::codec::encode(values.data(), count, bytes.data(), Scheme);
+    std::vector<Int256> out(count);
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(wide::codec::decode(bytes.data(), bytes.data() + size, out.data()));
+        benchmark::ClobberMemory();
+    }
+    state.counters["ratio"] = double(count * sizeof(Int256)) / double(size);
+    state.SetBytesProcessed(state.iterations() * count * sizeof(Int256));
+}
+
+BENCHMARK(BM_DecodeCopy)->Arg(0);
+BENCHMARK_TEMPLATE(BM_Encode, wide::codec::scheme::frame_of_reference)->DenseRange(0, 3);
+BENCHMARK_TEMPLATE(BM_Encode, wide::codec::scheme::delta)->DenseRange(0, 3);
+BENCHMARK_TEMPLATE(BM_Encode, wide::codec::scheme::delta_of_delta)->DenseRange(0, 3);
+BENCHMARK_TEMPLATE(BM_Encode, wide::codec::scheme::trim_limbs)->DenseRange(0, 3);
+BENCHMARK_TEMPLATE(BM_Decode, wide::codec::scheme::frame_of_reference)->DenseRange(0, 3);
+BENCHMARK_TEMPLATE(BM_Decode, wide::codec::scheme::delta)->DenseRange(0, 3);
+BENCHMARK_TEMPLATE(BM_Decode, wide::codec::scheme::delta_of_delta)->DenseRange(0, 3);
+BENCHMARK_TEMPLATE(BM_Decode, wide::codec::scheme::trim_limbs)->DenseRange(0, 3);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,192 @@
+#include <random>
+#include <string>
+#include <vector>
+#include <benchmark/benchmark.h>
+#include <wide_integer/decimal.h>
+
+template <size_t Bits>
+using Int = wide::integer<Bits, signed>;
+
+namespace
+{
+
+constexpr size_t count = 1024;
+constexpr unsigned scale = 6;
+
+/// Prices with about 30 significant digits, both signs.
+template <size_t Bits>
+std::vector<wide::decimal<Bits, scale>> random_prices(uint64_t seed)
+{
+    std::mt19937_64 rng(seed);
+    std::vector<wide::decimal<Bits, scale>> values(count);
+    for (auto & x : values)
+        x = wide::decimal<Bits, scale>::from_raw(Int<Bits>(int64_t(rng())) * Int<Bits>(rng() >> 12));
+    return values;
+}
+
+template <size_t Bits>
+std::vector<std::string> random_texts()
+{
+    std::vector<std::string> texts;
+    for (const auto & x : random_prices<Bits>(3))
+        texts.push_back(wide::to_string(x));
+    return texts;
+}
+
+}
+
+/// The product as it is written on top of the integers alone: widen, multiply, divide by 10^scale.
+template <size_t Bits>
+static void BM_MulDivide(benchmark::State & state)
+{
+    const auto a = random_prices<Bits>(1);
+    const auto b = random_prices<Bits>(2);
+    const Int<2 * Bits> divisor = Int<2 * Bits>(wide::pow10<Bits>[scale]);
+    for (auto _ : state)
+    {
+        for (size_t i = 0; i < count; ++i)
+        {
+            auto res = Int<Bits>(wide::mul_wide(a[i].raw(), b[i].raw()) / divisor);
+            benchmark::DoNotOptimize(res);
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * count);
+}
+
+template <size_t Bits>
+static void BM_Mul(benchmark::State & state)
+{
+    const auto a = random_prices<Bits>(1);
+    const auto b = random_prices<Bits>(2);
+    for (auto _ : state)
+    {
+        for (size_t i = 0; i < count; ++i)
+        {
+            auto res = a[i] * b[i];
+            benchmark::DoNotOptimize(res);
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * count);
+}
+
+/// Scale 6 plus scale 9, aligned with a full-width multiplication by 1000.
+template <size_t Bits>
+static void BM_AddMixedMultiply(benchmark::State & state)
+{
+    const auto a = random_prices<Bits>(1);
+    const auto b = random_prices<Bits>(2);
+    const Int<Bits> multiplier = 1000;
+    for (auto _ : state)
+    {
+        for (size_t i = 0; i < count; ++i)
+        {
+            auto res = a[i].raw() * multiplier + b[i].raw();
+            benchmark::DoNotOptimize(res);
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * count);
+}
+
+template <size_t Bits>
+static void BM_AddMixed(benchmark::State & state)
+{
+    const auto a = random_prices<Bits>(1);
+    std::vector<wide::decimal<Bits, scale + 3>> b;
+    for (const auto & x : random_prices<Bits>(2))
+        b.push_back(wide::decimal<Bits, scale + 3>::from_raw(x.raw()));
+    for (auto _ : state)
+    {
+        for (size_t i = 0; i < count; ++i)
+        {
+            auto res = a[i] + b[i];
+            benchmark::DoNotOptimize(res);
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * count);
+}
+
+/// to_string of the raw integer with the decimal point inserted afterwards.
+template <size_t Bits>
+static void BM_ToStringInsert(benchmark::State & state)
+{
+    const auto values = random_prices<Bits>(3);
+    for (auto _ : state)
+    {
+        for (const auto & x : values)
+        {
+            std::string text = wide::to_string(x.raw());
+            text.insert(text.size() - scale, 1, '.');
+            benchmark::DoNotOptimize(text);
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * count);
+}
+
+template <size_t Bits>
+static void BM_ToChars(benchmark::State & state)
+{
+    const auto values = random_prices<Bits>(3);
+    char buf[128];
+    for (auto _ : state)
+    {
+        for (const auto & x : values)
+        {
+            auto res = wide::to_chars(buf, buf + sizeof(buf), x);
+            benchmark::DoNotOptimize(res);
+            benchmark::DoNotOptimize(buf);
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * count);
+}
+
+/// One multiply-add of the full integer per digit.
+template <size_t Bits>
+static void BM_ParseDigitLoop(benchmark::State & state)
+{
+    const auto texts = random_texts<Bits>();
+    for (auto _ : state)
+    {
+        for (const auto & text : texts)
+        {
+            Int<Bits> x = 0;
+            bool negative = text[0] == '-';
+            for (char c : text)
+                if (c >= '0' && c <= '9')
+                    x = x * Int<Bits>(10) + Int<Bits>(c - '0');
+            if (negative)
+                x = -x;
+            benchmark::DoNotOptimize(x);
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * count);
+}
+
+template <size_t Bits>
+static void BM_FromChars(benchmark::State & state)
+{
+    const auto texts = random_texts<Bits>();
+    wide::decimal<Bits, scale> x;
+    for (auto _ : state)
+    {
+        for (const auto & text : texts)
+        {
+            auto res = wide::from_chars(text.data(), text.data() + text.size(), x);
+            benchmark::DoNotOptimize(res);
+            benchmark::DoNotOptimize(x);
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * count);
+}
+
+BENCHMARK_TEMPLATE(BM_MulDivide, 128);
+BENCHMARK_TEMPLATE(BM_Mul, 128);
+BENCHMARK_TEMPLATE(BM_MulDivide, 256);
+BENCHMARK_TEMPLATE(BM_Mul, 256);
+BENCHMARK_TEMPLATE(BM_AddMixedMultiply, 256);
+BENCHMARK_TEMPLATE(BM_AddMixed, 256);
+BENCHMARK_TEMPLATE(BM_ToStringInsert, 256);
+BENCHMARK_TEMPLATE(BM_ToChars, 256);
+BENCHMARK_TEMPLATE(BM_ParseDigitLoop, 256);
+BENCHMARK_TEMPLATE(BM_FromChars, 256);
+
+BENCHMARK_MAIN();
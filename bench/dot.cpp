@@ -0,0 +1,87 @@
+#include <cstdint>
+#include <random>
+#include <vector>
+#include <benchmark/benchmark.h>
+#include <wide_integer/dot.h>
+
+namespace
+{
+
+using S576 = wide::integer<576, signed>;
+
+/// Signed prices and quantities of mixed magnitude, as in our exposure columns.
+std::vector<Int256> make_column(uint64_t seed, size_t n)
+{
+    std::mt19937_64 rng(seed);
+    std::vector<Int256> column(n);
+    for (auto & x : column)
+    {
+        for (auto & item : x.items)
+            item = rng();
+        x >>= int(rng() % 192);
+    }
+    return column;
+}
+
+}
+
+/// The truncating sum, which is wrong once a product exceeds 256 bits; for reference only.
+static void BM_TruncatedSum(benchmark::State & state)
+{
+    const size_t n = static_cast<size_t>(state.range(0));
+    const auto a = make_column(1, n);
+    const auto b = make_column(2, n);
+    for (auto _ : state)
+    {
+        Int256 sum = 0;
+        for (size_t i = 0; i < n; ++i)
+            sum += a[i] * b[i];
+        benchmark::DoNotOptimize(sum);
+    }
+    state.SetItemsProcessed(state.iterations() * n);
+}
+
+/// The exact sum with the operators at hand: a widening product, widened again and added.
+static void BM_MulWideSum(benchmark::State & state)
+{
+    const size_t n = static_cast<size_t>(state.range(0));
+    const auto a = make_column(1, n);
+    const auto b = make_column(2, n);
+    for (auto _ : state)
+    {
+        S576 sum = 0;
+        for (size_t i = 0; i < n; ++i)
+            sum += S576(wide::mul_wide(a[i], b[i]));
+        benchmark::DoNotOptimize(sum);
+    }
+    state.SetItemsProcessed(state.iterations() * n);
+}
+
+static void BM_Dot(benchmark::State & state)
+{
+    const size_t n = static_cast<size_t>(state.range(0));
+    const auto a = make_column(1, n);
+    const auto b = make_column(2, n);
+    for (auto _ : state)
+        benchmark::DoNotOptimize(wide::dot(a.data(), b.data(), n));
+    state.SetItemsProcessed(state.iterations() * n);
+}
+
+/// The second argument is the pool size.
+static void BM_DotPool(benchmark::State & state)
+{
+    const size_t n = static_cast<size_t>(state.range(0));
+    const auto a = make_column(1, n);
+    const auto b = make_column(2, n);
+    wide::thread_pool pool(static_cast<size_t>(state.range(1)));
+    for (auto _ : state)
+        benchmark::DoNotOptimize(wide::dot(a.data(), b.data(), n, pool));
+    state.SetItemsProcessed(state.iterations() * n);
+}
+
+BENCHMARK(BM_TruncatedSum)->Arg(1 << 16)->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_MulWideSum)->Arg(1 << 16)->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_Dot)->Arg(1 << 16)->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_DotPool)->Args({1 << 16, 1})->Args({1 << 16, 2})->Args({1 << 16, 4})->UseRealTime()->Unit(benchmark::kMicrosecond);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,160 @@
+#include <cstdint>
+#include <random>
+#include <unordered_map>
+#include <vector>
+#include <benchmark/benchmark.h>
+#include <wide_integer/flat_map.h>
+
+namespace
+{
+
+using Map = wide::flat_map<256, unsigned, uint64_t>;
+
+/// The std::hash of wide::integer before it mixed the items, for comparison.
+struct XorFoldHash
+{
+    size_t operator()(const UInt256 & x) const noexcept { return x.items[0] ^ x.items[1] ^ x.items[2] ^ x.items[3]; }
+};
+
+/// Shape 0: account-like keys, a shared high part and a counter, as the IDs in our join inputs.
+/// Shape 1: keys whose high half repeats the low half, all of which the XOR fold maps to 0.
+std::vector<UInt256> make_keys(const benchmark::State & state)
+{
+    const size_t n = static_cast<size_t>(state.range(0));
+    std::mt19937_64 rng(50);
+    const UInt256 prefix = (UInt256(0xFEEDFACECAFEBEEFULL) << 192) | (UInt256(rng()) << 128);
+    std::vector<UInt256> keys(n);
+    for (size_t i = 0; i < n; ++i)
+    {
+        const UInt256 low = (UInt256(rng() % (4 * n)) << 64) | UInt256(i);
+        keys[i] = state.range(1) == 0 ? prefix | low : (low << 128) | low;
+    }
+    return keys;
+}
+
+/// Every other probe is a key of the table, in random order.
+std::vector<UInt256> make_probes(const std::vector<UInt256> & keys)
+{
+    std::mt19937_64 rng(49);
+    std::vector<UInt256> probes(keys.size());
+    for (size_t i = 0; i < probes.size(); ++i)
+        probes[i] = i % 2 ? keys[rng() % keys.size()] : keys[rng() % keys.size()] + (UInt256(1) << 255);
+    return probes;
+}
+
+}
+
+template <typename Table>
+static void BM_InsertStd(benchmark::State & state)
+{
+    const auto keys = make_keys(state);
+    for (auto _ : state)
+    {
+        Table table;
+        for (size_t i = 0; i < keys.size(); ++i)
+            table.emplace(keys[i], i);
+        benchmark::DoNotOptimize(table.size());
+    }
+    state.SetItemsProcessed(state.iterations() * keys.size());
+}
+
+static void BM_InsertFlat(benchmark::State & state)
+{
+    const auto keys = make_keys(state);
+    for (auto _ : state)
+    {
+        Map table;
+        for (size_t i = 0; i < keys.size(); ++i)
+            table.try_emplace(keys[i], i);
+        benchmark::DoNotOptimize(table.size());
+    }
+    state.SetItemsProcessed(state.iterations() * keys.size());
+}
+
+static void BM_InsertFlatBatch(benchmark::State & state)
+{
+    const auto keys = make_keys(state);
+    std::vector<uint64_t> values(keys.size());
+    for (auto _ : state)
+    {
+        Map table;
+        table.insert(keys.data(), values.data(), keys.size());
+        benchmark::DoNotOptimize(table.size());
+    }
+    state.SetItemsProcessed(state.iterations() * keys.size());
+}
+
+template <typename Table>
+static void BM_FindStd(benchmark::State & state)
+{
+    const auto keys = make_keys(state);
+    const auto probes = make_probes(keys);
+    Table table;
+    for (size_t i = 0; i < keys.size(); ++i)
+        table.emplace(keys[i], i);
+    for (auto _ : state)
+    {
+        uint64_t sum = 0;
+        for (const auto & probe : probes)
+        {
+            const auto it = table.find(probe);
+            sum += it == table.end() ? 0 : it->second;
+        }
+        benchmark::DoNotOptimize(sum);
+    }
+    state.SetItemsProcessed(state.iterations() * probes.size());
+}
+
+static void BM_FindFlat(benchmark::State & state)
+{
+    const auto keys = make_keys(state);
+    const auto probes = make_probes(keys);
+    Map table;
+    for (size_t i = 0; i < keys.size(); ++i)
+        table.try_emplace(keys[i], i);
+    for (auto _ : state)
+    {
+        uint64_t sum = 0;
+        for (const auto & probe : probes)
+        {
+            const uint64_t * value = table.find(probe);
+            sum += value ? *value : 0;
+        }
+        benchmark::DoNotOptimize(sum);
+    }
+    state.SetItemsProcessed(state.iterations() * probes.size());
+}
+
+static void BM_FindFlatBatch(benchmark::State & state)
+{
+    const auto keys = make_keys(state);
+    const auto probes = make_probes(keys);
+    Map table;
+    for (size_t i = 0; i < keys.size(); ++i)
+        table.try_emplace(keys[i], i);
+    std::vector<uint64_t *> found(probes.size());
+    for (auto _ : state)
+    {
+        table.find(probes.data(), probes.size(), found.data());
+        uint64_t sum = 0;
+        for (const uint64_t * value : found)
+            sum += value ? *value : 0;
+        benchmark::DoNotOptimize(sum);
+    }
+    state.SetItemsProcessed(state.iterations() * probes.size());
+}
+
+using StdMap = std::unordered_map<UInt256, uint64_t>;
+using StdXorMap = std::unordered_map<UInt256, uint64_t, XorFoldHash>;
+
+/// The XOR fold degrades to a single bucket on shape 1, so it only runs on small tables there.
+BENCHMARK_TEMPLATE(BM_InsertStd, StdXorMap)->Args({1 << 12, 0})->Args({1 << 20, 0})->Args({1 << 12, 1})->Unit(benchmark::kMicrosecond);
+BENCHMARK_TEMPLATE(BM_InsertStd, StdMap)->ArgsProduct({{1 << 12, 1 << 20}, {0, 1}})->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_InsertFlat)->ArgsProduct({{1 << 12, 1 << 20}, {0, 1}})->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_InsertFlatBatch)->ArgsProduct({{1 << 12, 1 << 20}, {0, 1}})->Unit(benchmark::kMicrosecond);
+BENCHMARK_TEMPLATE(BM_FindStd, StdXorMap)->Args({1 << 12, 0})->Args({1 << 20, 0})->Args({1 << 12, 1})->Unit(benchmark::kMicrosecond);
+BENCHMARK_TEMPLATE(BM_FindStd, StdMap)->ArgsProduct({{1 << 12, 1 << 20}, {0, 1}})->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_FindFlat)->ArgsProduct({{1 << 12, 1 << 20}, {0, 1}})->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_FindFlatBatch)->ArgsProduct({{1 << 12, 1 << 20}, {0, 1}})->Unit(benchmark::kMicrosecond);
+
+BENCHMARK_MAIN();
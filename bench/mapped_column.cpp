@@ -0,0 +1,101 @@
+#include <cstdio>
+#include <random>
+#include <string>
+#include <vector>
+#include <benchmark/benchmark.h>
+#include <wide_integer/mapped_column.h>
+
+using UInt256 = wide::integer<256, unsigned>;
+
+namespace
+{
+
+constexpr size_t count = size_t(1) << 20; /// 32 MiB of values
+
+const std::string & column_path()
+{
+    static const std::string path = []
+    {
+        std::string name = "/tmp/wide_integer_perf_mapped_column.col";
+        std::mt19937_64 rng(44);
+        std::vector<UInt256> values(count);
+        for (auto & v : values)
+            v = (UInt256(rng()) << 64) + UInt256(rng());
+        wide::write_column(name, values.data(), count);
+        return name;
+    }();
+    return path;
+}
+
+uint64_t checksum(const UInt256 * values, size_t n)
+{
+    uint64_t sum = 0;
+    for (size_t i = 0; i < n; ++i)
+        sum += values[i].items[0];
+    return sum;
+}
+
+}
+
+/// Reads the whole file into a vector with stdio, then scans it.
+static void BM_ReadIntoVector(benchmark::State & state)
+{
+    const std::string & path = column_path();
+    for (auto _ : state)
+    {
+        std::FILE * file = std::fopen(path.c_str(), "rb");
+        wide::detail::column_header header;
+        uint8_t head[wide::detail::column_header_size];
+        std::fread(head, 1, sizeof(head), file);
+        wide::detail::decode_column_header(head, header);
+        std::fseek(file, static_cast<long>(header.data_offset), SEEK_SET);
+        std::vector<UInt256> values(header.count);
+        std::fread(values.data(), sizeof(UInt256), values.size(), file);
+        std::fclose(file);
+        benchmark::DoNotOptimize(checksum(values.data(), values.size()));
+    }
+    state.SetBytesProcessed(state.iterations() * count * sizeof(UInt256));
+}
+
+/// Maps the file and scans the values in place.
+static void BM_MapAndScan(benchmark::State & state)
+{
+    const std::string & path = column_path();
+    const auto hint = static_cast<wide::access_hint>(state.range(0));
+    for (auto _ : state)
+    {
+        const wide::mapped_column<256, unsigned> column(path, hint);
+        benchmark::DoNotOptimize(checksum(column.data(), column.size()));
+    }
+    state.SetBytesProcessed(state.iterations() * count * sizeof(UInt256));
+}
+
+/// Opening alone: header validation only, no values are touched.
+static void BM_MapOnly(benchmark::State & state)
+{
+    const std::string & path = column_path();
+    for (auto _ : state)
+    {
+        const wide::mapped_column<256, unsigned> column(path);
+        benchmark::DoNotOptimize(column.data());
+    }
+}
+
+BENCHMARK(BM_ReadIntoVector)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_MapAndScan)
+    ->Arg(static_cast<int>(wide::access_hint::normal))
+    ->Arg(static_cast<int>(wide::access_hint::sequential))
+    ->Arg(static_cast<int>(wide::access_hint::willneed))
+    ->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_MapOnly)->Unit(benchmark::kMicrosecond);
+
+int main(int argc, char ** argv)
+{
+    benchmark::Initialize(&argc, argv);
+    if (benchmark::ReportUnrecognizedArguments(argc, argv))
+        return 1;
+    benchmark::RunSpecifiedBenchmarks();
+    benchmark::Shutdown();
+    std::remove(column_path().c_str());
+    return 0;
+}
@@ -0,0 +1,210 @@
+#include <random>
+#include <benchmark/benchmark.h>
+#include <wide_integer/modular.h>
+
+template <size_t Bits>
+using UInt = wide::integer<Bits, unsigned>;
+
+namespace
+{
+
+template <size_t Bits>
+UInt<Bits> random_value(std::mt19937_64 & rng)
+{
+    UInt<Bits> x;
+    for (auto & item : x.items)
+        item = rng();
+    return x;
+}
+
+/// Odd modulus with the top bit set, so that reductions are never trivial.
+template <size_t Bits>
+UInt<Bits> test_modulus()
+{
+    std::mt19937_64 rng(1);
+    UInt<Bits> m = random_value<Bits>(rng);
+    m |= UInt<Bits>(1) << int(Bits - 1);
+    m |= UInt<Bits>(1);
+    return m;
+}
+
+}
+
+template <size_t Bits>
+static void BM_MulMod(benchmark::State & state)
+{
+    std::mt19937_64 rng(2);
+    const UInt<Bits> m = test_modulus<Bits>();
+    UInt<Bits> a = random_value<Bits>(rng) % m;
+    const UInt<Bits> b = random_value<Bits>(rng) % m;
+    for (auto _ : state)
+    {
+        a = (a * b) % m;
+        benchmark::DoNotOptimize(a);
+    }
+}
+
+template <size_t Bits>
+static void BM_MulModWide(benchmark::State & state)
+{
+    using Wide = UInt<Bits * 2>;
+    std::mt19937_64 rng(2);
+    const UInt<Bits> m = test_modulus<Bits>();
+    UInt<Bits> a = random_value<Bits>(rng) % m;
+    const UInt<Bits> b = random_value<Bits>(rng) % m;
+    for (auto _ : state)
+    {
+        a = UInt<Bits>(Wide(a) * Wide(b) % Wide(m));
+        benchmark::DoNotOptimize(a);
+    }
+}
+
+template <size_t Bits>
+static void BM_MontgomeryMul(benchmark::State & state)
+{
+    std::mt19937_64 rng(2);
+    const wide::montgomery<Bits> ctx(test_modulus<Bits>());
+    UInt<Bits> a = ctx.to_mont(random_value<Bits>(rng));
+    const UInt<Bits> b = ctx.to_mont(random_value<Bits>(rng));
+    for (auto _ : state)
+    {
+        a = ctx.mul(a, b);
+        benchmark::DoNotOptimize(a);
+    }
+}
+
+template <size_t Bits>
+static void BM_MontgomerySqr(benchmark::State & state)
+{
+    std::mt19937_64 rng(2);
+    const wide::montgomery<Bits> ctx(test_modulus<Bits>());
+    UInt<Bits> a = ctx.to_mont(random_value<Bits>(rng));
+    for (auto _ : state)
+    {
+        a = ctx.sqr(a);
+        benchmark::DoNotOptimize(a);
+    }
+}
+
+template <size_t Bits>
+static void BM_BarrettMul(benchmark::State & state)
+{
+    std::mt19937_64 rng(2);
+    /// Even modulus: out of reach for Montgomery form.
+    const UInt<Bits> m = test_modulus<Bits>() - UInt<Bits>(1);
+    const wide::barrett<Bits> ctx(m);
+    UInt<Bits> a = random_value<Bits>(rng) % m;
+    const UInt<Bits> b = random_value<Bits>(rng) % m;
+    for (auto _ : state)
+    {
+        a = ctx.mul(a, b);
+        benchmark::DoNotOptimize(a);
+    }
+}
+
+template <size_t Bits>
+static void BM_ReduceWide(benchmark::State & state)
+{
+    using Wide = UInt<Bits * 2>;
+    std::mt19937_64 rng(2);
+    const UInt<Bits> m = test_modulus<Bits>() - UInt<Bits>(1);
+    const Wide x = wide::mul_wide(random_value<Bits>(rng) % m, random_value<Bits>(rng) % m);
+    for (auto _ : state)
+    {
+        UInt<Bits> r(x % Wide(m));
+        benchmark::DoNotOptimize(r);
+    }
+}
+
+template <size_t Bits>
+static void BM_BarrettReduce(benchmark::State & state)
+{
+    std::mt19937_64 rng(2);
+    const UInt<Bits> m = test_modulus<Bits>() - UInt<Bits>(1);
+    const wide::barrett<Bits> ctx(m);
+    const UInt<Bits * 2> x = wide::mul_wide(random_value<Bits>(rng) % m, random_value<Bits>(rng) % m);
+    for (auto _ : state)
+    {
+        UInt<Bits> r = ctx.reduce(x);
+        benchmark::DoNotOptimize(r);
+    }
+}
+
+/// Square-and-multiply with a full division after every step.
+template <size_t Bits>
+static void BM_PowModNaive(benchmark::State & state)
+{
+    using Wide = UInt<Bits * 2>;
+    std::mt19937_64 rng(3);
+    const UInt<Bits> m = test_modulus<Bits>();
+    const UInt<Bits> base = random_value<Bits>(rng) % m;
+    const UInt<Bits> exp = random_value<Bits>(rng);
+    for (auto _ : state)
+    {
+        UInt<Bits> res = 1;
+        UInt<Bits> cur = base;
+        for (size_t i = 0; i < Bits; ++i)
+        {
+            if (((exp >> int(i)) & 1) != 0)
+                res = UInt<Bits>(Wide(res) * Wide(cur) % Wide(m));
+            cur = UInt<Bits>(Wide(cur) * Wide(cur) % Wide(m));
+        }
+        benchmark::DoNotOptimize(res);
+    }
+}
+
+/// `Odd` selects the Montgomery path, otherwise the modulus is even and Barrett reduction is used.
+template <size_t Bits, bool Odd>
+static void BM_PowMod(benchmark::State & state)
+{
+    std::mt19937_64 rng(3);
+    const UInt<Bits> m = Odd ? test_modulus<Bits>() : test_modulus<Bits>() - UInt<Bits>(1);
+    const UInt<Bits> base = random_value<Bits>(rng) % m;
+    const UInt<Bits> exp = random_value<Bits>(rng);
+    for (auto _ : state)
+    {
+        UInt<Bits> res = wide::powmod(base, exp, m);
+        benchmark::DoNotOptimize(res);
+    }
+}
+
+template <size_t Bits>
+static void BM_PowModConstTime(benchmark::State & state)
+{
+    std::mt19937_64 rng(3);
+    const UInt<Bits> m = test_modulus<Bits>();
+    const UInt<Bits> base = random_value<Bits>(rng) % m;
+    const UInt<Bits> exp = random_value<Bits>(rng);
+    for (auto _ : state)
+    {
+        UInt<Bits> res = wide::powmod_consttime(base, exp, m);
+        benchmark::DoNotOptimize(res);
+    }
+}
+
+BENCHMARK_TEMPLATE(BM_MulMod, 256);
+BENCHMARK_TEMPLATE(BM_MulModWide, 256);
+BENCHMARK_TEMPLATE(BM_MontgomeryMul, 256);
+BENCHMARK_TEMPLATE(BM_MontgomerySqr, 256);
+BENCHMARK_TEMPLATE(BM_BarrettMul, 256);
+BENCHMARK_TEMPLATE(BM_ReduceWide, 256);
+BENCHMARK_TEMPLATE(BM_BarrettReduce, 256);
+BENCHMARK_TEMPLATE(BM_MulModWide, 512);
+BENCHMARK_TEMPLATE(BM_MontgomeryMul, 512);
+BENCHMARK_TEMPLATE(BM_MontgomerySqr, 512);
+BENCHMARK_TEMPLATE(BM_BarrettMul, 512);
+BENCHMARK_TEMPLATE(BM_ReduceWide, 512);
+BENCHMARK_TEMPLATE(BM_BarrettReduce, 512);
+
+BENCHMARK_TEMPLATE(BM_PowModNaive, 256)->Unit(benchmark::kMicrosecond);
+BENCHMARK_TEMPLATE(BM_PowMod, 256, true)->Unit(benchmark::kMicrosecond);
+BENCHMARK_TEMPLATE(BM_PowMod, 256, false)->Unit(benchmark::kMicrosecond);
+BENCHMARK_TEMPLATE(BM_PowModConstTime, 256)->Unit(benchmark::kMicrosecond);
+BENCHMARK_TEMPLATE(BM_PowMod, 512, true)->Unit(benchmark::kMicrosecond);
+BENCHMARK_TEMPLATE(BM_PowMod, 512, false)->Unit(benchmark::kMicrosecond);
+BENCHMARK_TEMPLATE(BM_PowModConstTime, 512)->Unit(benchmark::kMicrosecond);
+BENCHMARK_TEMPLATE(BM_PowMod, 1024, true)->Unit(benchmark::kMicrosecond);
+BENCHMARK_TEMPLATE(BM_PowMod, 1024, false)->Unit(benchmark::kMicrosecond);
+BENCHMARK_TEMPLATE(BM_PowModConstTime, 1024)->Unit(benchmark::kMicrosecond);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,269 @@
+#include <random>
+#include <string>
+#include <vector>
+#include <benchmark/benchmark.h>
+#include <wide_integer/numeric.h>
+
+template <size_t Bits>
+using UInt = wide::integer<Bits, unsigned>;
+
+namespace
+{
+
+template <size_t Bits>
+UInt<Bits> random_value(std::mt19937_64 & rng)
+{
+    UInt<Bits> x;
+    for (auto & item : x.items)
+        item = rng();
+    return x;
+}
+
+/// Values of every magnitude, so that data-dependent loops do not always take the same path.
+template <size_t Bits>
+std::vector<UInt<Bits>> random_values(size_t count)
+{
+    std::mt19937_64 rng(4);
+    std::vector<UInt<Bits>> values(count);
+    for (size_t i = 0; i < count; ++i)
+        values[i] = random_value<Bits>(rng) >> int(i % (Bits - 1));
+    return values;
+}
+
+}
+
+template <size_t Bits>
+static void BM_PowLoop(benchmark::State & state)
+{
+    const unsigned exp = static_cast<unsigned>(state.range(0));
+    for (auto _ : state)
+    {
+        UInt<Bits> res = 1;
+        for (unsigned i = 0; i < exp; ++i)
+            res *= UInt<Bits>(10);
+        benchmark::DoNotOptimize(res);
+    }
+}
+
+template <size_t Bits>
+static void BM_Pow(benchmark::State & state)
+{
+    const unsigned exp = static_cast<unsigned>(state.range(0));
+    for (auto _ : state)
+    {
+        UInt<Bits> res = wide::pow(UInt<Bits>(10), exp);
+        benchmark::DoNotOptimize(res);
+    }
+}
+
+/// Bitwise binary search, one trial square per result bit.
+template <size_t Bits>
+static void BM_IsqrtBisect(benchmark::State & state)
+{
+    const auto values = random_values<Bits>(256);
+    size_t i = 0;
+    for (auto _ : state)
+    {
+        const UInt<Bits> & x = values[i++ % values.size()];
+        UInt<Bits> res = 0;
+        for (int bit = Bits / 2 - 1; bit >= 0; --bit)
+        {
+            const UInt<Bits> candidate = res | (UInt<Bits>(1) << bit);
+            if (candidate * candidate <= x)
+                res = candidate;
+        }
+        benchmark::DoNotOptimize(res);
+    }
+}
+
+template <size_t Bits>
+static void BM_Isqrt(benchmark::State & state)
+{
+    const auto values = random_values<Bits>(256);
+    size_t i = 0;
+    for (auto _ : state)
+    {
+        UInt<Bits> res = wide::isqrt(values[i++ % values.size()]);
+        benchmark::DoNotOptimize(res);
+    }
+}
+
+template <size_t Bits>
+static void BM_Icbrt(benchmark::State & state)
+{
+    const auto values = random_values<Bits>(256);
+    size_t i = 0;
+    for (auto _ : state)
+    {
+        UInt<Bits> res = wide::icbrt(values[i++ % values.size()]);
+        benchmark::DoNotOptimize(res);
+    }
+}
+
+template <size_t Bits>
+static void BM_Ilog2(benchmark::State & state)
+{
+    const auto values = random_values<Bits>(256);
+    size_t i = 0;
+    for (auto _ : state)
+    {
+        unsigned res = wide::ilog2(values[i++ % values.size()] | UInt<Bits>(1));
+        benchmark::DoNotOptimize(res);
+    }
+}
+
+/// Digit count by repeated division by ten.
+template <size_t Bits>
+static void BM_Ilog10Divide(benchmark::State & state)
+{
+    const auto values = random_values<Bits>(256);
+    size_t i = 0;
+    for (auto _ : state)
+    {
+        UInt<Bits> x = values[i++ % values.size()] | UInt<Bits>(1);
+        unsigned res = 0;
+        while (x >= 10)
+        {
+            x /= 10;
+            ++res;
+        }
+        benchmark::DoNotOptimize(res);
+    }
+}
+
+template <size_t Bits>
+static void BM_Ilog10(benchmark::State & state)
+{
+    const auto values = random_values<Bits>(256);
+    size_t i = 0;
+    for (auto _ : state)
+    {
+        unsigned res = wide::ilog10(values[i++ % values.size()] | UInt<Bits>(1));
+        benchmark::DoNotOptimize(res);
+    }
+}
+
+template <size_t Bits>
+static void BM_Digits10ToString(benchmark::State & state)
+{
+    const auto values = random_values<Bits>(256);
+    size_t i = 0;
+    for (auto _ : state)
+    {
+        size_t res = to_string(values[i++ % values.size()]).size();
+        benchmark::DoNotOptimize(res);
+    }
+}
+
+template <size_t Bits>
+static void BM_Digits10(benchmark::State & state)
+{
+    const auto values = random_values<Bits>(256);
+    size_t i = 0;
+    for (auto _ : state)
+    {
+        unsigned res = wide::digits10(values[i++ % values.size()]);
+        benchmark::DoNotOptimize(res);
+    }
+}
+
+template <size_t Bits>
+static void BM_ToString(benchmark::State & state)
+{
+    const auto values = random_values<Bits>(256);
+    size_t i = 0;
+    for (auto _ : state)
+    {
+        std::string res = to_string(values[i++ % values.size()]);
+        benchmark::DoNotOptimize(res);
+    }
+}
+
+template <size_t Bits>
+static void BM_ToChars(benchmark::State & state)
+{
+    const auto values = random_values<Bits>(256);
+    char buffer[Bits / 3 + 2];
+    size_t i = 0;
+    for (auto _ : state)
+    {
+        auto res = wide::to_chars(buffer, buffer + sizeof(buffer), values[i++ % values.size()]);
+        benchmark::DoNotOptimize(res);
+        benchmark::DoNotOptimize(buffer);
+    }
+}
+
+template <size_t Bits>
+static void BM_GcdEuclid(benchmark::State & state)
+{
+    std::mt19937_64 rng(5);
+    const UInt<Bits> a0 = random_value<Bits>(rng);
+    const UInt<Bits> b0 = random_value<Bits>(rng);
+    for (auto _ : state)
+    {
+        UInt<Bits> a = a0;
+        UInt<Bits> b = b0;
+        while (b != 0)
+        {
+            UInt<Bits> t = a % b;
+            a = b;
+            b = t;
+        }
+        benchmark::DoNotOptimize(a);
+    }
+}
+
+template <size_t Bits>
+static void BM_Gcd(benchmark::State & state)
+{
+    std::mt19937_64 rng(5);
+    const UInt<Bits> a = random_value<Bits>(rng);
+    const UInt<Bits> b = random_value<Bits>(rng);
+    for (auto _ : state)
+    {
+        UInt<Bits> res = wide::gcd(a, b);
+        benchmark::DoNotOptimize(res);
+    }
+}
+
+template <size_t Bits>
+static void BM_ModInv(benchmark::State & state)
+{
+    std::mt19937_64 rng(5);
+    const UInt<Bits> m = random_value<Bits>(rng) | UInt<Bits>(1);
+    const UInt<Bits> a = random_value<Bits>(rng) % m;
+    for (auto _ : state)
+    {
+        auto res = wide::modinv(a, m);
+        benchmark::DoNotOptimize(res);
+    }
+}
+
+BENCHMARK_TEMPLATE(BM_PowLoop, 256)->Arg(18)->Arg(76);
+BENCHMARK_TEMPLATE(BM_Pow, 256)->Arg(18)->Arg(76);
+BENCHMARK_TEMPLATE(BM_IsqrtBisect, 256);
+BENCHMARK_TEMPLATE(BM_Isqrt, 256);
+BENCHMARK_TEMPLATE(BM_IsqrtBisect, 512);
+BENCHMARK_TEMPLATE(BM_Isqrt, 512);
+BENCHMARK_TEMPLATE(BM_Icbrt, 256);
+BENCHMARK_TEMPLATE(BM_Icbrt, 512);
+BENCHMARK_TEMPLATE(BM_Ilog2, 256);
+BENCHMARK_TEMPLATE(BM_Ilog2, 512);
+BENCHMARK_TEMPLATE(BM_Ilog10Divide, 256);
+BENCHMARK_TEMPLATE(BM_Ilog10, 256);
+BENCHMARK_TEMPLATE(BM_Ilog10Divide, 512);
+BENCHMARK_TEMPLATE(BM_Ilog10, 512);
+BENCHMARK_TEMPLATE(BM_Digits10ToString, 256);
+BENCHMARK_TEMPLATE(BM_Digits10, 256);
+BENCHMARK_TEMPLATE(BM_ToString, 256);
+BENCHMARK_TEMPLATE(BM_ToChars, 256);
+BENCHMARK_TEMPLATE(BM_ToString, 512);
+BENCHMARK_TEMPLATE(BM_ToChars, 512);
+BENCHMARK_TEMPLATE(BM_GcdEuclid, 256);
+BENCHMARK_TEMPLATE(BM_Gcd, 256);
+BENCHMARK_TEMPLATE(BM_ModInv, 256);
+BENCHMARK_TEMPLATE(BM_GcdEuclid, 512);
+BENCHMARK_TEMPLATE(BM_Gcd, 512);
+BENCHMARK_TEMPLATE(BM_ModInv, 512);
+
+BENCHMARK_MAIN();
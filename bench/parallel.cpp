@@ -0,0 +1,69 @@
+#include <cstdint>
+#include <random>
+#include <string>
+#include <benchmark/benchmark.h>
+#include <wide_integer/parallel.h>
+
+namespace
+{
+
+template <size_t Bits>
+wide::integer<Bits, unsigned> random_value(uint64_t seed)
+{
+    std::mt19937_64 rng(seed);
+    wide::integer<Bits, unsigned> x;
+    for (auto & item : x.items)
+        item = rng();
+    return x;
+}
+
+}
+
+template <size_t Bits>
+static void BM_MulWide(benchmark::State & state)
+{
+    const auto a = random_value<Bits>(1);
+    const auto b = random_value<Bits>(2);
+    for (auto _ : state)
+        benchmark::DoNotOptimize(wide::mul_wide(a, b));
+}
+
+/// The argument is the pool size; 1 is Karatsuba on the calling thread.
+template <size_t Bits>
+static void BM_MulWidePool(benchmark::State & state)
+{
+    const auto a = random_value<Bits>(1);
+    const auto b = random_value<Bits>(2);
+    wide::thread_pool pool(static_cast<size_t>(state.range(0)));
+    for (auto _ : state)
+        benchmark::DoNotOptimize(wide::mul_wide(a, b, pool));
+}
+
+/// to_chars(first, last, x) needs the pow10<Bits> table, which cannot be built at these widths.
+template <size_t Bits>
+static void BM_ToString(benchmark::State & state)
+{
+    const auto x = random_value<Bits>(3);
+    for (auto _ : state)
+        benchmark::DoNotOptimize(wide::to_string(x));
+}
+
+template <size_t Bits>
+static void BM_ToStringPool(benchmark::State & state)
+{
+    const auto x = random_value<Bits>(3);
+    wide::thread_pool pool(static_cast<size_t>(state.range(0)));
+    for (auto _ : state)
+        benchmark::DoNotOptimize(wide::to_string(x, pool));
+}
+
+BENCHMARK_TEMPLATE(BM_MulWide, 8192)->Unit(benchmark::kMicrosecond);
+BENCHMARK_TEMPLATE(BM_MulWidePool, 8192)->Arg(1)->Arg(2)->Arg(4)->UseRealTime()->Unit(benchmark::kMicrosecond);
+BENCHMARK_TEMPLATE(BM_MulWide, 65536)->Unit(benchmark::kMicrosecond);
+BENCHMARK_TEMPLATE(BM_MulWidePool, 65536)->Arg(1)->Arg(2)->Arg(4)->UseRealTime()->Unit(benchmark::kMicrosecond);
+BENCHMARK_TEMPLATE(BM_ToString, 8192)->Unit(benchmark::kMicrosecond);
+BENCHMARK_TEMPLATE(BM_ToStringPool, 8192)->Arg(1)->Arg(2)->Arg(4)->UseRealTime()->Unit(benchmark::kMicrosecond);
+BENCHMARK_TEMPLATE(BM_ToString, 65536)->Unit(benchmark::kMicrosecond);
+BENCHMARK_TEMPLATE(BM_ToStringPool, 65536)->Arg(1)->Arg(2)->Arg(4)->UseRealTime()->Unit(benchmark::kMicrosecond);
+
+BENCHMARK_MAIN();
@@ -1,3 +1,5 @@
+#include <cstdint>
+#include <vector>
 #include <benchmark/benchmark.h>
 
 #ifdef USE_CXX11_HEADER
@@ -53,6 +55,77 @@ static void BM_Division(benchmark::State & state)
     }
 }
 
+template <size_t Bits>
+static void BM_Popcount(benchmark::State & state)
+{
+    WInt<Bits> a = (WInt<Bits>(1) << int(Bits - 1)) + 123456789;
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(wide::popcount(a));
+        benchmark::DoNotOptimize(a);
+    }
+}
+
+template <size_t Bits>
+static void BM_ShiftInPlace(benchmark::State & state)
+{
+    WInt<Bits> a = (WInt<Bits>(1) << int(Bits - 1)) + 123456789;
+    int n = 13;
+    benchmark::DoNotOptimize(n);
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(a <<= n);
+        benchmark::DoNotOptimize(a >>= n);
+    }
+}
+
+template <size_t Bits>
+static void BM_ShiftConstant(benchmark::State & state)
+{
+    WInt<Bits> a = (WInt<Bits>(1) << int(Bits - 1)) + 123456789;
+    for (auto _ : state)
+    {
+        a = wide::shl<13>(a);
+        benchmark::DoNotOptimize(a);
+        a = wide::shr<13>(a);
+        benchmark::DoNotOptimize(a);
+    }
+}
+
+template <size_t Bits>
+static void BM_BitWidth(benchmark::State & state)
+{
+    WInt<Bits> a = WInt<Bits>(123456789) << int(Bits / 2);
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(wide::bit_width(a));
+        benchmark::DoNotOptimize(a);
+    }
+}
+
+template <size_t Bits>
+static void BM_ToDouble(benchmark::State & state)
+{
+    WInt<Bits> a = (WInt<Bits>(0x123456789ABCDEF1ULL) << int(Bits - 80)) + 987654321;
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(a);
+        benchmark::DoNotOptimize(static_cast<double>(a));
+    }
+}
+
+template <size_t Bits>
+static void BM_FromDouble(benchmark::State & state)
+{
+    double d = 1.2345678901234567e70;
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(d);
+        WInt<Bits> a = d;
+        benchmark::DoNotOptimize(a);
+    }
+}
+
 BENCHMARK_TEMPLATE(BM_Addition, 256);
 BENCHMARK_TEMPLATE(BM_Addition, 512);
 BENCHMARK_TEMPLATE(BM_Addition, 1024);
@@ -65,6 +138,18 @@ BENCHMARK_TEMPLATE(BM_Multiplication, 1024);
 BENCHMARK_TEMPLATE(BM_Division, 256);
 BENCHMARK_TEMPLATE(BM_Division, 512);
 BENCHMARK_TEMPLATE(BM_Division, 1024);
+BENCHMARK_TEMPLATE(BM_Popcount, 256);
+BENCHMARK_TEMPLATE(BM_Popcount, 1024);
+BENCHMARK_TEMPLATE(BM_ShiftInPlace, 256);
+BENCHMARK_TEMPLATE(BM_ShiftInPlace, 1024);
+BENCHMARK_TEMPLATE(BM_ShiftConstant, 256);
+BENCHMARK_TEMPLATE(BM_ShiftConstant, 1024);
+BENCHMARK_TEMPLATE(BM_BitWidth, 256);
+BENCHMARK_TEMPLATE(BM_BitWidth, 1024);
+BENCHMARK_TEMPLATE(BM_ToDouble, 256);
+BENCHMARK_TEMPLATE(BM_ToDouble, 1024);
+BENCHMARK_TEMPLATE(BM_FromDouble, 256);
+BENCHMARK_TEMPLATE(BM_FromDouble, 1024);
 
 template <size_t Bits>
 static void BM_ToString(benchmark::State & state)
@@ -82,4 +167,70 @@ BENCHMARK_TEMPLATE(BM_ToString, 256);
 BENCHMARK_TEMPLATE(BM_ToString, 512);
 BENCHMARK_TEMPLATE(BM_ToString, 1024);
 
+/// acc += a[i] * b[i] over a column, with the separate operators or with mul_add.
+template <size_t Bits, bool Fused>
+static void BM_MulAdd(benchmark::State & state)
+{
+    std::vector<WInt<Bits>> a(256);
+    std::vector<WInt<Bits>> b(a.size());
+    uint64_t seed = 49;
+    for (size_t i = 0; i < a.size(); ++i)
+    {
+        seed = seed * 6364136223846793005ULL + 1442695040888963407ULL;
+        a[i] = (WInt<Bits>(seed) << int(Bits / 2)) | WInt<Bits>(i);
+        b[i] = WInt<Bits>(seed >> 7) << int(Bits / 3);
+    }
+
+    for (auto _ : state)
+    {
+        WInt<Bits> acc = 0;
+        for (size_t i = 0; i < a.size(); ++i)
+        {
+            if (Fused)
+                wide::mul_add(acc, a[i], b[i]);
+            else
+                acc = a[i] * b[i] + acc;
+        }
+        benchmark::DoNotOptimize(acc);
+    }
+    state.SetItemsProcessed(state.iterations() * a.size());
+}
+
+BENCHMARK_TEMPLATE(BM_MulAdd, 256, false);
+BENCHMARK_TEMPLATE(BM_MulAdd, 256, true);
+BENCHMARK_TEMPLATE(BM_MulAdd, 1024, false);
+BENCHMARK_TEMPLATE(BM_MulAdd, 1024, true);
+
+/// Sums 256-bit values at random indices of a 32 MiB table that starts `Offset` bytes past a cache
+/// line: with Offset = 16 every second plain value straddles two lines, aligned values never do.
+template <typename T, size_t Offset>
+static void BM_Gather(benchmark::State & state)
+{
+    const size_t count = size_t(1) << 20;
+    std::vector<uint64_t> storage((count * sizeof(T) + 128) / sizeof(uint64_t));
+    const uintptr_t line = (reinterpret_cast<uintptr_t>(storage.data()) + 63) / 64 * 64;
+    T * table = reinterpret_cast<T *>(line + Offset);
+    std::vector<uint32_t> indices(size_t(1) << 18);
+    uint64_t seed = 45;
+    for (size_t i = 0; i < count; ++i)
+        table[i] = WInt<256>(i) << 100 | WInt<256>(i);
+    for (auto & index : indices)
+    {
+        seed = seed * 6364136223846793005ULL + 1442695040888963407ULL;
+        index = static_cast<uint32_t>(seed >> 40) % count;
+    }
+
+    for (auto _ : state)
+    {
+        WInt<256> sum = 0;
+        for (uint32_t index : indices)
+            sum += table[index];
+        benchmark::DoNotOptimize(sum);
+    }
+    state.SetItemsProcessed(state.iterations() * indices.size());
+}
+
+BENCHMARK_TEMPLATE(BM_Gather, WInt<256>, 16);
+BENCHMARK_TEMPLATE(BM_Gather, wide::aligned_integer<256, unsigned>, 0);
+
 BENCHMARK_MAIN();
@@ -0,0 +1,133 @@
+#include <random>
+#include <vector>
+#include <benchmark/benchmark.h>
+#include <wide_integer/varint.h>
+
+using UInt256 = wide::integer<256, unsigned>;
+
+namespace
+{
+
+constexpr size_t count = 4096;
+
+/// Mostly small values with an occasional full-width one.
+std::vector<UInt256> skewed_values()
+{
+    std::mt19937_64 rng(42);
+    std::vector<UInt256> values(count);
+    for (auto & x : values)
+    {
+        if (rng() % 10 == 0)
+            for (auto & item : x.items)
+                item = rng();
+        else
+            x = rng() >> (44 + rng() % 20);
+    }
+    return values;
+}
+
+/// Seven bits at a time with a full-width shift per byte.
+size_t shift_leb128_encode(UInt256 x, uint8_t * out)
+{
+    size_t size = 0;
+    do
+    {
+        uint8_t byte = static_cast<uint8_t>(x) & 0x7F;
+        x >>= 7;
+        if (x != 0)
+            byte |= 0x80;
+        out[size++] = byte;
+    } while (x != 0);
+    return size;
+}
+
+size_t shift_leb128_decode(const uint8_t * in, UInt256 & x)
+{
+    x = 0;
+    size_t size = 0;
+    int shift = 0;
+    while (true)
+    {
+        const uint8_t byte = in[size++];
+        x |= UInt256(byte & 0x7F) << shift;
+        if (!(byte & 0x80))
+            return size;
+        shift += 7;
+    }
+}
+
+}
+
+static void BM_Leb128EncodeShifts(benchmark::State & state)
+{
+    const auto values = skewed_values();
+    std::vector<uint8_t> bytes(count * wide::varint_max_size<256, wide::varint_format::leb128>);
+    size_t size = 0;
+    for (auto _ : state)
+    {
+        size = 0;
+        for (const auto & x : values)
+            size += shift_leb128_encode(x, bytes.data() + size);
+        benchmark::DoNotOptimize(bytes.data());
+        benchmark::ClobberMemory();
+    }
+    state.counters["bytes_per_value"] = double(size) / count;
+    state.SetItemsProcessed(state.iterations() * count);
+}
+
+template <wide::varint_format Format>
+static void BM_VarintEncode(benchmark::State & state)
+{
+    const auto values = skewed_values();
+    std::vector<uint8_t> bytes(count * wide::varint_max_size<256, Format>);
+    size_t size = 0;
+    for (auto _ : state)
+    {
+        size = wide::batch::varint_encode<Format>(values.data(), bytes.data(), count);
+        benchmark::DoNotOptimize(bytes.data());
+        benchmark::ClobberMemory();
+    }
+    state.counters["bytes_per_value"] = double(size) / count;
+    state.SetItemsProcessed(state.iterations() * count);
+}
+
+static void BM_Leb128DecodeShifts(benchmark::State & state)
+{
+    const auto values = skewed_values();
+    std::vector<uint8_t> bytes(count * wide::varint_max_size<256, wide::varint_format::leb128>);
+    wide::batch::varint_encode<wide::varint_format::leb128>(values.data(), bytes.data(), count);
+    std::vector<UInt256> out(count);
+    for (auto _ : state)
+    {
+        size_t pos = 0;
+        for (auto & x : out)
+            pos += shift_leb128_decode(bytes.data() + pos, x);
+        benchmark::DoNotOptimize(out.data());
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * count);
+}
+
+template <wide::varint_format Format>
+static void BM_VarintDecode(benchmark::State & state)
+{
+    const auto values = skewed_values();
+    std::vector<uint8_t> bytes(count * wide::varint_max_size<256, Format>);
+    const size_t size = wide::batch::varint_encode<Format>(values.data(), bytes.data(), count);
+    std::vector<UInt256> out(count);
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(wide::batch::varint_decode<Format>(bytes.data(), bytes.data() + size, out.data(), count));
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * count);
+}
+
+BENCHMARK(BM_Leb128EncodeShifts);
+BENCHMARK_TEMPLATE(BM_VarintEncode, wide::varint_format::leb128);
+BENCHMARK_TEMPLATE(BM_VarintEncode, wide::varint_format::prefix);
+BENCHMARK(BM_Leb128DecodeShifts);
+BENCHMARK_TEMPLATE(BM_VarintDecode, wide::varint_format::leb128);
+BENCHMARK_TEMPLATE(BM_VarintDecode, wide::varint_format::prefix);
+
+BENCHMARK_MAIN();
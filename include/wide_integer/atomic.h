@@ -0,0 +1,333 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <thread>
+#include "wide_integer.h"
+
+/// Atomic wide integers for counters shared between threads. On x86-64 a 128-bit value is updated
+/// with `lock cmpxchg16b` and is lock-free. Wider values, and 128-bit ones elsewhere, are guarded by
+/// a seqlock: writers take turns through the sequence number, while readers never write shared
+/// memory and retry if a writer got in between. All operations are sequentially consistent.
+
+namespace wide
+{
+
+template <typename T>
+class atomic;
+
+namespace detail
+{
+
+#if defined(__x86_64__)
+/// Compares the 16 bytes at `target` with `expected` and replaces them with `desired` if equal;
+/// otherwise loads them into `expected`.
+inline bool cas16(uint64_t * target, uint64_t (&expected)[2], const uint64_t (&desired)[2]) noexcept
+{
+    bool equal;
+    __asm__ __volatile__("lock cmpxchg16b %1"
+                         : "=@ccz"(equal), "+m"(*reinterpret_cast<unsigned __int128 *>(target)), "+a"(expected[0]), "+d"(expected[1])
+                         : "b"(desired[0]), "c"(desired[1])
+                         : "memory");
+    return equal;
+}
+
+/// A 16-byte slot updated only through cas16.
+template <typename T>
+class atomic_cas16
+{
+public:
+    static constexpr bool is_always_lock_free = true;
+
+    constexpr atomic_cas16() noexcept = default;
+    explicit atomic_cas16(const T & value) noexcept { std::memcpy(words, &value, sizeof(words)); }
+
+    T load() const noexcept
+    {
+        /// A compare with an arbitrary value returns the current one; it writes back what it read.
+        uint64_t expected[2] = {0, 0};
+        cas16(words, expected, expected);
+        return to_value(expected);
+    }
+
+    bool compare_exchange(T & expected, const T & desired) noexcept
+    {
+        uint64_t expected_words[2];
+        uint64_t desired_words[2];
+        std::memcpy(expected_words, &expected, sizeof(expected_words));
+        std::memcpy(desired_words, &desired, sizeof(desired_words));
+        const bool equal = cas16(words, expected_words, desired_words);
+        expected = to_value(expected_words);
+        return equal;
+    }
+
+    /// Replaces the value with f(value) and returns the previous one.
+    template <typename F>
+    T update(F && f) noexcept
+    {
+        /// A torn first guess only costs a retry.
+        uint64_t expected[2] = {__atomic_load_n(&words[0], __ATOMIC_RELAXED), __atomic_load_n(&words[1], __ATOMIC_RELAXED)};
+        while (true)
+        {
+            const T desired = f(to_value(expected));
+            uint64_t desired_words[2];
+            std::memcpy(desired_words, &desired, sizeof(desired_words));
+            if (cas16(words, expected, desired_words))
+                return to_value(expected);
+        }
+    }
+
+private:
+    static T to_value(const uint64_t (&value)[2]) noexcept
+    {
+        T result;
+        std::memcpy(&result, value, sizeof(result));
+        return result;
+    }
+
+    /// Mutable because load() is a compare-exchange too; this also keeps a const atomic out of
+    /// read-only storage.
+    alignas(16) mutable uint64_t words[2] = {0, 0};
+};
+#endif
+
+/// A seqlock: the sequence number is odd while a writer holds it. The items are atomics accessed
+/// with relaxed ordering, so that a reader racing with a writer is well-defined and just retries.
+template <typename T>
+class atomic_seqlock
+{
+public:
+    static constexpr bool is_always_lock_free = false;
+    static constexpr size_t count = sizeof(T) / sizeof(uint64_t);
+
+    atomic_seqlock() noexcept : atomic_seqlock(T()) { }
+
+    explicit atomic_seqlock(const T & value) noexcept
+    {
+        const limb_span<const uint64_t> limbs = wide::limbs(value);
+        for (size_t i = 0; i < count; ++i)
+            words[i].store(limbs[i], std::memory_order_relaxed);
+    }
+
+    T load() const noexcept
+    {
+        unsigned spins = 0;
+        while (true)
+        {
+            const uint64_t before = sequence.load(std::memory_order_acquire);
+            if (before & 1)
+            {
+                pause(spins);
+                continue;
+            }
+            const T value = read();
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (sequence.load(std::memory_order_relaxed) == before)
+                return value;
+        }
+    }
+
+    bool compare_exchange(T & expected, const T & desired) noexcept
+    {
+        const uint64_t before = lock();
+        const T current = read();
+        const bool equal = current == expected;
+        if (equal)
+            write(desired);
+        sequence.store(before + 2, std::memory_order_release);
+        expected = current;
+        return equal;
+    }
+
+    template <typename F>
+    T update(F && f) noexcept
+    {
+        const uint64_t before = lock();
+        const T current = read();
+        write(f(current));
+        sequence.store(before + 2, std::memory_order_release);
+        return current;
+    }
+
+private:
+    /// Spins briefly, then yields in case the writer was preempted while holding the sequence.
+    static void pause(unsigned & spins) noexcept
+    {
+        if (++spins > 64)
+        {
+            std::this_thread::yield();
+            return;
+        }
+#if defined(__x86_64__) || defined(__i386__)
+        __builtin_ia32_pause();
+#endif
+    }
+
+    /// Makes the sequence number odd and returns its even value from before.
+    uint64_t lock() noexcept
+    {
+        unsigned spins = 0;
+        uint64_t before = sequence.load(std::memory_order_relaxed);
+        while (true)
+        {
+            if (!(before & 1) && sequence.compare_exchange_weak(before, before + 1, std::memory_order_acquire, std::memory_order_relaxed))
+            {
+                std::atomic_thread_fence(std::memory_order_release);
+                return before;
+            }
+            pause(spins);
+            before = sequence.load(std::memory_order_relaxed);
+        }
+    }
+
+    T read() const noexcept
+    {
+        T value;
+        const limb_span<uint64_t> limbs = wide::limbs(value);
+        for (size_t i = 0; i < count; ++i)
+            limbs[i] = words[i].load(std::memory_order_relaxed);
+        return value;
+    }
+
+    void write(const T & value) noexcept
+    {
+        const limb_span<const uint64_t> limbs = wide::limbs(value);
+        for (size_t i = 0; i < count; ++i)
+            words[i].store(limbs[i], std::memory_order_relaxed);
+    }
+
+    std::atomic<uint64_t> sequence{0};
+    std::atomic<uint64_t> words[count];
+};
+
+#if defined(__x86_64__)
+template <size_t Bits, typename Signed>
+using atomic_storage = std::conditional_t<Bits == 128, atomic_cas16<integer<Bits, Signed>>, atomic_seqlock<integer<Bits, Signed>>>;
+#else
+template <size_t Bits, typename Signed>
+using atomic_storage = atomic_seqlock<integer<Bits, Signed>>;
+#endif
+
+}
+
+/// std::atomic for wide integers. Arithmetic wraps like the non-atomic operators.
+template <size_t Bits, typename Signed>
+class atomic<integer<Bits, Signed>>
+{
+public:
+    using value_type = integer<Bits, Signed>;
+
+    static constexpr bool is_always_lock_free = detail::atomic_storage<Bits, Signed>::is_always_lock_free;
+
+    atomic() noexcept = default;
+    atomic(const value_type & value) noexcept : storage(value) { }
+
+    atomic(const atomic &) = delete;
+    atomic & operator=(const atomic &) = delete;
+
+    bool is_lock_free() const noexcept { return is_always_lock_free; }
+
+    value_type load() const noexcept { return storage.load(); }
+    operator value_type() const noexcept { return load(); }
+
+    void store(const value_type & value) noexcept { exchange(value); }
+
+    value_type operator=(const value_type & value) noexcept
+    {
+        store(value);
+        return value;
+    }
+
+    value_type exchange(const value_type & value) noexcept
+    {
+        return storage.update([&value](const value_type &) { return value; });
+    }
+
+    /// Replaces the value with `desired` if it equals `expected`; otherwise loads it into `expected`.
+    /// Never fails spuriously, so the weak form is the same operation.
+    bool compare_exchange_strong(value_type & expected, const value_type & desired) noexcept
+    {
+        return storage.compare_exchange(expected, desired);
+    }
+
+    bool compare_exchange_weak(value_type & expected, const value_type & desired) noexcept
+    {
+        return storage.compare_exchange(expected, desired);
+    }
+
+    value_type fetch_add(const value_type & delta) noexcept
+    {
+        return storage.update([&delta](const value_type & value) { return value_type(value + delta); });
+    }
+
+    value_type fetch_sub(const value_type & delta) noexcept
+    {
+        return storage.update([&delta](const value_type & value) { return value_type(value - delta); });
+    }
+
+    value_type operator+=(const value_type & delta) noexcept { return fetch_add(delta) + delta; }
+    value_type operator-=(const value_type & delta) noexcept { return fetch_sub(delta) - delta; }
+
+private:
+    detail::atomic_storage<Bits, Signed> storage;
+};
+
+/// A counter for frequent concurrent additions and rare reads. Each thread adds into one of several
+/// shards on separate cache lines, so threads rarely contend, and value() sums the shards. A read
+/// concurrent with additions sees each of them either fully or not at all, but is not a snapshot.
+template <size_t Bits, typename Signed>
+class sharded_counter
+{
+public:
+    using value_type = integer<Bits, Signed>;
+
+    /// The number of shards is rounded up to a power of two; the default is one per hardware thread.
+    explicit sharded_counter(size_t shards = std::thread::hardware_concurrency())
+    {
+        while (mask + 1 < shards)
+            mask = mask * 2 + 1;
+        slots.reset(new shard[mask + 1]);
+    }
+
+    void add(const value_type & delta) noexcept { slots[thread_index() & mask].value.fetch_add(delta); }
+    void sub(const value_type & delta) noexcept { slots[thread_index() & mask].value.fetch_sub(delta); }
+
+    value_type value() const noexcept
+    {
+        value_type sum = 0;
+        for (size_t i = 0; i <= mask; ++i)
+            sum += slots[i].value.load();
+        return sum;
+    }
+
+    /// Not atomic with respect to concurrent additions.
+    void reset() noexcept
+    {
+        for (size_t i = 0; i <= mask; ++i)
+            slots[i].value.store(0);
+    }
+
+    size_t shards() const noexcept { return mask + 1; }
+
+private:
+    struct alignas(64) shard
+    {
+        atomic<value_type> value;
+    };
+
+    /// Threads are numbered in the order of their first addition, which spreads them evenly.
+    static size_t thread_index() noexcept
+    {
+        static std::atomic<size_t> next{0};
+        thread_local const size_t index = next.fetch_add(1, std::memory_order_relaxed);
+        return index;
+    }
+
+    size_t mask = 0;
+    std::unique_ptr<shard[]> slots;
+};
+
+}
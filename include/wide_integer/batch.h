@@ -0,0 +1,265 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+#include "wide_integer.h"
+
+/// Column kernels: element-wise operations over contiguous arrays of wide integers.
+/// Output arrays may alias input arrays element for element.
+
+namespace wide
+{
+namespace batch
+{
+
+template <size_t Bits, typename Signed>
+void add(const integer<Bits, Signed> * lhs, const integer<Bits, Signed> * rhs, integer<Bits, Signed> * res, size_t n) noexcept
+{
+    for (size_t i = 0; i < n; ++i)
+        integer<Bits, Signed>::_impl::add_carry(res[i], lhs[i], rhs[i]);
+}
+
+template <size_t Bits, typename Signed>
+void sub(const integer<Bits, Signed> * lhs, const integer<Bits, Signed> * rhs, integer<Bits, Signed> * res, size_t n) noexcept
+{
+    for (size_t i = 0; i < n; ++i)
+        integer<Bits, Signed>::_impl::sub_borrow(res[i], lhs[i], rhs[i]);
+}
+
+template <size_t Bits, typename Signed>
+void mul(const integer<Bits, Signed> * lhs, const integer<Bits, Signed> * rhs, integer<Bits, Signed> * res, size_t n) noexcept
+{
+    for (size_t i = 0; i < n; ++i)
+        res[i] = lhs[i] * rhs[i];
+}
+
+/// Saturating kernels return the number of elements that were clamped.
+template <size_t Bits, typename Signed>
+size_t add_sat(const integer<Bits, Signed> * lhs, const integer<Bits, Signed> * rhs, integer<Bits, Signed> * res, size_t n) noexcept
+{
+    using Impl = typename integer<Bits, Signed>::_impl;
+    constexpr auto min = std::numeric_limits<integer<Bits, Signed>>::min();
+    constexpr auto max = std::numeric_limits<integer<Bits, Signed>>::max();
+
+    size_t clamped = 0;
+    for (size_t i = 0; i < n; ++i)
+    {
+        const bool lhs_neg = Impl::is_negative(lhs[i]);
+        const bool overflow = add_overflow(lhs[i], rhs[i], &res[i]);
+        if (overflow)
+            res[i] = lhs_neg ? min : max;
+        clamped += overflow;
+    }
+    return clamped;
+}
+
+template <size_t Bits, typename Signed>
+size_t sub_sat(const integer<Bits, Signed> * lhs, const integer<Bits, Signed> * rhs, integer<Bits, Signed> * res, size_t n) noexcept
+{
+    using Impl = typename integer<Bits, Signed>::_impl;
+    constexpr auto min = std::numeric_limits<integer<Bits, Signed>>::min();
+    constexpr auto max = std::numeric_limits<integer<Bits, Signed>>::max();
+
+    size_t clamped = 0;
+    for (size_t i = 0; i < n; ++i)
+    {
+        const bool to_min = !std::is_same_v<Signed, signed> || Impl::is_negative(lhs[i]);
+        const bool overflow = sub_overflow(lhs[i], rhs[i], &res[i]);
+        if (overflow)
+            res[i] = to_min ? min : max;
+        clamped += overflow;
+    }
+    return clamped;
+}
+
+template <size_t Bits, typename Signed>
+size_t mul_sat(const integer<Bits, Signed> * lhs, const integer<Bits, Signed> * rhs, integer<Bits, Signed> * res, size_t n) noexcept
+{
+    using Impl = typename integer<Bits, Signed>::_impl;
+    constexpr auto min = std::numeric_limits<integer<Bits, Signed>>::min();
+    constexpr auto max = std::numeric_limits<integer<Bits, Signed>>::max();
+
+    size_t clamped = 0;
+    for (size_t i = 0; i < n; ++i)
+    {
+        const bool to_min = Impl::is_negative(lhs[i]) != Impl::is_negative(rhs[i]);
+        const bool overflow = mul_overflow(lhs[i], rhs[i], &res[i]);
+        if (overflow)
+            res[i] = to_min ? min : max;
+        clamped += overflow;
+    }
+    return clamped;
+}
+
+/// Conversions round to nearest like `static_cast<double>(x)` and truncate towards zero like
+/// `integer(v)` respectively.
+template <size_t Bits, typename Signed>
+void to_double(const integer<Bits, Signed> * in, double * out, size_t n) noexcept
+{
+    for (size_t i = 0; i < n; ++i)
+        out[i] = static_cast<double>(in[i]);
+}
+
+template <size_t Bits, typename Signed>
+void from_double(const double * in, integer<Bits, Signed> * out, size_t n) noexcept
+{
+    for (size_t i = 0; i < n; ++i)
+        integer<Bits, Signed>::_impl::wide_integer_from_builtin(out[i], in[i]);
+}
+
+/// Serialize n values to n * Bits / 8 bytes, or deserialize them, in little- or big-endian order.
+template <size_t Bits, typename Signed>
+void store_le(const integer<Bits, Signed> * in, uint8_t * out, size_t n) noexcept
+{
+    for (size_t i = 0; i < n; ++i)
+        wide::store_le(in[i], out + i * (Bits / 8));
+}
+
+template <size_t Bits, typename Signed>
+void store_be(const integer<Bits, Signed> * in, uint8_t * out, size_t n) noexcept
+{
+    for (size_t i = 0; i < n; ++i)
+        wide::store_be(in[i], out + i * (Bits / 8));
+}
+
+template <size_t Bits, typename Signed>
+void load_le(const uint8_t * in, integer<Bits, Signed> * out, size_t n) noexcept
+{
+    for (size_t i = 0; i < n; ++i)
+        out[i] = wide::load_le<integer<Bits, Signed>>(in + i * (Bits / 8));
+}
+
+template <size_t Bits, typename Signed>
+void load_be(const uint8_t * in, integer<Bits, Signed> * out, size_t n) noexcept
+{
+    for (size_t i = 0; i < n; ++i)
+        out[i] = wide::load_be<integer<Bits, Signed>>(in + i * (Bits / 8));
+}
+
+namespace detail
+{
+
+/// Integers of any kind seen as an infinite sequence of 64-bit items, sign-extended past their width.
+template <typename T>
+constexpr unsigned conversion_items() noexcept
+{
+    if constexpr (IsWideInteger<T>::value)
+        return T::_impl::item_count;
+    else
+        return (sizeof(T) + sizeof(uint64_t) - 1) / sizeof(uint64_t);
+}
+
+template <typename T>
+constexpr bool conversion_signed() noexcept
+{
+    if constexpr (IsWideInteger<T>::value)
+        return std::numeric_limits<T>::is_signed;
+    else
+        return std::is_signed_v<T> || std::is_same_v<T, __int128>;
+}
+
+template <typename T>
+inline uint64_t conversion_fill(const T & x) noexcept
+{
+    if constexpr (!conversion_signed<T>())
+        return 0;
+    else if constexpr (IsWideInteger<T>::value)
+        return T::_impl::is_negative(x) ? ~uint64_t(0) : 0;
+    else
+        return x < 0 ? ~uint64_t(0) : 0;
+}
+
+template <typename T>
+inline uint64_t conversion_item(const T & x, unsigned i) noexcept
+{
+    if constexpr (IsWideInteger<T>::value)
+        return x.items[T::_impl::little(i)];
+    else if constexpr (conversion_signed<T>())
+        return static_cast<uint64_t>(static_cast<__int128>(x) >> (64 * i));
+    else
+        return static_cast<uint64_t>(static_cast<unsigned __int128>(x) >> (64 * i));
+}
+
+/// Writes the low items of `in` to `out`, truncating or extending with `fill`.
+template <typename To, typename From>
+inline void convert_one(const From & in, To & out, uint64_t fill) noexcept
+{
+    constexpr unsigned from_items = conversion_items<From>();
+    constexpr unsigned to_items = conversion_items<To>();
+
+    if constexpr (IsWideInteger<To>::value)
+    {
+        for (unsigned i = 0; i < to_items; ++i)
+            out.items[To::_impl::little(i)] = i < from_items ? conversion_item(in, i) : fill;
+    }
+    else if constexpr (to_items == 1)
+        out = static_cast<To>(conversion_item(in, 0));
+    else
+    {
+        uint64_t high = fill;
+        if constexpr (from_items > 1)
+            high = conversion_item(in, 1);
+        out = static_cast<To>((static_cast<unsigned __int128>(high) << 64) | conversion_item(in, 0));
+    }
+}
+
+/// True if `out` holds the same value as `in`: every item up to one past the wider type matches.
+template <typename To, typename From>
+inline bool conversion_exact(const From & in, const To & out, uint64_t fill) noexcept
+{
+    constexpr unsigned from_items = conversion_items<From>();
+    constexpr unsigned to_items = conversion_items<To>();
+
+    if constexpr (to_items < from_items || (to_items == from_items && !IsWideInteger<To>::value))
+    {
+        /// Narrowing (or a builtin of less than a full item): the dropped items must repeat the sign.
+        for (unsigned i = 0; i < to_items; ++i)
+            if (conversion_item(out, i) != conversion_item(in, i))
+                return false;
+        const uint64_t out_fill = conversion_fill(out);
+        for (unsigned i = to_items; i < from_items; ++i)
+            if (conversion_item(in, i) != out_fill)
+                return false;
+        return out_fill == fill;
+    }
+    else
+        return conversion_fill(out) == fill;
+}
+
+}
+
+/// Converts between integer types of any width and signedness, wide or built-in, with the
+/// semantics of `static_cast`: values are sign- or zero-extended and truncated to the low bits.
+template <typename To, typename From>
+void convert(const From * in, To * out, size_t n) noexcept
+{
+    static_assert(IntegralConcept<From>() || std::is_same_v<From, __int128> || std::is_same_v<From, unsigned __int128>);
+    static_assert(IntegralConcept<To>() || std::is_same_v<To, __int128> || std::is_same_v<To, unsigned __int128>);
+
+    for (size_t i = 0; i < n; ++i)
+        detail::convert_one(in[i], out[i], detail::conversion_fill(in[i]));
+}
+
+/// Like convert(), but stops at the first element whose value does not fit in `To` and returns its
+/// index; returns n when every element was converted. Elements from that index on are left as is.
+template <typename To, typename From>
+size_t narrow_checked(const From * in, To * out, size_t n) noexcept
+{
+    static_assert(IntegralConcept<From>() || std::is_same_v<From, __int128> || std::is_same_v<From, unsigned __int128>);
+    static_assert(IntegralConcept<To>() || std::is_same_v<To, __int128> || std::is_same_v<To, unsigned __int128>);
+
+    for (size_t i = 0; i < n; ++i)
+    {
+        const uint64_t fill = detail::conversion_fill(in[i]);
+        To value;
+        detail::convert_one(in[i], value, fill);
+        if (!detail::conversion_exact(in[i], value, fill))
+            return i;
+        out[i] = value;
+    }
+    return n;
+}
+
+}
+}
@@ -0,0 +1,392 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <type_traits>
+#if defined(__BMI2__)
+#    include <immintrin.h>
+#endif
+#include "wide_integer.h"
+
+/// Bit scatter/gather on unsigned wide integers.
+///
+/// pdep(x, mask)                       - deposit the low bits of x at the set bits of mask, like BMI2 PDEP.
+/// pext(x, mask)                       - gather the bits of x at the set bits of mask into the low bits, like PEXT.
+/// morton_encode<Dims, Bits>(coords)   - interleave Dims (2 to 8) 64-bit coordinates into a Z-order key;
+///                                       each coordinate keeps its low min(64, Bits / Dims) bits.
+/// morton_decode<Dims>(key)            - the inverse of morton_encode.
+/// extract_bits<Width>(x, offset)      - bits [offset, offset + Width) of x, as uint64_t for Width <= 64
+///                                       and as integer<Width, unsigned> above.
+/// insert_bits<Width>(x, offset, v)    - overwrite the same bits of x in place with a value of that type.
+/// funnel_shift(hi, lo, n)             - the Bits-wide window starting at bit n of the concatenation hi:lo.
+///
+/// The window functions read or write only the items that overlap the window, where `(x >> n) & mask`
+/// shifts every item of x. Bits past the top read as zero and writes past the top are dropped.
+///
+/// Items go through the PDEP/PEXT instructions when compiled with BMI2 (e.g. -mbmi2 or -march=native).
+/// Otherwise pdep/pext use 4-bit lookup tables and the Morton functions use shift-and-mask spreading.
+
+namespace wide
+{
+
+namespace detail
+{
+
+/// Deposit / extract on a 4-bit group, indexed by [mask][value].
+struct nibble_tables
+{
+    uint8_t deposit[16][16];
+    uint8_t extract[16][16];
+    uint8_t count[16];
+};
+
+constexpr nibble_tables make_nibble_tables() noexcept
+{
+    nibble_tables tables{};
+    for (unsigned mask = 0; mask < 16; ++mask)
+    {
+        for (unsigned value = 0; value < 16; ++value)
+        {
+            unsigned deposited = 0;
+            unsigned extracted = 0;
+            unsigned k = 0;
+            for (unsigned bit = 0; bit < 4; ++bit)
+            {
+                if (!(mask & (1u << bit)))
+                    continue;
+                deposited |= ((value >> k) & 1u) << bit;
+                extracted |= ((value >> bit) & 1u) << k;
+                ++k;
+            }
+            tables.deposit[mask][value] = static_cast<uint8_t>(deposited);
+            tables.extract[mask][value] = static_cast<uint8_t>(extracted);
+            tables.count[mask] = static_cast<uint8_t>(k);
+        }
+    }
+    return tables;
+}
+
+inline constexpr nibble_tables nibble = make_nibble_tables();
+
+inline uint64_t pdep64(uint64_t x, uint64_t mask) noexcept
+{
+#if defined(__BMI2__)
+    return _pdep_u64(x, mask);
+#else
+    uint64_t res = 0;
+    for (unsigned shift = 0; mask; shift += 4, mask >>= 4)
+    {
+        const unsigned group = mask & 15;
+        res |= static_cast<uint64_t>(nibble.deposit[group][x & 15]) << shift;
+        x >>= nibble.count[group];
+    }
+    return res;
+#endif
+}
+
+inline uint64_t pext64(uint64_t x, uint64_t mask) noexcept
+{
+#if defined(__BMI2__)
+    return _pext_u64(x, mask);
+#else
+    uint64_t res = 0;
+    for (unsigned pos = 0; mask; x >>= 4, mask >>= 4)
+    {
+        const unsigned group = mask & 15;
+        res |= static_cast<uint64_t>(nibble.extract[group][x & 15]) << pos;
+        pos += nibble.count[group];
+    }
+    return res;
+#endif
+}
+
+/// The 64 bits of x starting at bit `offset`, zero-filled past the top.
+template <size_t Bits>
+constexpr uint64_t read_bits64(const integer<Bits, unsigned> & x, unsigned offset) noexcept
+{
+    using Impl = typename integer<Bits, unsigned>::_impl;
+    const unsigned index = offset / 64;
+    const unsigned shift = offset % 64;
+    if (index >= Impl::item_count)
+        return 0;
+    uint64_t res = x.items[Impl::little(index)] >> shift;
+    if (shift && index + 1 < Impl::item_count)
+        res |= x.items[Impl::little(index + 1)] << (64 - shift);
+    return res;
+}
+
+/// x |= bits << offset for `bits` narrower than 64 - (offset % 64) + 64, dropping what is past the top.
+template <size_t Bits>
+constexpr void or_bits64(integer<Bits, unsigned> & x, unsigned offset, uint64_t bits) noexcept
+{
+    using Impl = typename integer<Bits, unsigned>::_impl;
+    const unsigned index = offset / 64;
+    const unsigned shift = offset % 64;
+    if (index >= Impl::item_count)
+        return;
+    x.items[Impl::little(index)] |= bits << shift;
+    if (shift && index + 1 < Impl::item_count)
+        x.items[Impl::little(index + 1)] |= bits >> (64 - shift);
+}
+
+/// The value type of a Width-bit field: uint64_t up to 64 bits, integer<Width, unsigned> above.
+template <unsigned Width>
+using bit_field_t = std::conditional_t<(Width <= 64), uint64_t, integer<Width, unsigned>>;
+
+/// Overwrites bits [offset, offset + width) of x with the low `width` bits of `bits`, width <= 64.
+template <size_t Bits>
+constexpr void write_bits64(integer<Bits, unsigned> & x, unsigned offset, unsigned width, uint64_t bits) noexcept
+{
+    using Impl = typename integer<Bits, unsigned>::_impl;
+    const unsigned index = offset / 64;
+    const unsigned shift = offset % 64;
+    if (index >= Impl::item_count)
+        return;
+    const uint64_t mask = width == 64 ? ~uint64_t(0) : (uint64_t(1) << width) - 1;
+    bits &= mask;
+    auto & low = x.items[Impl::little(index)];
+    low = (low & ~(mask << shift)) | (bits << shift);
+    if (shift && shift + width > 64 && index + 1 < Impl::item_count)
+    {
+        auto & high = x.items[Impl::little(index + 1)];
+        high = (high & ~(mask >> (64 - shift))) | (bits >> (64 - shift));
+    }
+}
+
+/// Per key item and dimension: the key bits owned by the dimension, and the index of the first
+/// coordinate bit that lands in the item.
+template <unsigned Dims, size_t Bits>
+struct morton_layout
+{
+    static_assert(Dims >= 2 && Dims <= 8, "Morton codes are provided for 2 to 8 dimensions");
+
+    static constexpr unsigned items = Bits / 64;
+    static constexpr unsigned coordinate_bits = Bits / Dims < 64 ? Bits / Dims : 64;
+
+    /// Without BMI2 a coordinate is spread `group` bits at a time, the largest power of two with
+    /// group * Dims <= 64, by log2(group) shift-and-mask steps.
+    static constexpr unsigned group = Dims == 2 ? 32 : (Dims <= 4 ? 16 : 8);
+    static constexpr unsigned steps = Dims == 2 ? 5 : (Dims <= 4 ? 4 : 3);
+
+    std::array<std::array<uint64_t, Dims>, items> masks{};
+    std::array<std::array<unsigned, Dims>, items> first{};
+
+    /// spread_masks[l]: runs of 2^l bits starting at every multiple of 2^l * Dims, group bits in total.
+    std::array<uint64_t, steps + 1> spread_masks{};
+
+    static constexpr morton_layout make() noexcept
+    {
+        morton_layout layout{};
+        for (unsigned i = 0; i < items; ++i)
+        {
+            for (unsigned d = 0; d < Dims; ++d)
+            {
+                layout.first[i][d] = (64 * i + Dims - 1 - d) / Dims;
+                for (unsigned bit = 0; bit < 64; ++bit)
+                {
+                    const unsigned pos = 64 * i + bit;
+                    if (pos % Dims == d && pos / Dims < coordinate_bits)
+                        layout.masks[i][d] |= uint64_t(1) << bit;
+                }
+            }
+        }
+        for (unsigned l = 0; l <= steps; ++l)
+        {
+            const unsigned run = 1u << l;
+            for (unsigned start = 0; start < group; start += run)
+                for (unsigned bit = 0; bit < run; ++bit)
+                    layout.spread_masks[l] |= uint64_t(1) << (start * Dims + bit);
+        }
+        return layout;
+    }
+
+    /// Moves bit k of the low `group` bits of x to bit k * Dims.
+    constexpr uint64_t spread(uint64_t x) const noexcept
+    {
+        x &= spread_masks[steps];
+        for (unsigned l = steps; l-- > 0;)
+            x = (x | (x << ((1u << l) * (Dims - 1)))) & spread_masks[l];
+        return x;
+    }
+
+    /// Inverse of spread: bit k * Dims of x to bit k.
+    constexpr uint64_t compact(uint64_t x) const noexcept
+    {
+        x &= spread_masks[0];
+        for (unsigned l = 0; l < steps; ++l)
+            x = (x | (x >> ((1u << l) * (Dims - 1)))) & spread_masks[l + 1];
+        return x;
+    }
+};
+
+template <unsigned Dims, size_t Bits>
+inline constexpr morton_layout<Dims, Bits> morton_layout_v = morton_layout<Dims, Bits>::make();
+
+}
+
+/// Scatters the low popcount(mask) bits of `x` to the positions of the set bits of `mask`, item by item.
+template <size_t Bits>
+integer<Bits, unsigned> pdep(const integer<Bits, unsigned> & x, const integer<Bits, unsigned> & mask) noexcept
+{
+    using Impl = typename integer<Bits, unsigned>::_impl;
+    integer<Bits, unsigned> res{};
+    unsigned offset = 0;
+    for (unsigned i = 0; i < Impl::item_count && offset < Bits; ++i)
+    {
+        const uint64_t item_mask = mask.items[Impl::little(i)];
+        if (!item_mask)
+            continue;
+        res.items[Impl::little(i)] = detail::pdep64(detail::read_bits64(x, offset), item_mask);
+        offset += __builtin_popcountll(item_mask);
+    }
+    return res;
+}
+
+/// Gathers the bits of `x` at the set bits of `mask` into the low popcount(mask) bits of the result.
+template <size_t Bits>
+integer<Bits, unsigned> pext(const integer<Bits, unsigned> & x, const integer<Bits, unsigned> & mask) noexcept
+{
+    using Impl = typename integer<Bits, unsigned>::_impl;
+    integer<Bits, unsigned> res{};
+    unsigned offset = 0;
+    for (unsigned i = 0; i < Impl::item_count; ++i)
+    {
+        const uint64_t item_mask = mask.items[Impl::little(i)];
+        if (!item_mask)
+            continue;
+        detail::or_bits64(res, offset, detail::pext64(x.items[Impl::little(i)], item_mask));
+        offset += __builtin_popcountll(item_mask);
+    }
+    return res;
+}
+
+/// Bits [offset, offset + Width) of x, reading the one or two items that hold them.
+template <unsigned Width, size_t Bits>
+constexpr detail::bit_field_t<Width> extract_bits(const integer<Bits, unsigned> & x, unsigned offset) noexcept
+{
+    static_assert(Width > 0 && (Width <= 64 || Width % 64 == 0), "Width must be at most 64 or a multiple of 64");
+    if constexpr (Width <= 64)
+    {
+        const uint64_t bits = detail::read_bits64(x, offset);
+        if constexpr (Width == 64)
+            return bits;
+        else
+            return bits & ((uint64_t(1) << Width) - 1);
+    }
+    else
+    {
+        using Impl = typename integer<Width, unsigned>::_impl;
+        integer<Width, unsigned> res{};
+        for (unsigned i = 0; i < Impl::item_count; ++i)
+            res.items[Impl::little(i)] = detail::read_bits64(x, offset + 64 * i);
+        return res;
+    }
+}
+
+/// Overwrites bits [offset, offset + Width) of x with `value`, leaving the other bits alone.
+template <unsigned Width, size_t Bits>
+constexpr void insert_bits(integer<Bits, unsigned> & x, unsigned offset, const detail::bit_field_t<Width> & value) noexcept
+{
+    static_assert(Width > 0 && (Width <= 64 || Width % 64 == 0), "Width must be at most 64 or a multiple of 64");
+    if constexpr (Width <= 64)
+        detail::write_bits64(x, offset, Width, value);
+    else
+    {
+        using Impl = typename integer<Width, unsigned>::_impl;
+        for (unsigned i = 0; i < Impl::item_count; ++i)
+            detail::write_bits64(x, offset + 64 * i, 64, value.items[Impl::little(i)]);
+    }
+}
+
+/// Bits [n, n + Bits) of the 2 * Bits wide concatenation hi:lo, so funnel_shift(hi, lo, 0) == lo and
+/// funnel_shift(hi, lo, Bits) == hi. Each result item is a funnel shift of two source items.
+template <size_t Bits>
+constexpr integer<Bits, unsigned> funnel_shift(const integer<Bits, unsigned> & hi, const integer<Bits, unsigned> & lo, unsigned n) noexcept
+{
+    using Impl = typename integer<Bits, unsigned>::_impl;
+    constexpr unsigned count = Impl::item_count;
+    const unsigned items_shift = n / 64;
+    const unsigned bit_shift = n % 64;
+
+    auto item = [&](unsigned k) -> uint64_t
+    {
+        if (k < count)
+            return lo.items[Impl::little(k)];
+        if (k < 2 * count)
+            return hi.items[Impl::little(k - count)];
+        return 0;
+    };
+
+    integer<Bits, unsigned> res{};
+    for (unsigned i = 0; i < count; ++i)
+    {
+        const uint64_t low = item(i + items_shift);
+        res.items[Impl::little(i)] = bit_shift ? Impl::funnel_right(item(i + items_shift + 1), low, bit_shift) : low;
+    }
+    return res;
+}
+
+/// Z-order key of `coords`: bit j of coordinate d becomes bit j * Dims + d of the key.
+template <unsigned Dims, size_t Bits = 64 * Dims>
+integer<Bits, unsigned> morton_encode(const std::array<uint64_t, Dims> & coords) noexcept
+{
+    constexpr const auto & layout = detail::morton_layout_v<Dims, Bits>;
+
+    integer<Bits, unsigned> key{};
+#if defined(__BMI2__)
+    using Impl = typename integer<Bits, unsigned>::_impl;
+    for (unsigned i = 0; i < Impl::item_count; ++i)
+    {
+        uint64_t item = 0;
+        for (unsigned d = 0; d < Dims; ++d)
+        {
+            if (layout.masks[i][d])
+                item |= detail::pdep64(coords[d] >> layout.first[i][d], layout.masks[i][d]);
+        }
+        key.items[Impl::little(i)] = item;
+    }
+#else
+    using Layout = detail::morton_layout<Dims, Bits>;
+    for (unsigned j = 0; j < Layout::coordinate_bits; j += Layout::group)
+    {
+        const unsigned width = Layout::coordinate_bits - j < Layout::group ? Layout::coordinate_bits - j : Layout::group;
+        const uint64_t low = (uint64_t(1) << width) - 1;
+        for (unsigned d = 0; d < Dims; ++d)
+            detail::or_bits64(key, j * Dims, layout.spread((coords[d] >> j) & low) << d);
+    }
+#endif
+    return key;
+}
+
+template <unsigned Dims, size_t Bits>
+std::array<uint64_t, Dims> morton_decode(const integer<Bits, unsigned> & key) noexcept
+{
+    constexpr const auto & layout = detail::morton_layout_v<Dims, Bits>;
+
+    std::array<uint64_t, Dims> coords{};
+#if defined(__BMI2__)
+    using Impl = typename integer<Bits, unsigned>::_impl;
+    for (unsigned i = 0; i < Impl::item_count; ++i)
+    {
+        const uint64_t item = key.items[Impl::little(i)];
+        for (unsigned d = 0; d < Dims; ++d)
+        {
+            if (layout.masks[i][d])
+                coords[d] |= detail::pext64(item, layout.masks[i][d]) << layout.first[i][d];
+        }
+    }
+#else
+    using Layout = detail::morton_layout<Dims, Bits>;
+    for (unsigned j = 0; j < Layout::coordinate_bits; j += Layout::group)
+    {
+        const unsigned width = Layout::coordinate_bits - j < Layout::group ? Layout::coordinate_bits - j : Layout::group;
+        const uint64_t low = (uint64_t(1) << width) - 1;
+        const uint64_t chunk = detail::read_bits64(key, j * Dims);
+        for (unsigned d = 0; d < Dims; ++d)
+            coords[d] |= (layout.compact(chunk >> d) & low) << j;
+    }
+#endif
+    return coords;
+}
+
+}
@@ -0,0 +1,377 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include "varint.h"
+
+/// Lightweight compression for columns of wide integers that cluster around a base value.
+///
+/// A block starts with the scheme, the item count of the integer type and the number of values, and
+/// is followed by the scheme's payload:
+///  - frame_of_reference: the minimum, then every value minus the minimum in the bit width of the
+///    largest difference, packed into little-endian 64-bit words;
+///  - delta: the first value, then the differences of neighbours as a frame-of-reference section;
+///  - delta_of_delta: the first value and difference, then the second differences likewise;
+///  - trim_limbs: one byte per value with its count of significant items, then those items. Signed
+///    values are zigzag mapped first.
+/// Differences wrap around like the integer arithmetic, so every scheme is lossless for any input.
+///
+/// Decoding writes straight into the destination. For the common frame-of-reference section of at
+/// most 64 bits per value whose offsets cannot carry out of the low item of the reference, each value
+/// is a copy of the reference with one field added, read without branches. The field extraction stays
+/// scalar: the bit offsets vary per value, and SSE2 has no per-lane variable shifts or gathers.
+
+namespace wide
+{
+namespace codec
+{
+
+enum class scheme : uint8_t
+{
+    frame_of_reference,
+    delta,
+    delta_of_delta,
+    trim_limbs,
+};
+
+inline constexpr size_t header_size = 10;
+
+/// Upper bound of the encoded size of n values.
+template <size_t Bits>
+constexpr size_t max_encoded_size(size_t n) noexcept
+{
+    return header_size + 2 + 3 * (Bits / 8) + n * (Bits / 8 + 1);
+}
+
+namespace detail
+{
+
+using wide::detail::load_le64;
+using wide::detail::store_le64;
+
+/// Appends fields of up to 64 bits, least significant bit first.
+class bit_writer
+{
+public:
+    explicit bit_writer(uint8_t * out) noexcept : out(out) { }
+
+    void put(uint64_t bits, unsigned width) noexcept
+    {
+        acc |= bits << used;
+        if (used + width >= 64)
+        {
+            store_le64(out, acc);
+            out += 8;
+            acc = used ? bits >> (64 - used) : 0;
+            used = used + width - 64;
+        }
+        else
+            used += width;
+    }
+
+    /// Flushes the last partial word and returns the end of the output.
+    uint8_t * finish() noexcept
+    {
+        if (used)
+            store_le64(out, acc);
+        return used ? out + 8 : out;
+    }
+
+private:
+    uint8_t * out;
+    uint64_t acc = 0;
+    unsigned used = 0;
+};
+
+/// The `width` bits at bit position `pos` of the packed words, for 0 < width <= 64.
+inline uint64_t read_field(const uint8_t * words, size_t pos, unsigned width) noexcept
+{
+    const size_t index = pos / 64;
+    const unsigned shift = pos % 64;
+    uint64_t bits = load_le64(words + index * 8) >> shift;
+    if (shift + width > 64)
+        bits |= load_le64(words + index * 8 + 8) << (64 - shift);
+    return width == 64 ? bits : bits & ((uint64_t(1) << width) - 1);
+}
+
+template <typename Integer>
+Integer load_value(const uint8_t * in) noexcept
+{
+    return load_le<Integer>(in);
+}
+
+/// Frame-of-reference section for the n values get(0), ..., get(n - 1).
+template <size_t Bits, typename Signed, typename Get>
+uint8_t * encode_for(size_t n, Get get, uint8_t * out) noexcept
+{
+    using Int = integer<Bits, Signed>;
+    using UInt = integer<Bits, unsigned>;
+    using Impl = typename UInt::_impl;
+
+    Int lo = n ? get(0) : Int(0);
+    Int hi = lo;
+    for (size_t i = 1; i < n; ++i)
+    {
+        const Int x = get(i);
+        if (x < lo)
+            lo = x;
+        if (hi < x)
+            hi = x;
+    }
+    const unsigned width = static_cast<unsigned>(bit_width(UInt(hi) - UInt(lo)));
+
+    out[0] = static_cast<uint8_t>(width);
+    out[1] = static_cast<uint8_t>(width >> 8);
+    store_le(lo, out + 2);
+    bit_writer writer(out + 2 + Bits / 8);
+    if (width)
+    {
+        for (size_t i = 0; i < n; ++i)
+        {
+            const UInt d = UInt(get(i)) - UInt(lo);
+            for (unsigned j = 0; j * 64 < width; ++j)
+                writer.put(d.items[Impl::little(j)], width - j * 64 < 64 ? width - j * 64 : 64);
+        }
+    }
+    return writer.finish();
+}
+
+/// Decodes a frame-of-reference section into out[0, n) and returns its end, or nullptr if it does
+/// not fit in [in, end).
+template <size_t Bits, typename Signed>
+const uint8_t * decode_for(const uint8_t * in, const uint8_t * end, size_t n, integer<Bits, Signed> * out) noexcept
+{
+    using Int = integer<Bits, Signed>;
+    using UInt = integer<Bits, unsigned>;
+    using Impl = typename UInt::_impl;
+
+    if (static_cast<size_t>(end - in) < 2 + Bits / 8)
+        return nullptr;
+    const unsigned width = in[0] | unsigned(in[1]) << 8;
+    if (width > Bits)
+        return nullptr;
+    const UInt lo = load_value<UInt>(in + 2);
+    const uint8_t * words = in + 2 + Bits / 8;
+    if (width && n > static_cast<size_t>(end - words) * 8 / width)
+        return nullptr;
+    const size_t size = (n * width + 63) / 64 * 8;
+    if (static_cast<size_t>(end - words) < size)
+        return nullptr;
+
+    if (width == 0)
+    {
+        for (size_t i = 0; i < n; ++i)
+            out[i] = Int(lo);
+    }
+    else if (width <= 64)
+    {
+        /// If no field can carry out of the low item of the reference, which is the usual case for
+        /// values that cluster around it, every value is the reference with its low item replaced.
+        /// The fields that start before the last word are read without branches.
+        const Int reference(lo);
+        const uint64_t lo_low = lo.items[Impl::little(0)];
+        const uint64_t mask = width == 64 ? ~uint64_t(0) : (uint64_t(1) << width) - 1;
+        const bool carries = lo_low > ~uint64_t(0) - mask;
+        const size_t unpackable = carries || size < 16 ? 0 : std::min(n, ((size - 8) * 8 + width - 1) / width);
+        for (size_t i = 0; i < unpackable; ++i)
+        {
+            const size_t pos = i * width;
+            const uint8_t * word = words + pos / 64 * 8;
+            const unsigned shift = pos % 64;
+            /// Shifting by 1 and then by 63 - shift gives 0 instead of undefined behaviour at shift 0.
+            const uint64_t field = ((load_le64(word) >> shift) | (load_le64(word + 8) << 1 << (63 - shift))) & mask;
+            out[i] = reference;
+            out[i].items[Impl::little(0)] = lo_low + field;
+        }
+        for (size_t i = unpackable; i < n; ++i)
+        {
+            UInt x;
+            Impl::add_carry(x, lo, UInt(read_field(words, i * width, width)));
+            out[i] = Int(x);
+        }
+    }
+    else
+    {
+        for (size_t i = 0; i < n; ++i)
+        {
+            UInt d{};
+            for (unsigned j = 0; j * 64 < width; ++j)
+                d.items[Impl::little(j)] = read_field(words, i * width + j * 64, width - j * 64 < 64 ? width - j * 64 : 64);
+            UInt x;
+            Impl::add_carry(x, lo, d);
+            out[i] = Int(x);
+        }
+    }
+    return words + size;
+}
+
+template <size_t Bits, typename Signed>
+integer<Bits, unsigned> to_unsigned(const integer<Bits, Signed> & x) noexcept
+{
+    if constexpr (std::is_same_v<Signed, signed>)
+        return zigzag_encode(x);
+    else
+        return x;
+}
+
+template <size_t Bits, typename Signed>
+integer<Bits, Signed> from_unsigned(const integer<Bits, unsigned> & x) noexcept
+{
+    if constexpr (std::is_same_v<Signed, signed>)
+        return zigzag_decode(x);
+    else
+        return x;
+}
+
+}
+
+/// Encodes in[0, n) into `out`, which needs max_encoded_size<Bits>(n) bytes, and returns the size.
+template <size_t Bits, typename Signed>
+size_t encode(const integer<Bits, Signed> * in, size_t n, uint8_t * out, scheme s) noexcept
+{
+    using Int = integer<Bits, Signed>;
+    using Impl = typename Int::_impl;
+    static_assert(Impl::item_count < 256);
+
+    out[0] = static_cast<uint8_t>(s);
+    out[1] = static_cast<uint8_t>(Impl::item_count);
+    detail::store_le64(out + 2, n);
+    uint8_t * pos = out + header_size;
+
+    switch (s)
+    {
+        case scheme::frame_of_reference:
+            pos = detail::encode_for<Bits, Signed>(n, [in](size_t i) { return in[i]; }, pos);
+            break;
+        case scheme::delta:
+            if (n == 0)
+                break;
+            store_le(in[0], pos);
+            pos = detail::encode_for<Bits, Signed>(n - 1, [in](size_t i) { return in[i + 1] - in[i]; }, pos + Bits / 8);
+            break;
+        case scheme::delta_of_delta:
+            if (n == 0)
+                break;
+            store_le(in[0], pos);
+            pos += Bits / 8;
+            if (n == 1)
+                break;
+            store_le(Int(in[1] - in[0]), pos);
+            pos = detail::encode_for<Bits, Signed>(
+                n - 2, [in](size_t i) { return Int(in[i + 2] - in[i + 1]) - Int(in[i + 1] - in[i]); }, pos + Bits / 8);
+            break;
+        case scheme::trim_limbs: {
+            uint8_t * items = pos + n;
+            for (size_t i = 0; i < n; ++i)
+            {
+                const auto u = detail::to_unsigned(in[i]);
+                unsigned count = Impl::item_count;
+                while (count > 0 && u.items[Impl::little(count - 1)] == 0)
+                    --count;
+                pos[i] = static_cast<uint8_t>(count);
+                for (unsigned j = 0; j < count; ++j, items += 8)
+                    detail::store_le64(items, u.items[Impl::little(j)]);
+            }
+            pos = items;
+            break;
+        }
+    }
+    return static_cast<size_t>(pos - out);
+}
+
+/// The number of values in the block at `in`, or 0 if there is no complete header.
+inline size_t decoded_count(const uint8_t * in, const uint8_t * end) noexcept
+{
+    return static_cast<size_t>(end - in) < header_size ? 0 : static_cast<size_t>(detail::load_le64(in + 2));
+}
+
+/// Decodes the block at [in, end) into `out`, which needs room for decoded_count() values, and returns
+/// the number of bytes consumed, or 0 if the block is malformed or was written for another width.
+template <size_t Bits, typename Signed>
+size_t decode(const uint8_t * in, const uint8_t * end, integer<Bits, Signed> * out) noexcept
+{
+    using Int = integer<Bits, Signed>;
+    using UInt = integer<Bits, unsigned>;
+    using Impl = typename Int::_impl;
+
+    if (static_cast<size_t>(end - in) < header_size || in[1] != Impl::item_count)
+        return 0;
+    const size_t n = static_cast<size_t>(detail::load_le64(in + 2));
+    const uint8_t * pos = in + header_size;
+    const size_t left = static_cast<size_t>(end - pos);
+
+    switch (static_cast<scheme>(in[0]))
+    {
+        case scheme::frame_of_reference:
+            pos = detail::decode_for(pos, end, n, out);
+            break;
+        case scheme::delta:
+            if (n == 0)
+                break;
+            if (left < Bits / 8)
+                return 0;
+            out[0] = detail::load_value<Int>(pos);
+            pos = detail::decode_for(pos + Bits / 8, end, n - 1, out + 1);
+            if (!pos)
+                return 0;
+            for (size_t i = 1; i < n; ++i)
+                out[i] += out[i - 1];
+            break;
+        case scheme::delta_of_delta: {
+            if (n == 0)
+                break;
+            if (left < (n == 1 ? 1 : 2) * (Bits / 8))
+                return 0;
+            out[0] = detail::load_value<Int>(pos);
+            pos += Bits / 8;
+            if (n == 1)
+                break;
+            out[1] = detail::load_value<Int>(pos);
+            pos = detail::decode_for(pos + Bits / 8, end, n - 2, out + 2);
+            if (!pos)
+                return 0;
+            /// out[1] holds the first difference and out[i] the second differences: sum twice.
+            Int delta = out[1];
+            out[1] += out[0];
+            for (size_t i = 2; i < n; ++i)
+            {
+                delta += out[i];
+                out[i] = out[i - 1] + delta;
+            }
+            break;
+        }
+        case scheme::trim_limbs: {
+            if (left < n)
+                return 0;
+            const uint8_t * counts = pos;
+            pos += n;
+            /// Validate all counts first so that the copy loop has no exits.
+            size_t total = 0;
+            unsigned largest = 0;
+            for (size_t i = 0; i < n; ++i)
+            {
+                total += counts[i];
+                largest = counts[i] > largest ? counts[i] : largest;
+            }
+            if (largest > Impl::item_count || static_cast<size_t>(end - pos) / 8 < total)
+                return 0;
+            for (size_t i = 0; i < n; ++i)
+            {
+                const unsigned count = counts[i];
+                UInt u;
+                for (unsigned j = 0; j < Impl::item_count; ++j)
+                    u.items[Impl::little(j)] = j < count ? detail::load_le64(pos + j * 8) : 0;
+                pos += count * 8;
+                out[i] = detail::from_unsigned<Bits, Signed>(u);
+            }
+            break;
+        }
+        default:
+            return 0;
+    }
+    return pos ? static_cast<size_t>(pos - in) : 0;
+}
+
+}
+}
@@ -0,0 +1,577 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <charconv>
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <system_error>
+#include <type_traits>
+#include "numeric.h"
+
+/// Fixed-point decimals on top of signed wide integers, in the spirit of ClickHouse's Decimal256.
+///
+/// decimal<Bits, Scale>    - value * 10^-Scale held in integer<Bits, signed>, the scale fixed at compile time.
+/// dynamic_decimal<Bits>   - the same with the scale carried at run time, for scales that come with the data.
+///
+/// Operands of different scales are aligned to the larger scale by multiplying with a power of ten from
+/// pow10<Bits>. Products are formed exactly in 2 * Bits with mul_wide and brought back to the larger
+/// scale by dividing with a precomputed reciprocal of the power of ten. Rescaling down truncates towards
+/// zero, and like the underlying integers the arithmetic wraps modulo 2^Bits.
+///
+/// to_chars / from_chars format and parse "-123.4500" style text, always with `scale` fractional digits
+/// on output.
+
+namespace wide
+{
+
+namespace detail
+{
+
+/// A 64-bit divisor prepared for dividing many items by it: the divisor normalized to have its top bit
+/// set and the reciprocal floor((2^128 - 1) / d) - 2^64 (Moller and Granlund, "Improved division by
+/// invariant integers"). Each item then costs two multiplications instead of a 128-by-64 division.
+struct invariant_divisor
+{
+    uint64_t divisor = 0;
+    uint64_t reciprocal = 0;
+    unsigned shift = 0;
+
+    constexpr invariant_divisor() noexcept = default;
+
+    constexpr explicit invariant_divisor(uint64_t d) noexcept
+        : divisor(d << __builtin_clzll(d))
+        , reciprocal(static_cast<uint64_t>(~static_cast<unsigned __int128>(0) / (d << __builtin_clzll(d))))
+        , shift(static_cast<unsigned>(__builtin_clzll(d)))
+    {
+    }
+
+    /// (hi:lo) / divisor for hi < divisor; the remainder goes to `rem`.
+    constexpr uint64_t divide(uint64_t hi, uint64_t lo, uint64_t & rem) const noexcept
+    {
+        const unsigned __int128 q = static_cast<unsigned __int128>(reciprocal) * hi + ((static_cast<unsigned __int128>(hi) << 64) | lo);
+        uint64_t q1 = static_cast<uint64_t>(q >> 64) + 1;
+        const uint64_t q0 = static_cast<uint64_t>(q);
+        uint64_t r = lo - q1 * divisor;
+        if (r > q0)
+        {
+            --q1;
+            r += divisor;
+        }
+        if (r >= divisor)
+        {
+            ++q1;
+            r -= divisor;
+        }
+        rem = r;
+        return q1;
+    }
+};
+
+/// value /= d in place; returns value % d. Leading zero items are skipped, the rest of the dividend is
+/// normalized on the fly, item by item.
+template <size_t Bits>
+constexpr uint64_t div_mod_invariant(integer<Bits, unsigned> & value, const invariant_divisor & d) noexcept
+{
+    using Impl = typename integer<Bits, unsigned>::_impl;
+    constexpr unsigned count = Impl::item_count;
+
+    unsigned top = 0;
+    while (top < count && value.items[Impl::big(top)] == 0)
+        ++top;
+    if (top == count)
+        return 0;
+
+    uint64_t rem = 0;
+    if (d.shift == 0)
+    {
+        for (unsigned i = top; i < count; ++i)
+            value.items[Impl::big(i)] = d.divide(rem, value.items[Impl::big(i)], rem);
+        return rem;
+    }
+
+    rem = value.items[Impl::big(top)] >> (64 - d.shift);
+    for (unsigned i = top; i < count; ++i)
+    {
+        const uint64_t next = i + 1 < count ? value.items[Impl::big(i + 1)] : 0;
+        const uint64_t lo = Impl::funnel_left(value.items[Impl::big(i)], next, d.shift);
+        value.items[Impl::big(i)] = d.divide(rem, lo, rem);
+    }
+    return rem >> d.shift;
+}
+
+/// The divisors 10^0 ... 10^19, prepared at compile time.
+constexpr std::array<invariant_divisor, 20> make_pow10_divisors() noexcept
+{
+    std::array<invariant_divisor, 20> table{};
+    uint64_t p = 1;
+    for (size_t k = 0; k < table.size(); ++k, p *= 10)
+        table[k] = invariant_divisor(p);
+    return table;
+}
+
+inline constexpr std::array<invariant_divisor, 20> pow10_divisors = make_pow10_divisors();
+
+/// 10^0 ... 10^19 as plain items.
+constexpr std::array<uint64_t, 20> make_pow10_items() noexcept
+{
+    std::array<uint64_t, 20> table{};
+    uint64_t p = 1;
+    for (size_t k = 0; k < table.size(); ++k, p *= 10)
+        table[k] = p;
+    return table;
+}
+
+inline constexpr std::array<uint64_t, 20> pow10_items = make_pow10_items();
+
+constexpr unsigned max_chunk_digits = 19;
+
+/// x /= 10^k, truncating; at most 19 digits per pass over the items.
+template <size_t Bits>
+constexpr void div_pow10(integer<Bits, unsigned> & x, unsigned k) noexcept
+{
+    for (; k > max_chunk_digits; k -= max_chunk_digits)
+        div_mod_invariant(x, pow10_divisors[max_chunk_digits]);
+    if (k)
+        div_mod_invariant(x, pow10_divisors[k]);
+}
+
+/// x = x * mul + add modulo 2^Bits in one pass; returns the item carried out of the top.
+template <size_t Bits, typename Signed>
+constexpr uint64_t mul_add_small(integer<Bits, Signed> & x, uint64_t mul, uint64_t add = 0) noexcept
+{
+    using Impl = typename integer<Bits, Signed>::_impl;
+    unsigned __int128 carry = add;
+    for (unsigned i = 0; i < Impl::item_count; ++i)
+    {
+        carry += static_cast<unsigned __int128>(x.items[Impl::little(i)]) * mul;
+        x.items[Impl::little(i)] = static_cast<uint64_t>(carry);
+        carry >>= 64;
+    }
+    return static_cast<uint64_t>(carry);
+}
+
+/// x * 10^k modulo 2^Bits.
+template <size_t Bits>
+constexpr integer<Bits, signed> mul_pow10(integer<Bits, signed> x, unsigned k) noexcept
+{
+    for (; k > max_chunk_digits; k -= max_chunk_digits)
+        mul_add_small(x, pow10_items[max_chunk_digits]);
+    if (k)
+        mul_add_small(x, pow10_items[k]);
+    return x;
+}
+
+/// a * b / 10^k truncated towards zero, with the product formed exactly in 2 * Bits.
+template <size_t Bits>
+integer<Bits, signed> mul_rescale(const integer<Bits, signed> & a, const integer<Bits, signed> & b, unsigned k) noexcept
+{
+    using Impl = typename integer<Bits, signed>::_impl;
+    using WideImpl = typename integer<2 * Bits, unsigned>::_impl;
+
+    /// |a| * |b| exactly, divided while still wide; truncate to Bits by copying the low items and
+    /// restore the sign there.
+    integer<2 * Bits, unsigned> magnitude = Impl::multiply_wide(Impl::make_positive(a), Impl::make_positive(b));
+    div_pow10(magnitude, k);
+
+    integer<Bits, unsigned> res{};
+    for (unsigned i = 0; i < Impl::item_count; ++i)
+        res.items[Impl::little(i)] = magnitude.items[WideImpl::little(i)];
+    if (Impl::is_negative(a) != Impl::is_negative(b))
+        integer<Bits, unsigned>::_impl::sub_borrow(res, integer<Bits, unsigned>{}, res);
+    return integer<Bits, signed>(res);
+}
+
+/// Sign of a * 10^-a_scale - b * 10^-b_scale. The aligned values are formed in 2 * Bits, where
+/// they cannot wrap.
+template <size_t Bits>
+int compare_scaled(const integer<Bits, signed> & a, unsigned a_scale, const integer<Bits, signed> & b, unsigned b_scale) noexcept
+{
+    using Wide = integer<2 * Bits, signed>;
+    const unsigned scale = std::max(a_scale, b_scale);
+    const Wide lhs = mul_pow10(Wide(a), scale - a_scale);
+    const Wide rhs = mul_pow10(Wide(b), scale - b_scale);
+    return lhs < rhs ? -1 : (rhs < lhs ? 1 : 0);
+}
+
+/// Writes raw * 10^-scale. Digits are produced 19 at a time from the end of a local buffer.
+template <size_t Bits>
+std::to_chars_result decimal_to_chars(char * first, char * last, const integer<Bits, signed> & raw, unsigned scale) noexcept
+{
+    using UInt = integer<Bits, unsigned>;
+    using Impl = typename UInt::_impl;
+    constexpr size_t max_digits = pow10_count(Bits) + 1;
+
+    char digits[max_digits];
+    char * const end = digits + max_digits;
+    char * pos = end;
+    UInt n = unsigned_magnitude(raw);
+    while (!fits_item(n))
+    {
+        uint64_t chunk = div_mod_invariant(n, pow10_divisors[max_chunk_digits]);
+        for (unsigned i = 0; i < max_chunk_digits; ++i)
+        {
+            *--pos = static_cast<char>('0' + chunk % 10);
+            chunk /= 10;
+        }
+    }
+    uint64_t low = n.items[Impl::little(0)];
+    do
+    {
+        *--pos = static_cast<char>('0' + low % 10);
+        low /= 10;
+    } while (low);
+
+    /// At least one integer digit in front of the fraction.
+    while (static_cast<size_t>(end - pos) < scale + 1)
+        *--pos = '0';
+
+    const bool negative = integer<Bits, signed>::_impl::is_negative(raw);
+    const size_t integer_digits = static_cast<size_t>(end - pos) - scale;
+    const size_t size = negative + integer_digits + (scale ? scale + 1 : 0);
+    if (static_cast<size_t>(last - first) < size)
+        return {last, std::errc::value_too_large};
+
+    char * out = first;
+    if (negative)
+        *out++ = '-';
+    out = std::copy(pos, pos + integer_digits, out);
+    if (scale)
+    {
+        *out++ = '.';
+        out = std::copy(pos + integer_digits, end, out);
+    }
+    return {out, std::errc{}};
+}
+
+/// Parses [-+]digits[.digits] into raw * 10^-scale. With `fixed_scale` fractional digits past `scale`
+/// are dropped; otherwise `scale` receives the number of fractional digits in the text. Digits are
+/// accumulated 19 at a time with one multiply-add pass per chunk.
+template <size_t Bits>
+std::from_chars_result
+decimal_from_chars(const char * first, const char * last, integer<Bits, signed> & raw, unsigned & scale, bool fixed_scale) noexcept
+{
+    using UInt = integer<Bits, unsigned>;
+    constexpr unsigned max_scale = static_cast<unsigned>(pow10_count(Bits)) - 1;
+
+    const char * pos = first;
+    bool negative = false;
+    if (pos != last && (*pos == '-' || *pos == '+'))
+        negative = *pos++ == '-';
+
+    UInt n = 0;
+    bool overflow = false;
+    uint64_t chunk = 0;
+    unsigned chunk_digits = 0;
+    auto flush = [&]
+    {
+        if (chunk_digits)
+            overflow |= mul_add_small(n, pow10_items[chunk_digits], chunk) != 0;
+        chunk = 0;
+        chunk_digits = 0;
+    };
+    auto push = [&](char c)
+    {
+        chunk = chunk * 10 + static_cast<uint64_t>(c - '0');
+        if (++chunk_digits == max_chunk_digits)
+            flush();
+    };
+
+    const char * digits_begin = pos;
+    for (; pos != last && *pos >= '0' && *pos <= '9'; ++pos)
+        push(*pos);
+    bool any_digits = pos != digits_begin;
+
+    unsigned fraction_digits = 0;
+    const unsigned fraction_limit = fixed_scale ? scale : max_scale;
+    if (pos != last && *pos == '.')
+    {
+        const char * fraction_begin = ++pos;
+        for (; pos != last && *pos >= '0' && *pos <= '9'; ++pos)
+        {
+            if (fraction_digits < fraction_limit)
+            {
+                push(*pos);
+                ++fraction_digits;
+            }
+        }
+        any_digits = any_digits || pos != fraction_begin;
+    }
+    if (!any_digits)
+        return {first, std::errc::invalid_argument};
+    flush();
+
+    const unsigned target_scale = fixed_scale ? scale : fraction_digits;
+    for (unsigned k = target_scale - fraction_digits; k; k -= std::min(k, max_chunk_digits))
+        overflow |= mul_add_small(n, pow10_items[std::min(k, max_chunk_digits)]) != 0;
+
+    /// |value| may reach 2^(Bits - 1) only when negative.
+    const UInt limit = UInt(1) << int(Bits - 1);
+    overflow |= negative ? n > limit : n >= limit;
+    if (overflow)
+        return {pos, std::errc::result_out_of_range};
+
+    raw = integer<Bits, signed>(negative ? UInt(0) - n : n);
+    scale = target_scale;
+    return {pos, std::errc{}};
+}
+
+}
+
+/// Fixed-point decimal with `Scale` fractional digits: the stored integer is value * 10^Scale.
+template <size_t Bits, unsigned Scale>
+class decimal
+{
+public:
+    using value_type = integer<Bits, signed>;
+    static constexpr unsigned scale = Scale;
+
+    static_assert(Scale < detail::pow10_count(Bits), "10^Scale must fit into the integer");
+
+    constexpr decimal() noexcept = default;
+
+    /// The whole number `n`.
+    template <typename T, typename = std::enable_if_t<std::is_integral_v<T>>>
+    decimal(T n) noexcept
+        : value_(detail::mul_pow10(value_type(n), Scale))
+    {
+    }
+
+    static constexpr decimal from_raw(const value_type & raw) noexcept
+    {
+        decimal res;
+        res.value_ = raw;
+        return res;
+    }
+
+    constexpr const value_type & raw() const noexcept { return value_; }
+
+    /// The same value with `NewScale` fractional digits, truncated towards zero when digits are dropped.
+    template <unsigned NewScale>
+    decimal<Bits, NewScale> rescale() const noexcept
+    {
+        if constexpr (NewScale >= Scale)
+            return decimal<Bits, NewScale>::from_raw(detail::mul_pow10(value_, NewScale - Scale));
+        else
+        {
+            using Impl = typename value_type::_impl;
+            integer<Bits, unsigned> magnitude = detail::unsigned_magnitude(value_);
+            detail::div_pow10(magnitude, Scale - NewScale);
+            const value_type res(magnitude);
+            return decimal<Bits, NewScale>::from_raw(Impl::is_negative(value_) ? Impl::operator_unary_minus(res) : res);
+        }
+    }
+
+    decimal & operator+=(const decimal & rhs) noexcept
+    {
+        value_ += rhs.value_;
+        return *this;
+    }
+
+    decimal & operator-=(const decimal & rhs) noexcept
+    {
+        value_ -= rhs.value_;
+        return *this;
+    }
+
+    decimal & operator*=(const decimal & rhs) noexcept
+    {
+        value_ = detail::mul_rescale(value_, rhs.value_, Scale);
+        return *this;
+    }
+
+    decimal operator-() const noexcept { return from_raw(-value_); }
+
+    friend bool operator==(const decimal & lhs, const decimal & rhs) noexcept { return lhs.value_ == rhs.value_; }
+    friend bool operator!=(const decimal & lhs, const decimal & rhs) noexcept { return lhs.value_ != rhs.value_; }
+    friend bool operator<(const decimal & lhs, const decimal & rhs) noexcept { return lhs.value_ < rhs.value_; }
+    friend bool operator>(const decimal & lhs, const decimal & rhs) noexcept { return rhs.value_ < lhs.value_; }
+    friend bool operator<=(const decimal & lhs, const decimal & rhs) noexcept { return !(rhs.value_ < lhs.value_); }
+    friend bool operator>=(const decimal & lhs, const decimal & rhs) noexcept { return !(lhs.value_ < rhs.value_); }
+
+private:
+    value_type value_{};
+};
+
+/// Sum, difference and product of decimals of any two scales, at the larger of the two.
+template <size_t Bits, unsigned S1, unsigned S2>
+decimal<Bits, std::max(S1, S2)> operator+(const decimal<Bits, S1> & lhs, const decimal<Bits, S2> & rhs) noexcept
+{
+    constexpr unsigned S = std::max(S1, S2);
+    return decimal<Bits, S>::from_raw(detail::mul_pow10(lhs.raw(), S - S1) + detail::mul_pow10(rhs.raw(), S - S2));
+}
+
+template <size_t Bits, unsigned S1, unsigned S2>
+decimal<Bits, std::max(S1, S2)> operator-(const decimal<Bits, S1> & lhs, const decimal<Bits, S2> & rhs) noexcept
+{
+    constexpr unsigned S = std::max(S1, S2);
+    return decimal<Bits, S>::from_raw(detail::mul_pow10(lhs.raw(), S - S1) - detail::mul_pow10(rhs.raw(), S - S2));
+}
+
+template <size_t Bits, unsigned S1, unsigned S2>
+decimal<Bits, std::max(S1, S2)> operator*(const decimal<Bits, S1> & lhs, const decimal<Bits, S2> & rhs) noexcept
+{
+    return decimal<Bits, std::max(S1, S2)>::from_raw(detail::mul_rescale(lhs.raw(), rhs.raw(), std::min(S1, S2)));
+}
+
+/// Decimal with the scale chosen at run time, e.g. from a column schema.
+template <size_t Bits>
+class dynamic_decimal
+{
+public:
+    using value_type = integer<Bits, signed>;
+    static constexpr unsigned max_scale = static_cast<unsigned>(detail::pow10_count(Bits)) - 1;
+
+    constexpr dynamic_decimal() noexcept = default;
+
+    template <unsigned Scale>
+    constexpr dynamic_decimal(const decimal<Bits, Scale> & value) noexcept
+        : value_(value.raw())
+        , scale_(Scale)
+    {
+    }
+
+    /// raw * 10^-scale; throws if 10^scale does not fit into the integer.
+    static dynamic_decimal from_raw(const value_type & raw, unsigned scale)
+    {
+        if (scale > max_scale)
+            throwError("dynamic_decimal: scale is too large");
+        dynamic_decimal res;
+        res.value_ = raw;
+        res.scale_ = scale;
+        return res;
+    }
+
+    constexpr const value_type & raw() const noexcept { return value_; }
+    constexpr unsigned scale() const noexcept { return scale_; }
+
+    /// The same value with `new_scale` fractional digits, truncated towards zero when digits are dropped.
+    dynamic_decimal rescale(unsigned new_scale) const
+    {
+        if (new_scale >= scale_)
+            return from_raw(detail::mul_pow10(value_, new_scale - scale_), new_scale);
+
+        using Impl = typename value_type::_impl;
+        integer<Bits, unsigned> magnitude = detail::unsigned_magnitude(value_);
+        detail::div_pow10(magnitude, scale_ - new_scale);
+        const value_type res(magnitude);
+        return from_raw(Impl::is_negative(value_) ? Impl::operator_unary_minus(res) : res, new_scale);
+    }
+
+    template <unsigned Scale>
+    decimal<Bits, Scale> to_static() const noexcept
+    {
+        return decimal<Bits, Scale>::from_raw(rescale(Scale).raw());
+    }
+
+    friend dynamic_decimal operator+(const dynamic_decimal & lhs, const dynamic_decimal & rhs) noexcept
+    {
+        const unsigned s = std::max(lhs.scale_, rhs.scale_);
+        return make(detail::mul_pow10(lhs.value_, s - lhs.scale_) + detail::mul_pow10(rhs.value_, s - rhs.scale_), s);
+    }
+
+    friend dynamic_decimal operator-(const dynamic_decimal & lhs, const dynamic_decimal & rhs) noexcept
+    {
+        const unsigned s = std::max(lhs.scale_, rhs.scale_);
+        return make(detail::mul_pow10(lhs.value_, s - lhs.scale_) - detail::mul_pow10(rhs.value_, s - rhs.scale_), s);
+    }
+
+    friend dynamic_decimal operator*(const dynamic_decimal & lhs, const dynamic_decimal & rhs) noexcept
+    {
+        return make(detail::mul_rescale(lhs.value_, rhs.value_, std::min(lhs.scale_, rhs.scale_)), std::max(lhs.scale_, rhs.scale_));
+    }
+
+    dynamic_decimal operator-() const noexcept { return make(-value_, scale_); }
+
+    /// Comparisons are by value, so 1.50 == 1.5.
+    friend bool operator==(const dynamic_decimal & lhs, const dynamic_decimal & rhs) noexcept { return compare(lhs, rhs) == 0; }
+    friend bool operator!=(const dynamic_decimal & lhs, const dynamic_decimal & rhs) noexcept { return compare(lhs, rhs) != 0; }
+    friend bool operator<(const dynamic_decimal & lhs, const dynamic_decimal & rhs) noexcept { return compare(lhs, rhs) < 0; }
+    friend bool operator>(const dynamic_decimal & lhs, const dynamic_decimal & rhs) noexcept { return compare(lhs, rhs) > 0; }
+    friend bool operator<=(const dynamic_decimal & lhs, const dynamic_decimal & rhs) noexcept { return compare(lhs, rhs) <= 0; }
+    friend bool operator>=(const dynamic_decimal & lhs, const dynamic_decimal & rhs) noexcept { return compare(lhs, rhs) >= 0; }
+
+private:
+    static dynamic_decimal make(const value_type & raw, unsigned scale) noexcept
+    {
+        dynamic_decimal res;
+        res.value_ = raw;
+        res.scale_ = scale;
+        return res;
+    }
+
+    static int compare(const dynamic_decimal & lhs, const dynamic_decimal & rhs) noexcept
+    {
+        return detail::compare_scaled(lhs.value_, lhs.scale_, rhs.value_, rhs.scale_);
+    }
+
+    value_type value_{};
+    unsigned scale_ = 0;
+};
+
+template <size_t Bits, unsigned Scale>
+std::to_chars_result to_chars(char * first, char * last, const decimal<Bits, Scale> & value) noexcept
+{
+    return detail::decimal_to_chars(first, last, value.raw(), Scale);
+}
+
+template <size_t Bits>
+std::to_chars_result to_chars(char * first, char * last, const dynamic_decimal<Bits> & value) noexcept
+{
+    return detail::decimal_to_chars(first, last, value.raw(), value.scale());
+}
+
+/// Parses a decimal with the contract of `std::from_chars`. Fractional digits past Scale are dropped
+/// (truncation); values that do not fit give std::errc::result_out_of_range.
+template <size_t Bits, unsigned Scale>
+std::from_chars_result from_chars(const char * first, const char * last, decimal<Bits, Scale> & value) noexcept
+{
+    integer<Bits, signed> raw;
+    unsigned scale = Scale;
+    const auto res = detail::decimal_from_chars(first, last, raw, scale, true);
+    if (res.ec == std::errc{})
+        value = decimal<Bits, Scale>::from_raw(raw);
+    return res;
+}
+
+/// As above, taking the scale from the number of fractional digits in the text.
+template <size_t Bits>
+std::from_chars_result from_chars(const char * first, const char * last, dynamic_decimal<Bits> & value) noexcept
+{
+    integer<Bits, signed> raw;
+    unsigned scale = 0;
+    const auto res = detail::decimal_from_chars(first, last, raw, scale, false);
+    if (res.ec == std::errc{})
+        value = dynamic_decimal<Bits>::from_raw(raw, scale);
+    return res;
+}
+
+template <size_t Bits, unsigned Scale>
+std::string to_string(const decimal<Bits, Scale> & value)
+{
+    char buf[detail::pow10_count(Bits) + 3];
+    return std::string(buf, to_chars(buf, buf + sizeof(buf), value).ptr);
+}
+
+template <size_t Bits>
+std::string to_string(const dynamic_decimal<Bits> & value)
+{
+    char buf[detail::pow10_count(Bits) + 3];
+    return std::string(buf, to_chars(buf, buf + sizeof(buf), value).ptr);
+}
+
+template <size_t Bits, unsigned Scale>
+std::ostream & operator<<(std::ostream & out, const decimal<Bits, Scale> & value)
+{
+    return out << to_string(value);
+}
+
+template <size_t Bits>
+std::ostream & operator<<(std::ostream & out, const dynamic_decimal<Bits> & value)
+{
+    return out << to_string(value);
+}
+
+}
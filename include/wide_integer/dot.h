@@ -0,0 +1,182 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+#include "parallel.h"
+
+/// Exact sums of products of wide integers. A product of two Bits-wide values needs 2 * Bits, and a
+/// sum of up to 2^64 of them fits into 2 * Bits + 64, which is the result type here.
+///
+/// mac_accumulator keeps one column per item position of the product: the 128-bit partial
+/// products a_i * b_j with i + j == k are added into column k, which has a 64-bit overflow item of
+/// its own. Adding a product thus never propagates a carry further than one column, and the columns
+/// are combined into a single integer only when the value is read.
+///
+/// A column receives up to Bits / 64 partial products per product, each of which may bump its
+/// overflow item, so an accumulator holds fewer than 2^64 / (Bits / 64) products in total, merged
+/// accumulators included. The value itself would fit up to 2^64.
+
+namespace wide
+{
+
+template <size_t Bits, typename Signed>
+class mac_accumulator
+{
+public:
+    using value_type = integer<Bits, Signed>;
+    using result_type = integer<2 * Bits + 64, Signed>;
+
+    /// acc += lhs * rhs, exactly.
+    void add(const value_type & lhs, const value_type & rhs) noexcept
+    {
+        using Impl = typename value_type::_impl;
+        const bool negative = Impl::is_negative(lhs) != Impl::is_negative(rhs);
+        const magnitude_type a = magnitude(lhs);
+        const magnitude_type b = magnitude(rhs);
+        const limb_span<const uint64_t> a_items = limbs(a);
+        const limb_span<const uint64_t> b_items = limbs(b);
+
+        sums & target = parts[negative];
+        for (size_t i = 0; i < items; ++i)
+        {
+            const uint64_t a_item = a_items[i];
+            if (!a_item)
+                continue;
+            for (size_t j = 0; j < items; ++j)
+            {
+                const unsigned __int128 product = static_cast<unsigned __int128>(a_item) * b_items[j];
+                unsigned __int128 & low = target.low[i + j];
+                low += product;
+                target.high[i + j] += low < product;
+            }
+        }
+    }
+
+    /// acc += lhs[i] * rhs[i] for i < n.
+    void add(const value_type * lhs, const value_type * rhs, size_t n) noexcept
+    {
+        for (size_t i = 0; i < n; ++i)
+            add(lhs[i], rhs[i]);
+    }
+
+    /// Adds the products collected by `other`, e.g. by another thread over another part of the input.
+    void merge(const mac_accumulator & other) noexcept
+    {
+        for (size_t sign = 0; sign < signs; ++sign)
+        {
+            for (size_t k = 0; k < columns; ++k)
+            {
+                unsigned __int128 & low = parts[sign].low[k];
+                low += other.parts[sign].low[k];
+                parts[sign].high[k] += other.parts[sign].high[k] + (low < other.parts[sign].low[k]);
+            }
+        }
+    }
+
+    /// The sum of all products so far, with the carries of all columns resolved.
+    result_type value() const noexcept
+    {
+        result_type res = normalize(parts[0]);
+        if constexpr (signs == 2)
+            res -= normalize(parts[1]);
+        return res;
+    }
+
+    void reset() noexcept { *this = mac_accumulator(); }
+
+private:
+    using magnitude_type = integer<Bits, unsigned>;
+
+    static constexpr size_t items = Bits / 64;
+    static constexpr size_t columns = 2 * items - 1;
+    /// Signed products are collected by the sign of the product, as magnitudes.
+    static constexpr size_t signs = std::is_same_v<Signed, signed> ? 2 : 1;
+
+    /// Column k stands for (high[k] * 2^128 + low[k]) * 2^(64 * k).
+    struct sums
+    {
+        unsigned __int128 low[columns] = {};
+        uint64_t high[columns] = {};
+    };
+
+    static magnitude_type magnitude(const value_type & x) noexcept
+    {
+        magnitude_type res(x);
+        if (value_type::_impl::is_negative(x))
+            res = -res;
+        return res;
+    }
+
+    static result_type normalize(const sums & part) noexcept
+    {
+        result_type res = 0;
+        const limb_span<uint64_t> out = limbs(res);
+        unsigned __int128 carry = 0;
+        for (size_t k = 0; k < out.size(); ++k)
+        {
+            /// Item k collects the low item of column k, the middle one of column k - 1 and the
+            /// overflow item of column k - 2; the carry of three 64-bit items fits into 128 bits.
+            unsigned __int128 sum = carry;
+            if (k < columns)
+                sum += static_cast<uint64_t>(part.low[k]);
+            if (k >= 1 && k - 1 < columns)
+                sum += static_cast<uint64_t>(part.low[k - 1] >> 64);
+            if (k >= 2 && k - 2 < columns)
+                sum += part.high[k - 2];
+            out[k] = static_cast<uint64_t>(sum);
+            carry = sum >> 64;
+        }
+        return res;
+    }
+
+    sums parts[signs];
+};
+
+/// Exact dot product: sum of lhs[i] * rhs[i] for i < n, n < 2^64 / (Bits / 64).
+template <size_t Bits, typename Signed>
+integer<2 * Bits + 64, Signed> dot(const integer<Bits, Signed> * lhs, const integer<Bits, Signed> * rhs, size_t n) noexcept
+{
+    mac_accumulator<Bits, Signed> acc;
+    acc.add(lhs, rhs, n);
+    return acc.value();
+}
+
+namespace detail
+{
+
+/// Products per task of the parallel dot product.
+inline constexpr size_t dot_grain = 4096;
+
+template <size_t Bits, typename Signed>
+void dot_range(
+    const integer<Bits, Signed> * lhs, const integer<Bits, Signed> * rhs, size_t n, mac_accumulator<Bits, Signed> & acc, thread_pool & pool)
+{
+    if (n <= dot_grain)
+    {
+        /// A local accumulator lets the compiler keep its columns apart from the inputs.
+        mac_accumulator<Bits, Signed> local;
+        local.add(lhs, rhs, n);
+        acc.merge(local);
+        return;
+    }
+    const size_t half = n / 2;
+    mac_accumulator<Bits, Signed> upper;
+    pool.invoke(
+        [&] { dot_range(lhs, rhs, half, acc, pool); }, [&] { dot_range(lhs + half, rhs + half, n - half, upper, pool); });
+    acc.merge(upper);
+}
+
+}
+
+/// dot(lhs, rhs, n) with the products spread over `pool`. The sum is exact, so it does not depend on
+/// how the work was split.
+template <size_t Bits, typename Signed>
+integer<2 * Bits + 64, Signed> dot(const integer<Bits, Signed> * lhs, const integer<Bits, Signed> * rhs, size_t n, thread_pool & pool)
+{
+    mac_accumulator<Bits, Signed> acc;
+    detail::dot_range(lhs, rhs, n, acc, pool);
+    return acc.value();
+}
+
+}
@@ -0,0 +1,524 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <new>
+#include <type_traits>
+#include <utility>
+#if defined(__SSE2__)
+#    include <emmintrin.h>
+#endif
+#include "wide_integer.h"
+
+/// Open-addressing hash containers for wide integer keys in the style of SwissTable. Every slot has
+/// a control byte that holds 7 bits of the hash of its key, or marks the slot empty or deleted. A
+/// lookup compares a whole group of control bytes with one SIMD compare and reads keys only on a
+/// 7-bit match. Keys are stored inline as aligned_integer, values in a parallel array, and the
+/// groups of a probe sequence are aligned, so a key read never straddles a cache line.
+
+namespace wide
+{
+namespace detail
+{
+
+inline constexpr int8_t ctrl_empty = -128;
+inline constexpr int8_t ctrl_deleted = -2;
+
+#if defined(__SSE2__)
+/// 16 control bytes compared with SSE2; bit i of a mask stands for slot i of the group.
+class probe_group
+{
+public:
+    static constexpr size_t width = 16;
+    static constexpr unsigned shift = 0;
+
+    explicit probe_group(const int8_t * ctrl) noexcept : bytes(_mm_loadu_si128(reinterpret_cast<const __m128i *>(ctrl))) { }
+
+    uint64_t match(int8_t h2) const noexcept
+    {
+        return static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(bytes, _mm_set1_epi8(h2))));
+    }
+
+    uint64_t match_empty() const noexcept { return match(ctrl_empty); }
+
+    /// Empty and deleted slots are the ones with the sign bit set.
+    uint64_t match_free() const noexcept { return static_cast<uint32_t>(_mm_movemask_epi8(bytes)); }
+
+private:
+    __m128i bytes;
+};
+#else
+/// 8 control bytes compared within a word; bit 8 * i + 7 of a mask stands for slot i of the group.
+/// match() may also report a full slot just above a real match, which the key comparison rejects.
+class probe_group
+{
+public:
+    static constexpr size_t width = 8;
+    static constexpr unsigned shift = 3;
+
+    explicit probe_group(const int8_t * ctrl) noexcept
+    {
+        std::memcpy(&word, ctrl, sizeof(word));
+        if constexpr (std::endian::native != std::endian::little)
+            word = __builtin_bswap64(word);
+    }
+
+    uint64_t match(int8_t h2) const noexcept
+    {
+        const uint64_t x = word ^ (lsbs * static_cast<uint8_t>(h2));
+        return (x - lsbs) & ~x & msbs;
+    }
+
+    /// Empty is the only control value with the top bit set and bit 1 clear.
+    uint64_t match_empty() const noexcept { return word & ~(word << 6) & msbs; }
+    uint64_t match_free() const noexcept { return word & msbs; }
+
+private:
+    static constexpr uint64_t lsbs = 0x0101010101010101ULL;
+    static constexpr uint64_t msbs = 0x8080808080808080ULL;
+    uint64_t word;
+};
+#endif
+
+/// The table behind flat_map (V is the mapped type) and flat_set (V is void).
+template <size_t Bits, typename Signed, typename V>
+class flat_table
+{
+public:
+    using key_type = integer<Bits, Signed>;
+    using slot_key = aligned_integer<Bits, Signed>;
+    static constexpr bool has_values = !std::is_void_v<V>;
+    using value_slot = std::conditional_t<has_values, V, char>;
+    static constexpr size_t npos = ~size_t(0);
+    static constexpr size_t width = probe_group::width;
+
+    flat_table() noexcept = default;
+
+    flat_table(const flat_table & other)
+    {
+        reserve(other.size_);
+        try
+        {
+            other.for_each_slot([this, &other](size_t i) {
+                const size_t j = prepare(other.keys_[i]).first;
+                new (&keys_[j]) slot_key(other.keys_[i]);
+                if constexpr (has_values)
+                    construct_value(j, other.values_[i]);
+            });
+        }
+        catch (...)
+        {
+            release();
+            throw;
+        }
+    }
+
+    flat_table(flat_table && other) noexcept { swap(other); }
+
+    flat_table & operator=(flat_table other) noexcept
+    {
+        swap(other);
+        return *this;
+    }
+
+    ~flat_table() { release(); }
+
+    void swap(flat_table & other) noexcept
+    {
+        std::swap(ctrl_, other.ctrl_);
+        std::swap(keys_, other.keys_);
+        std::swap(values_, other.values_);
+        std::swap(capacity_, other.capacity_);
+        std::swap(size_, other.size_);
+        std::swap(deleted_, other.deleted_);
+    }
+
+    size_t size() const noexcept { return size_; }
+    size_t capacity() const noexcept { return capacity_; }
+
+    void clear() noexcept
+    {
+        destroy_values();
+        if (capacity_)
+            std::memset(ctrl_, ctrl_empty, capacity_);
+        size_ = 0;
+        deleted_ = 0;
+    }
+
+    /// Makes room for n keys without further growth.
+    void reserve(size_t n)
+    {
+        size_t capacity = width;
+        while (capacity / 8 * 7 < n)
+            capacity *= 2;
+        if (capacity > capacity_)
+            rehash(capacity);
+    }
+
+    static size_t hash(const key_type & key) noexcept { return std::hash<key_type>()(key); }
+
+    /// Compares all items without an early exit.
+    static bool equal(const key_type & lhs, const key_type & rhs) noexcept
+    {
+        uint64_t diff = 0;
+        for (unsigned i = 0; i < Bits / 64; ++i)
+            diff |= lhs.items[i] ^ rhs.items[i];
+        return diff == 0;
+    }
+
+    /// The slot of `key` with hash `h`, or npos.
+    size_t find(const key_type & key, size_t h) const noexcept
+    {
+        if (capacity_ == 0)
+            return npos;
+        const size_t groups = capacity_ / width - 1;
+        size_t group = (h >> 7) & groups;
+        for (size_t step = 1;; ++step)
+        {
+            const probe_group probe(ctrl_ + group * width);
+            for (uint64_t mask = probe.match(static_cast<int8_t>(h & 0x7F)); mask; mask &= mask - 1)
+            {
+                const size_t i = group * width + (static_cast<size_t>(__builtin_ctzll(mask)) >> probe_group::shift);
+                if (equal(keys_[i], key))
+                    return i;
+            }
+            if (probe.match_empty())
+                return npos;
+            group = (group + step) & groups;
+        }
+    }
+
+    /// The slot of `key`, and whether it was just claimed; the key and value of a claimed slot are
+    /// for the caller to construct.
+    std::pair<size_t, bool> prepare(const key_type & key, size_t h)
+    {
+        const size_t found = find(key, h);
+        if (found != npos)
+            return {found, false};
+        if (size_ + deleted_ >= capacity_ / 8 * 7)
+            rehash(capacity_ == 0 ? width : size_ < capacity_ / 2 ? capacity_ : capacity_ * 2);
+
+        const size_t i = find_free(h);
+        deleted_ -= ctrl_[i] == ctrl_deleted;
+        ctrl_[i] = static_cast<int8_t>(h & 0x7F);
+        ++size_;
+        return {i, true};
+    }
+
+    std::pair<size_t, bool> prepare(const key_type & key) { return prepare(key, hash(key)); }
+
+    /// Constructs the value of slot i, just claimed by prepare(); if that throws, the slot is given
+    /// up again so that the table never holds a full slot without a value.
+    template <typename... Args>
+    void construct_value(size_t i, Args &&... args)
+    {
+        try
+        {
+            new (&values_[i]) V(std::forward<Args>(args)...);
+        }
+        catch (...)
+        {
+            vacate(i);
+            throw;
+        }
+    }
+
+    bool erase(const key_type & key) noexcept
+    {
+        const size_t i = find(key, hash(key));
+        if (i == npos)
+            return false;
+        if constexpr (has_values)
+            values_[i].~V();
+        vacate(i);
+        return true;
+    }
+
+    /// Calls f(index, hash) for keys[0, n) in blocks: a block is hashed first and the control bytes
+    /// and first keys of every first probe group prefetched, so that the cache misses of a block
+    /// overlap. Groups fill from the front, so the first keys are the likely matches.
+    template <typename F>
+    void for_each_prefetched(const key_type * keys, size_t n, F && f) const
+    {
+        constexpr size_t block = 16;
+        size_t hashes[block];
+        for (size_t start = 0; start < n; start += block)
+        {
+            const size_t count = n - start < block ? n - start : block;
+            for (size_t j = 0; j < count; ++j)
+            {
+                hashes[j] = hash(keys[start + j]);
+                if (capacity_)
+                {
+                    const size_t first = ((hashes[j] >> 7) & (capacity_ / width - 1)) * width;
+                    __builtin_prefetch(ctrl_ + first);
+                    __builtin_prefetch(keys_ + first);
+                }
+            }
+            for (size_t j = 0; j < count; ++j)
+                f(start + j, hashes[j]);
+        }
+    }
+
+    template <typename F>
+    void for_each_slot(F && f) const
+    {
+        for (size_t i = 0; i < capacity_; ++i)
+            if (ctrl_[i] >= 0)
+                f(i);
+    }
+
+    const key_type & key(size_t i) const noexcept { return keys_[i]; }
+    slot_key * keys() noexcept { return keys_; }
+    value_slot * values() noexcept { return values_; }
+    const value_slot * values() const noexcept { return values_; }
+
+private:
+    void vacate(size_t i) noexcept
+    {
+        /// Probes stop at the first group with an empty slot, so no probe passes this group if it
+        /// has one and the slot can become empty instead of a tombstone.
+        const bool stops = probe_group(ctrl_ + i / width * width).match_empty() != 0;
+        ctrl_[i] = stops ? ctrl_empty : ctrl_deleted;
+        deleted_ += !stops;
+        --size_;
+    }
+
+    size_t find_free(size_t h) const noexcept
+    {
+        const size_t groups = capacity_ / width - 1;
+        size_t group = (h >> 7) & groups;
+        for (size_t step = 1;; ++step)
+        {
+            const uint64_t mask = probe_group(ctrl_ + group * width).match_free();
+            if (mask)
+                return group * width + (static_cast<size_t>(__builtin_ctzll(mask)) >> probe_group::shift);
+            group = (group + step) & groups;
+        }
+    }
+
+    void rehash(size_t capacity)
+    {
+        flat_table next;
+        next.ctrl_ = new int8_t[capacity];
+        std::memset(next.ctrl_, ctrl_empty, capacity);
+        next.capacity_ = capacity;
+        next.keys_ = static_cast<slot_key *>(::operator new(capacity * sizeof(slot_key), std::align_val_t(alignof(slot_key))));
+        next.values_ = static_cast<value_slot *>(::operator new(capacity * sizeof(value_slot), std::align_val_t(alignof(value_slot))));
+
+        for (size_t i = 0; i < capacity_; ++i)
+        {
+            if (ctrl_[i] < 0)
+                continue;
+            const size_t h = hash(keys_[i]);
+            const size_t j = next.find_free(h);
+            new (&next.keys_[j]) slot_key(keys_[i]);
+            if constexpr (has_values)
+                new (&next.values_[j]) V(std::move_if_noexcept(values_[i]));
+            /// Marked full only once the value exists; if a copy throws, this table is left as it was.
+            next.ctrl_[j] = static_cast<int8_t>(h & 0x7F);
+        }
+        next.size_ = size_;
+        clear();
+        swap(next);
+    }
+
+    void destroy_values() noexcept
+    {
+        if constexpr (has_values && !std::is_trivially_destructible_v<V>)
+            for_each_slot([this](size_t i) { values_[i].~V(); });
+    }
+
+    void release() noexcept
+    {
+        if (capacity_ == 0)
+            return;
+        destroy_values();
+        delete[] ctrl_;
+        ::operator delete(keys_, std::align_val_t(alignof(slot_key)));
+        ::operator delete(values_, std::align_val_t(alignof(value_slot)));
+        capacity_ = 0;
+    }
+
+    int8_t * ctrl_ = nullptr;
+    slot_key * keys_ = nullptr;
+    value_slot * values_ = nullptr;
+    size_t capacity_ = 0;
+    size_t size_ = 0;
+    size_t deleted_ = 0;
+};
+
+}
+
+/// A hash map from integer<Bits, Signed> to V. Lookups return pointers to the values, which stay
+/// valid until the next insertion: an insertion may rehash, which moves every value.
+template <size_t Bits, typename Signed, typename V>
+class flat_map
+{
+public:
+    using key_type = integer<Bits, Signed>;
+    using mapped_type = V;
+    using size_type = size_t;
+
+    size_t size() const noexcept { return table.size(); }
+    bool empty() const noexcept { return table.size() == 0; }
+    size_t capacity() const noexcept { return table.capacity(); }
+    void clear() noexcept { table.clear(); }
+    void reserve(size_t n) { table.reserve(n); }
+
+    /// Inserts `key` with a value made from `args` unless it is present; returns the value of `key`
+    /// and whether it was inserted.
+    template <typename... Args>
+    std::pair<V *, bool> try_emplace(const key_type & key, Args &&... args)
+    {
+        return emplace_hashed(key, Table::hash(key), std::forward<Args>(args)...);
+    }
+
+    std::pair<V *, bool> insert(const key_type & key, const V & value) { return try_emplace(key, value); }
+
+    V & operator[](const key_type & key) { return *try_emplace(key).first; }
+
+    V * find(const key_type & key) noexcept
+    {
+        const size_t i = table.find(key, Table::hash(key));
+        return i == Table::npos ? nullptr : &table.values()[i];
+    }
+
+    const V * find(const key_type & key) const noexcept
+    {
+        const size_t i = table.find(key, Table::hash(key));
+        return i == Table::npos ? nullptr : &table.values()[i];
+    }
+
+    bool contains(const key_type & key) const noexcept { return find(key) != nullptr; }
+
+    bool erase(const key_type & key) noexcept { return table.erase(key); }
+
+    /// Calls f(key, value) for every entry, in no particular order.
+    template <typename F>
+    void for_each(F && f)
+    {
+        table.for_each_slot([&](size_t i) { f(table.key(i), table.values()[i]); });
+    }
+
+    template <typename F>
+    void for_each(F && f) const
+    {
+        table.for_each_slot([&](size_t i) { f(table.key(i), table.values()[i]); });
+    }
+
+    /// Inserts keys[i] with values[i] where the key is not present yet, prefetching ahead, and
+    /// returns the number of keys inserted.
+    size_t insert(const key_type * keys, const V * values, size_t n)
+    {
+        size_t inserted = 0;
+        table.for_each_prefetched(keys, n, [&](size_t i, size_t h) { inserted += emplace_hashed(keys[i], h, values[i]).second; });
+        return inserted;
+    }
+
+    /// Sets out[i] to the value of keys[i] or nullptr, prefetching ahead, and returns the number of
+    /// keys found.
+    size_t find(const key_type * keys, size_t n, V ** out)
+    {
+        size_t found = 0;
+        table.for_each_prefetched(keys, n, [&](size_t i, size_t h) {
+            const size_t slot = table.find(keys[i], h);
+            out[i] = slot == Table::npos ? nullptr : &table.values()[slot];
+            found += slot != Table::npos;
+        });
+        return found;
+    }
+
+    size_t find(const key_type * keys, size_t n, const V ** out) const
+    {
+        size_t found = 0;
+        table.for_each_prefetched(keys, n, [&](size_t i, size_t h) {
+            const size_t slot = table.find(keys[i], h);
+            out[i] = slot == Table::npos ? nullptr : &table.values()[slot];
+            found += slot != Table::npos;
+        });
+        return found;
+    }
+
+private:
+    using Table = detail::flat_table<Bits, Signed, V>;
+
+    template <typename... Args>
+    std::pair<V *, bool> emplace_hashed(const key_type & key, size_t h, Args &&... args)
+    {
+        const auto [i, inserted] = table.prepare(key, h);
+        if (inserted)
+        {
+            new (&table.keys()[i]) typename Table::slot_key(key);
+            table.construct_value(i, std::forward<Args>(args)...);
+        }
+        return {&table.values()[i], inserted};
+    }
+
+    Table table;
+};
+
+/// A hash set of integer<Bits, Signed>, laid out like flat_map without the values.
+template <size_t Bits, typename Signed>
+class flat_set
+{
+public:
+    using key_type = integer<Bits, Signed>;
+    using size_type = size_t;
+
+    size_t size() const noexcept { return table.size(); }
+    bool empty() const noexcept { return table.size() == 0; }
+    size_t capacity() const noexcept { return table.capacity(); }
+    void clear() noexcept { table.clear(); }
+    void reserve(size_t n) { table.reserve(n); }
+
+    /// Returns whether `key` was inserted, i.e. was not present.
+    bool insert(const key_type & key) { return insert_hashed(key, Table::hash(key)); }
+
+    bool contains(const key_type & key) const noexcept { return table.find(key, Table::hash(key)) != Table::npos; }
+
+    bool erase(const key_type & key) noexcept { return table.erase(key); }
+
+    /// Calls f(key) for every key, in no particular order.
+    template <typename F>
+    void for_each(F && f) const
+    {
+        table.for_each_slot([&](size_t i) { f(table.key(i)); });
+    }
+
+    /// Inserts keys[0, n), prefetching ahead, and returns the number of keys that were not present.
+    size_t insert(const key_type * keys, size_t n)
+    {
+        size_t inserted = 0;
+        table.for_each_prefetched(keys, n, [&](size_t i, size_t h) { inserted += insert_hashed(keys[i], h); });
+        return inserted;
+    }
+
+    /// Sets out[i] to whether keys[i] is present, prefetching ahead, and returns the number present.
+    size_t contains(const key_type * keys, size_t n, bool * out) const
+    {
+        size_t found = 0;
+        table.for_each_prefetched(keys, n, [&](size_t i, size_t h) {
+            out[i] = table.find(keys[i], h) != Table::npos;
+            found += out[i];
+        });
+        return found;
+    }
+
+private:
+    using Table = detail::flat_table<Bits, Signed, void>;
+
+    bool insert_hashed(const key_type & key, size_t h)
+    {
+        const auto [i, inserted] = table.prepare(key, h);
+        if (inserted)
+            new (&table.keys()[i]) typename Table::slot_key(key);
+        return inserted;
+    }
+
+    Table table;
+};
+
+}
@@ -0,0 +1,361 @@
+#pragma once
+
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <optional>
+#include <string>
+#include <system_error>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "wide_integer.h"
+
+/// On-disk columns of wide integers that are read in place through mmap (POSIX only).
+///
+/// The file starts with a 64-byte header, all fields little-endian:
+///   0  magic "WIDECOL1"          8  bits (uint32)
+///   12 signed (uint8)            13 host byte order of the data, 0 little / 1 big (uint8)
+///   14 flags, bit 0 = min/max present (uint16)
+///   16 count (uint64)            24 data offset (uint64)
+/// followed by the minimum and maximum when present, each Bits / 8 bytes in the same layout as the
+/// data. The data starts at a multiple of 64 and holds the values exactly as integer<Bits, Signed>
+/// lays them out in memory, so a mapping of the file is an array of integers.
+
+namespace wide
+{
+
+enum class access_hint
+{
+    normal,
+    sequential,
+    random,
+    willneed,
+};
+
+namespace detail
+{
+
+inline constexpr char column_magic[8] = {'W', 'I', 'D', 'E', 'C', 'O', 'L', '1'};
+inline constexpr size_t column_header_size = 64;
+inline constexpr size_t column_alignment = 64;
+inline constexpr uint16_t column_has_bounds = 1;
+
+struct column_header
+{
+    uint32_t bits = 0;
+    bool is_signed = false;
+    bool big_endian = false;
+    uint16_t flags = 0;
+    uint64_t count = 0;
+    uint64_t data_offset = 0;
+};
+
+inline void put_le(uint8_t * out, uint64_t value, size_t bytes) noexcept
+{
+    for (size_t i = 0; i < bytes; ++i)
+        out[i] = static_cast<uint8_t>(value >> (8 * i));
+}
+
+inline uint64_t get_le(const uint8_t * in, size_t bytes) noexcept
+{
+    uint64_t value = 0;
+    for (size_t i = 0; i < bytes; ++i)
+        value |= uint64_t(in[i]) << (8 * i);
+    return value;
+}
+
+inline void encode_column_header(const column_header & header, uint8_t * out) noexcept
+{
+    std::memset(out, 0, column_header_size);
+    std::memcpy(out, column_magic, sizeof(column_magic));
+    put_le(out + 8, header.bits, 4);
+    out[12] = header.is_signed;
+    out[13] = header.big_endian;
+    put_le(out + 14, header.flags, 2);
+    put_le(out + 16, header.count, 8);
+    put_le(out + 24, header.data_offset, 8);
+}
+
+inline bool decode_column_header(const uint8_t * in, column_header & header) noexcept
+{
+    if (std::memcmp(in, column_magic, sizeof(column_magic)) != 0 || in[12] > 1 || in[13] > 1)
+        return false;
+    header.bits = static_cast<uint32_t>(get_le(in + 8, 4));
+    header.is_signed = in[12];
+    header.big_endian = in[13];
+    header.flags = static_cast<uint16_t>(get_le(in + 14, 2));
+    header.count = get_le(in + 16, 8);
+    header.data_offset = get_le(in + 24, 8);
+    return true;
+}
+
+constexpr size_t column_data_offset(size_t value_size, bool bounds) noexcept
+{
+    const size_t end = column_header_size + (bounds ? 2 * value_size : 0);
+    return (end + column_alignment - 1) / column_alignment * column_alignment;
+}
+
+[[noreturn]] inline void throw_errno(const char * what)
+{
+    throw std::system_error(errno, std::generic_category(), what);
+}
+
+}
+
+/// Read-only view of a column file. The values are used in place: data() points into the mapping,
+/// aligned to 64 bytes, and stays valid until the object is destroyed.
+template <size_t Bits, typename Signed>
+class mapped_column
+{
+public:
+    using value_type = integer<Bits, Signed>;
+    using const_iterator = const value_type *;
+
+    static_assert(alignof(value_type) <= detail::column_alignment);
+
+    explicit mapped_column(const std::string & path, access_hint hint = access_hint::normal)
+    {
+        const int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+        if (fd < 0)
+            detail::throw_errno("mapped_column: cannot open file");
+
+        struct stat st;
+        if (::fstat(fd, &st) != 0)
+        {
+            const int error = errno;
+            ::close(fd);
+            errno = error;
+            detail::throw_errno("mapped_column: cannot stat file");
+        }
+        length = static_cast<size_t>(st.st_size);
+        if (length < detail::column_header_size)
+        {
+            ::close(fd);
+            throwError("mapped_column: file is too short for a header");
+        }
+
+        void * mapping = ::mmap(nullptr, length, PROT_READ, MAP_PRIVATE, fd, 0);
+        const int error = errno;
+        ::close(fd);
+        if (mapping == MAP_FAILED)
+        {
+            errno = error;
+            detail::throw_errno("mapped_column: mmap failed");
+        }
+        base = static_cast<const uint8_t *>(mapping);
+
+        try
+        {
+            open_header();
+        }
+        catch (...)
+        {
+            ::munmap(const_cast<uint8_t *>(base), length);
+            throw;
+        }
+        advise(hint);
+    }
+
+    mapped_column(const mapped_column &) = delete;
+    mapped_column & operator=(const mapped_column &) = delete;
+
+    mapped_column(mapped_column && other) noexcept
+        : base(other.base), length(other.length), values(other.values), count(other.count), bounds(other.bounds)
+    {
+        other.base = nullptr;
+        other.length = 0;
+    }
+
+    mapped_column & operator=(mapped_column && other) noexcept
+    {
+        if (this != &other)
+        {
+            unmap();
+            base = other.base;
+            length = other.length;
+            values = other.values;
+            count = other.count;
+            bounds = other.bounds;
+            other.base = nullptr;
+            other.length = 0;
+        }
+        return *this;
+    }
+
+    ~mapped_column() { unmap(); }
+
+    const value_type * data() const noexcept { return values; }
+    size_t size() const noexcept { return count; }
+    bool empty() const noexcept { return count == 0; }
+    const_iterator begin() const noexcept { return values; }
+    const_iterator end() const noexcept { return values + count; }
+    const value_type & operator[](size_t i) const noexcept { return values[i]; }
+
+    /// The bounds recorded by the writer, if any.
+    std::optional<value_type> min() const noexcept { return bounds ? std::optional<value_type>(bounds[0]) : std::nullopt; }
+    std::optional<value_type> max() const noexcept { return bounds ? std::optional<value_type>(bounds[1]) : std::nullopt; }
+
+    /// Passes the expected access pattern of the values to madvise; purely a hint.
+    void advise(access_hint hint) const noexcept
+    {
+        int advice = MADV_NORMAL;
+        if (hint == access_hint::sequential)
+            advice = MADV_SEQUENTIAL;
+        else if (hint == access_hint::random)
+            advice = MADV_RANDOM;
+        else if (hint == access_hint::willneed)
+            advice = MADV_WILLNEED;
+        ::madvise(const_cast<uint8_t *>(base), length, advice);
+    }
+
+private:
+    void open_header()
+    {
+        constexpr bool big = std::endian::native == std::endian::big;
+        detail::column_header header;
+        if (!detail::decode_column_header(base, header))
+            throwError("mapped_column: not a column file");
+        if (header.bits != Bits || header.is_signed != std::is_same_v<Signed, signed>)
+            throwError("mapped_column: file holds a different integer type");
+        if (header.big_endian != big)
+            throwError("mapped_column: file was written with a different byte order");
+
+        const bool has_bounds = header.flags & detail::column_has_bounds;
+        if (header.data_offset % detail::column_alignment != 0
+            || header.data_offset < detail::column_data_offset(sizeof(value_type), has_bounds) || header.data_offset > length
+            || header.count > (length - header.data_offset) / sizeof(value_type))
+            throwError("mapped_column: file is truncated or corrupt");
+
+        values = reinterpret_cast<const value_type *>(base + header.data_offset);
+        count = static_cast<size_t>(header.count);
+        bounds = has_bounds ? reinterpret_cast<const value_type *>(base + detail::column_header_size) : nullptr;
+    }
+
+    void unmap() noexcept
+    {
+        if (base)
+            ::munmap(const_cast<uint8_t *>(base), length);
+        base = nullptr;
+    }
+
+    const uint8_t * base = nullptr;
+    size_t length = 0;
+    const value_type * values = nullptr;
+    size_t count = 0;
+    const value_type * bounds = nullptr;
+};
+
+/// Writes a column file incrementally. The header is rewritten with the final count and bounds by
+/// finish(), which the destructor calls if needed; call it explicitly to see errors.
+template <size_t Bits, typename Signed>
+class column_writer
+{
+public:
+    using value_type = integer<Bits, Signed>;
+
+    explicit column_writer(const std::string & path, bool store_bounds = true) : store_bounds(store_bounds)
+    {
+        fd = ::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+        if (fd < 0)
+            detail::throw_errno("column_writer: cannot open file");
+        uint8_t zeros[detail::column_data_offset(sizeof(value_type), true)] = {};
+        write_all(zeros, detail::column_data_offset(sizeof(value_type), store_bounds));
+    }
+
+    column_writer(const column_writer &) = delete;
+    column_writer & operator=(const column_writer &) = delete;
+
+    ~column_writer()
+    {
+        if (fd < 0)
+            return;
+        try
+        {
+            finish();
+        }
+        catch (...)
+        {
+        }
+    }
+
+    void append(const value_type * in, size_t n)
+    {
+        for (size_t i = 0; i < n; ++i)
+        {
+            if (count == 0 && i == 0)
+                lo = hi = in[0];
+            else if (in[i] < lo)
+                lo = in[i];
+            else if (hi < in[i])
+                hi = in[i];
+        }
+        write_all(reinterpret_cast<const uint8_t *>(in), n * sizeof(value_type));
+        count += n;
+    }
+
+    void append(const value_type & x) { append(&x, 1); }
+
+    void finish()
+    {
+        if (fd < 0)
+            return;
+        detail::column_header header;
+        header.bits = Bits;
+        header.is_signed = std::is_same_v<Signed, signed>;
+        header.big_endian = std::endian::native == std::endian::big;
+        header.flags = store_bounds && count ? detail::column_has_bounds : 0;
+        header.count = count;
+        header.data_offset = detail::column_data_offset(sizeof(value_type), store_bounds);
+
+        uint8_t head[detail::column_header_size + 2 * sizeof(value_type)];
+        detail::encode_column_header(header, head);
+        std::memcpy(head + detail::column_header_size, &lo, sizeof(value_type));
+        std::memcpy(head + detail::column_header_size + sizeof(value_type), &hi, sizeof(value_type));
+
+        const size_t size = store_bounds ? sizeof(head) : detail::column_header_size;
+        const bool written = ::pwrite(fd, head, size, 0) == static_cast<ssize_t>(size);
+        const int error = errno;
+        const bool closed = ::close(fd) == 0;
+        fd = -1;
+        errno = error;
+        if (!written || !closed)
+            detail::throw_errno("column_writer: cannot finish file");
+    }
+
+private:
+    void write_all(const uint8_t * data, size_t size)
+    {
+        while (size > 0)
+        {
+            const ssize_t written = ::write(fd, data, size);
+            if (written < 0)
+            {
+                if (errno == EINTR)
+                    continue;
+                detail::throw_errno("column_writer: write failed");
+            }
+            data += written;
+            size -= static_cast<size_t>(written);
+        }
+    }
+
+    int fd = -1;
+    bool store_bounds;
+    uint64_t count = 0;
+    value_type lo{};
+    value_type hi{};
+};
+
+/// Writes in[0, n) to a new column file in one go.
+template <size_t Bits, typename Signed>
+void write_column(const std::string & path, const integer<Bits, Signed> * in, size_t n, bool store_bounds = true)
+{
+    column_writer<Bits, Signed> writer(path, store_bounds);
+    writer.append(in, n);
+    writer.finish();
+}
+
+}
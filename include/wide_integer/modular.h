@@ -0,0 +1,518 @@
+#pragma once
+
+#include <cstdint>
+#include <type_traits>
+#include "wide_integer.h"
+
+/// Modular arithmetic on unsigned wide integers.
+///
+/// montgomery<Bits>            - Montgomery form for odd moduli, modulus given at run time.
+/// montgomery<Bits, Modulus>   - the same with a compile-time modulus; `Modulus::value` must be a
+///                               `static constexpr integer<Bits, unsigned>`, all constants are folded.
+/// barrett<Bits>               - Barrett reduction for any non-zero modulus, including even ones.
+/// powmod, powmod_consttime     - modular exponentiation on top of the two contexts.
+
+namespace wide
+{
+
+namespace detail
+{
+
+/// Constants of the Montgomery domain with R = 2^Bits.
+template <size_t Bits>
+struct montgomery_params
+{
+    using value_type = integer<Bits, unsigned>;
+
+    value_type modulus{};
+    /// -modulus^-1 mod 2^64
+    uint64_t m_inv = 0;
+    /// R^2 mod modulus, used to enter the Montgomery domain.
+    value_type r2{};
+    /// R mod modulus, i.e. 1 in Montgomery form.
+    value_type one{};
+};
+
+constexpr uint64_t neg_inverse_u64(uint64_t m0) noexcept
+{
+    /// Newton iteration: for odd m0, m0 is its own inverse modulo 2^3 and every step doubles the precision.
+    uint64_t inv = m0;
+    for (int i = 0; i < 5; ++i)
+        inv *= 2 - m0 * inv;
+    return ~inv + 1;
+}
+
+template <size_t Bits>
+constexpr montgomery_params<Bits> make_montgomery_params(const integer<Bits, unsigned> & modulus)
+{
+    using Int = integer<Bits, unsigned>;
+    using Impl = typename Int::_impl;
+
+    montgomery_params<Bits> params;
+    params.modulus = modulus;
+    params.m_inv = neg_inverse_u64(modulus.items[Impl::little(0)]);
+
+    /// R mod m and R^2 mod m by modular doublings of 1, which avoids any division and keeps
+    /// the computation usable in constant expressions.
+    Int x = 1;
+    for (size_t i = 0; i < 2 * Bits; ++i)
+    {
+        if (i == Bits)
+            params.one = x;
+        bool carry = Impl::add_carry(x, x, x);
+        Int reduced{};
+        bool borrow = Impl::sub_borrow(reduced, x, modulus);
+        if (carry || !borrow)
+            x = reduced;
+    }
+    params.r2 = x;
+    return params;
+}
+
+/// Returns `lhs` if `cond` is false and `rhs` otherwise without branching on `cond`.
+template <size_t Bits>
+constexpr integer<Bits, unsigned> select(bool cond, const integer<Bits, unsigned> & lhs, const integer<Bits, unsigned> & rhs) noexcept
+{
+    const uint64_t mask = ~static_cast<uint64_t>(cond) + 1;
+    integer<Bits, unsigned> res{};
+    for (unsigned i = 0; i < integer<Bits, unsigned>::_impl::item_count; ++i)
+        res.items[i] = lhs.items[i] ^ ((lhs.items[i] ^ rhs.items[i]) & mask);
+    return res;
+}
+
+/// Final step of every Montgomery reduction: t (with an extra top bit `t_hi`) is in [0, 2m),
+/// subtract m once if t >= m. Branch-free so that it can be used for secret operands.
+template <size_t Bits>
+constexpr integer<Bits, unsigned>
+montgomery_final_sub(const integer<Bits, unsigned> & t, uint64_t t_hi, const integer<Bits, unsigned> & modulus) noexcept
+{
+    integer<Bits, unsigned> reduced{};
+    const bool borrow = integer<Bits, unsigned>::_impl::sub_borrow(reduced, t, modulus);
+    return select(t_hi == 0 && borrow, reduced, t);
+}
+
+/// Coarsely Integrated Operand Scanning: a * b * R^-1 mod m for a, b < m.
+template <size_t Bits>
+constexpr integer<Bits, unsigned>
+montgomery_mul(const integer<Bits, unsigned> & a, const integer<Bits, unsigned> & b, const montgomery_params<Bits> & params) noexcept
+{
+    using Int = integer<Bits, unsigned>;
+    using Impl = typename Int::_impl;
+    constexpr unsigned N = Impl::item_count;
+    const Int & m = params.modulus;
+
+    uint64_t t[N + 2] = {};
+    for (unsigned i = 0; i < N; ++i)
+    {
+        const uint64_t b_i = b.items[Impl::little(i)];
+        unsigned __int128 carry = 0;
+        for (unsigned j = 0; j < N; ++j)
+        {
+            unsigned __int128 cur = static_cast<unsigned __int128>(a.items[Impl::little(j)]) * b_i + t[j] + carry;
+            t[j] = static_cast<uint64_t>(cur);
+            carry = cur >> 64;
+        }
+        unsigned __int128 top = static_cast<unsigned __int128>(t[N]) + carry;
+        t[N] = static_cast<uint64_t>(top);
+        t[N + 1] = static_cast<uint64_t>(top >> 64);
+
+        const uint64_t q = t[0] * params.m_inv;
+        unsigned __int128 cur = static_cast<unsigned __int128>(q) * m.items[Impl::little(0)] + t[0];
+        carry = cur >> 64;
+        for (unsigned j = 1; j < N; ++j)
+        {
+            cur = static_cast<unsigned __int128>(q) * m.items[Impl::little(j)] + t[j] + carry;
+            t[j - 1] = static_cast<uint64_t>(cur);
+            carry = cur >> 64;
+        }
+        top = static_cast<unsigned __int128>(t[N]) + carry;
+        t[N - 1] = static_cast<uint64_t>(top);
+        t[N] = t[N + 1] + static_cast<uint64_t>(top >> 64);
+    }
+
+    Int res{};
+    for (unsigned i = 0; i < N; ++i)
+        res.items[Impl::little(i)] = t[i];
+    return montgomery_final_sub(res, t[N], m);
+}
+
+/// a^2 * R^-1 mod m: the square is formed with half of the cross products, then reduced
+/// by separated operand scanning with a fixed number of steps.
+template <size_t Bits>
+constexpr integer<Bits, unsigned> montgomery_sqr(const integer<Bits, unsigned> & a, const montgomery_params<Bits> & params) noexcept
+{
+    using Int = integer<Bits, unsigned>;
+    using Impl = typename Int::_impl;
+    constexpr unsigned N = Impl::item_count;
+    const Int & m = params.modulus;
+
+    uint64_t t[2 * N] = {};
+    for (unsigned i = 0; i < N; ++i)
+    {
+        const uint64_t a_i = a.items[Impl::little(i)];
+        unsigned __int128 carry = 0;
+        for (unsigned j = i + 1; j < N; ++j)
+        {
+            unsigned __int128 cur = static_cast<unsigned __int128>(a_i) * a.items[Impl::little(j)] + t[i + j] + carry;
+            t[i + j] = static_cast<uint64_t>(cur);
+            carry = cur >> 64;
+        }
+        t[i + N] = static_cast<uint64_t>(carry);
+    }
+
+    /// Double the cross products and add the squares on the diagonal.
+    uint64_t shifted_out = 0;
+    for (unsigned i = 0; i < 2 * N; ++i)
+    {
+        uint64_t next = t[i] >> 63;
+        t[i] = (t[i] << 1) | shifted_out;
+        shifted_out = next;
+    }
+    unsigned __int128 carry = 0;
+    for (unsigned i = 0; i < N; ++i)
+    {
+        const uint64_t a_i = a.items[Impl::little(i)];
+        unsigned __int128 sq = static_cast<unsigned __int128>(a_i) * a_i;
+        unsigned __int128 cur = static_cast<unsigned __int128>(t[2 * i]) + static_cast<uint64_t>(sq) + carry;
+        t[2 * i] = static_cast<uint64_t>(cur);
+        cur = static_cast<unsigned __int128>(t[2 * i + 1]) + static_cast<uint64_t>(sq >> 64) + (cur >> 64);
+        t[2 * i + 1] = static_cast<uint64_t>(cur);
+        carry = cur >> 64;
+    }
+
+    uint64_t t_hi = 0;
+    for (unsigned i = 0; i < N; ++i)
+    {
+        const uint64_t q = t[i] * params.m_inv;
+        carry = 0;
+        for (unsigned j = 0; j < N; ++j)
+        {
+            unsigned __int128 cur = static_cast<unsigned __int128>(q) * m.items[Impl::little(j)] + t[i + j] + carry;
+            t[i + j] = static_cast<uint64_t>(cur);
+            carry = cur >> 64;
+        }
+        unsigned __int128 top = static_cast<unsigned __int128>(t[i + N]) + carry + t_hi;
+        t[i + N] = static_cast<uint64_t>(top);
+        t_hi = static_cast<uint64_t>(top >> 64);
+    }
+
+    Int res{};
+    for (unsigned i = 0; i < N; ++i)
+        res.items[Impl::little(i)] = t[N + i];
+    return montgomery_final_sub(res, t_hi, m);
+}
+
+template <size_t Bits, typename Modulus>
+struct fixed_montgomery_params
+{
+    static_assert(std::is_same_v<std::remove_cv_t<decltype(Modulus::value)>, integer<Bits, unsigned>>);
+    static_assert(Modulus::value.items[integer<Bits, unsigned>::_impl::little(0)] & 1, "Montgomery modulus must be odd");
+    static_assert(Modulus::value > 1, "Montgomery modulus must be greater than 1");
+
+    static constexpr montgomery_params<Bits> value = make_montgomery_params(Modulus::value);
+};
+
+template <size_t Bits>
+constexpr bool test_bit(const integer<Bits, unsigned> & x, unsigned bit) noexcept
+{
+    return (x.items[integer<Bits, unsigned>::_impl::little(bit / 64)] >> (bit % 64)) & 1;
+}
+
+/// Window width for `sliding_window_pow`, balancing the 2^(w-1) table entries against
+/// the multiplications saved during the scan.
+constexpr unsigned pow_window_bits(unsigned exp_bits) noexcept
+{
+    if (exp_bits <= 8)
+        return 1;
+    if (exp_bits <= 24)
+        return 2;
+    if (exp_bits <= 80)
+        return 3;
+    if (exp_bits <= 240)
+        return 4;
+    if (exp_bits <= 672)
+        return 5;
+    return 6;
+}
+
+/// base^exp by a left-to-right sliding window over odd powers of `base`. `ctx` provides `mul`
+/// and `sqr` in its own representation, `one` is 1 in that representation.
+template <typename Context, size_t ExpBits>
+constexpr typename Context::value_type sliding_window_pow(
+    const Context & ctx,
+    const typename Context::value_type & base,
+    const integer<ExpBits, unsigned> & exp,
+    const typename Context::value_type & one)
+{
+    using Value = typename Context::value_type;
+
+    const unsigned exp_bits = static_cast<unsigned>(bit_width(exp));
+    if (exp_bits == 0)
+        return one;
+
+    const unsigned window = pow_window_bits(exp_bits);
+    /// table[i] = base^(2i + 1)
+    Value table[1 << 5] = {};
+    table[0] = base;
+    if (window > 1)
+    {
+        const Value base_sqr = ctx.sqr(base);
+        for (unsigned i = 1; i < (1u << (window - 1)); ++i)
+            table[i] = ctx.mul(table[i - 1], base_sqr);
+    }
+
+    Value res = one;
+    bool started = false;
+    for (unsigned i = exp_bits; i > 0;)
+    {
+        if (!test_bit(exp, i - 1))
+        {
+            res = ctx.sqr(res);
+            --i;
+            continue;
+        }
+
+        /// The longest window [low, i) of at most `window` bits that ends with a set bit.
+        unsigned low = i > window ? i - window : 0;
+        while (!test_bit(exp, low))
+            ++low;
+
+        unsigned value = 0;
+        for (unsigned j = i; j > low; --j)
+        {
+            value = (value << 1) | test_bit(exp, j - 1);
+            if (started)
+                res = ctx.sqr(res);
+        }
+        res = started ? ctx.mul(res, table[value >> 1]) : table[value >> 1];
+        started = true;
+        i = low;
+    }
+    return res;
+}
+
+/// base^exp by a fixed 4-bit window over all ExpBits bits of `exp`: the sequence of squarings and
+/// multiplications and the memory access pattern do not depend on the value of `exp`.
+template <typename Context, size_t ExpBits>
+constexpr typename Context::value_type fixed_window_pow(
+    const Context & ctx,
+    const typename Context::value_type & base,
+    const integer<ExpBits, unsigned> & exp,
+    const typename Context::value_type & one)
+{
+    using Value = typename Context::value_type;
+    using Impl = typename integer<ExpBits, unsigned>::_impl;
+    constexpr unsigned window = 4;
+
+    /// table[i] = base^i
+    Value table[1 << window] = {};
+    table[0] = one;
+    table[1] = base;
+    for (unsigned i = 2; i < (1u << window); ++i)
+        table[i] = ctx.mul(table[i - 1], base);
+
+    Value res = one;
+    for (unsigned i = ExpBits; i > 0; i -= window)
+    {
+        for (unsigned j = 0; j < window; ++j)
+            res = ctx.sqr(res);
+
+        const unsigned value
+            = static_cast<unsigned>(exp.items[Impl::little((i - window) / 64)] >> ((i - window) % 64)) & ((1u << window) - 1);
+        /// Read every entry so that the selected index does not show up in the access pattern.
+        Value factor = table[0];
+        for (unsigned k = 1; k < (1u << window); ++k)
+            factor = select(k == value, factor, table[k]);
+        res = ctx.mul(res, factor);
+    }
+    return res;
+}
+
+} // namespace detail
+
+/// Montgomery multiplication context for an odd modulus m > 1 with R = 2^Bits.
+/// Values passed to `mul`, `sqr`, `add`, `sub` and `pow` are in Montgomery form and must be
+/// reduced (< m); use `to_mont`/`from_mont` to convert.
+template <size_t Bits, typename Modulus = void>
+class montgomery
+{
+    static constexpr bool is_fixed = !std::is_void_v<Modulus>;
+
+public:
+    using value_type = integer<Bits, unsigned>;
+
+    /// Only available with a compile-time modulus.
+    constexpr montgomery() noexcept { static_assert(is_fixed, "montgomery<Bits> requires a modulus"); }
+
+    constexpr explicit montgomery(const value_type & modulus)
+    {
+        static_assert(!is_fixed, "montgomery<Bits, Modulus> has a compile-time modulus");
+        if (!(modulus.items[value_type::_impl::little(0)] & 1) || modulus <= 1)
+            throwError("Montgomery modulus must be odd and greater than 1");
+        params_ = detail::make_montgomery_params(modulus);
+    }
+
+    constexpr const value_type & modulus() const noexcept { return params().modulus; }
+
+    /// 1 in Montgomery form.
+    constexpr const value_type & one() const noexcept { return params().one; }
+
+    /// x * R mod m. Accepts any x, not only reduced ones.
+    constexpr value_type to_mont(const value_type & x) const
+    {
+        const value_type reduced = x < modulus() ? x : x % modulus();
+        return detail::montgomery_mul(reduced, params().r2, params());
+    }
+
+    /// x * R^-1 mod m.
+    constexpr value_type from_mont(const value_type & x) const noexcept { return detail::montgomery_mul(x, value_type(1), params()); }
+
+    constexpr value_type mul(const value_type & a, const value_type & b) const noexcept { return detail::montgomery_mul(a, b, params()); }
+
+    constexpr value_type sqr(const value_type & a) const noexcept { return detail::montgomery_sqr(a, params()); }
+
+    constexpr value_type add(const value_type & a, const value_type & b) const noexcept
+    {
+        value_type sum{};
+        const bool carry = value_type::_impl::add_carry(sum, a, b);
+        return detail::montgomery_final_sub(sum, carry, modulus());
+    }
+
+    constexpr value_type sub(const value_type & a, const value_type & b) const noexcept
+    {
+        value_type diff{};
+        const bool borrow = value_type::_impl::sub_borrow(diff, a, b);
+        value_type wrapped{};
+        value_type::_impl::add_carry(wrapped, diff, modulus());
+        return detail::select(borrow, diff, wrapped);
+    }
+
+    /// base^exp with `base` and the result in Montgomery form.
+    template <size_t ExpBits>
+    constexpr value_type pow(const value_type & base, const integer<ExpBits, unsigned> & exp) const noexcept
+    {
+        return detail::sliding_window_pow(*this, base, exp, one());
+    }
+
+    constexpr value_type pow(const value_type & base, uint64_t exp) const noexcept { return pow(base, integer<64, unsigned>(exp)); }
+
+    /// Same as `pow`, but the running time does not depend on the value of `exp`, only on ExpBits.
+    template <size_t ExpBits>
+    constexpr value_type pow_consttime(const value_type & base, const integer<ExpBits, unsigned> & exp) const noexcept
+    {
+        return detail::fixed_window_pow(*this, base, exp, one());
+    }
+
+private:
+    constexpr const detail::montgomery_params<Bits> & params() const noexcept
+    {
+        if constexpr (is_fixed)
+            return detail::fixed_montgomery_params<Bits, Modulus>::value;
+        else
+            return params_;
+    }
+
+    struct none
+    {
+    };
+
+    std::conditional_t<is_fixed, none, detail::montgomery_params<Bits>> params_{};
+};
+
+/// Barrett reduction for a modulus m > 0 of bit length k, using the precomputed mu = floor(2^(2k) / m).
+/// `reduce` accepts any x < 2^(2k), in particular every product of two reduced values as returned by
+/// `wide::mul_wide`, and needs two multiplications and at most two conditional subtractions.
+template <size_t Bits>
+class barrett
+{
+    /// mu and the quotient estimate take up to k + 1 bits.
+    using extended_type = integer<Bits + 64, unsigned>;
+
+public:
+    using value_type = integer<Bits, unsigned>;
+    using wide_type = integer<Bits * 2, unsigned>;
+
+    explicit barrett(const value_type & modulus)
+        : modulus_(modulus)
+        , extended_modulus_(modulus)
+        , shift_(static_cast<unsigned>(bit_width(modulus)))
+    {
+        if (modulus == 0)
+            throwError("Barrett modulus must not be zero");
+        using Dividend = integer<Bits * 2 + 64, unsigned>;
+        mu_ = extended_type((Dividend(1) << int(2 * shift_)) / Dividend(modulus));
+    }
+
+    const value_type & modulus() const noexcept { return modulus_; }
+
+    /// x mod m for x < 2^(2k).
+    value_type reduce(const wide_type & x) const noexcept
+    {
+        /// floor(floor(x / 2^(k-1)) * mu / 2^(k+1)) is below floor(x / m) by at most 2.
+        const extended_type q1(x >> int(shift_ - 1));
+        const extended_type q(extended_type::_impl::multiply_wide(q1, mu_) >> int(shift_ + 1));
+
+        /// The remainder is below 3m, so the low Bits + 64 bits of both terms suffice.
+        extended_type r(x);
+        extended_type::_impl::sub_borrow(r, r, q * extended_modulus_);
+        for (int i = 0; i < 2; ++i)
+        {
+            extended_type reduced{};
+            const bool borrow = extended_type::_impl::sub_borrow(reduced, r, extended_modulus_);
+            r = detail::select(!borrow, r, reduced);
+        }
+        return value_type(r);
+    }
+
+    /// a * b mod m for a, b < m.
+    value_type mul(const value_type & a, const value_type & b) const noexcept { return reduce(mul_wide(a, b)); }
+
+    value_type sqr(const value_type & a) const noexcept { return reduce(mul_wide(a, a)); }
+
+private:
+    value_type modulus_;
+    extended_type extended_modulus_;
+    extended_type mu_{};
+    unsigned shift_;
+};
+
+/// base^exp mod m for any m > 0. Odd moduli go through Montgomery form, even ones through
+/// Barrett reduction; both scan the exponent with a sliding window.
+template <size_t Bits, size_t ExpBits>
+integer<Bits, unsigned> powmod(
+    const integer<Bits, unsigned> & base, const integer<ExpBits, unsigned> & exp, const integer<Bits, unsigned> & mod)
+{
+    using Int = integer<Bits, unsigned>;
+    if (mod == 0)
+        throwError("powmod: modulus must not be zero");
+    if (mod == 1)
+        return Int(0);
+
+    if (mod.items[Int::_impl::little(0)] & 1)
+    {
+        const montgomery<Bits> ctx(mod);
+        return ctx.from_mont(ctx.pow(ctx.to_mont(base), exp));
+    }
+
+    const barrett<Bits> ctx(mod);
+    const Int reduced = base < mod ? base : base % mod;
+    return detail::sliding_window_pow(ctx, reduced, exp, Int(1));
+}
+
+template <size_t Bits>
+integer<Bits, unsigned> powmod(const integer<Bits, unsigned> & base, uint64_t exp, const integer<Bits, unsigned> & mod)
+{
+    return powmod(base, integer<64, unsigned>(exp), mod);
+}
+
+/// base^exp mod m for secret exponents: the running time and memory access pattern depend only on
+/// ExpBits and the modulus, not on the value of `exp`. Requires an odd modulus m > 1.
+template <size_t Bits, size_t ExpBits>
+integer<Bits, unsigned> powmod_consttime(
+    const integer<Bits, unsigned> & base, const integer<ExpBits, unsigned> & exp, const integer<Bits, unsigned> & mod)
+{
+    const montgomery<Bits> ctx(mod);
+    return ctx.from_mont(ctx.pow_consttime(ctx.to_mont(base), exp));
+}
+
+}
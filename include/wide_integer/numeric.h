@@ -0,0 +1,559 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <charconv>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <system_error>
+#include <type_traits>
+#include <utility>
+#include "wide_integer.h"
+
+/// Integer powers, roots and logarithms of wide integers.
+///
+/// pow(base, exp)      - base^exp wrapped to Bits, by square-and-multiply.
+/// isqrt(x), icbrt(x)  - floor of the square root / cube root (truncated towards zero for a negative
+///                       cube), Newton iteration seeded from `operator long double`.
+/// ilog2(x), ilog10(x) - floor of the binary / decimal logarithm of a positive value.
+/// pow10<Bits>[k]      - compile-time table of the powers of ten that fit into Bits.
+/// digits10(x)         - number of decimal digits, to_chars(first, last, x) - decimal formatting.
+/// gcd, lcm, modinv    - Lehmer GCD and a binary extended Euclidean modular inverse.
+
+namespace wide
+{
+
+namespace detail
+{
+
+/// Magnitude of `x` as an unsigned value; exact for the minimum of a signed type as well.
+template <size_t Bits, typename Signed>
+constexpr integer<Bits, unsigned> unsigned_magnitude(const integer<Bits, Signed> & x) noexcept
+{
+    using UInt = integer<Bits, unsigned>;
+    UInt res(x);
+    if (integer<Bits, Signed>::_impl::is_negative(x))
+        UInt::_impl::sub_borrow(res, UInt{}, res);
+    return res;
+}
+
+/// log10(2) as a 31-bit fixed point fraction, slightly below the exact value.
+constexpr uint64_t log10_2_fixed = 646456993;
+
+/// Number of powers of ten below 2^Bits: 10^0 ... 10^(floor(Bits * log10(2))).
+constexpr size_t pow10_count(size_t bits) noexcept
+{
+    return static_cast<size_t>((bits * log10_2_fixed) >> 31) + 1;
+}
+
+template <size_t Bits>
+constexpr std::array<integer<Bits, unsigned>, pow10_count(Bits)> make_pow10_table() noexcept
+{
+    using UInt = integer<Bits, unsigned>;
+    using Impl = typename UInt::_impl;
+
+    std::array<UInt, pow10_count(Bits)> table{};
+    table[0] = 1;
+    for (size_t k = 1; k < table.size(); ++k)
+    {
+        unsigned __int128 carry = 0;
+        for (unsigned i = 0; i < Impl::item_count; ++i)
+        {
+            carry += static_cast<unsigned __int128>(table[k - 1].items[Impl::little(i)]) * 10;
+            table[k].items[Impl::little(i)] = static_cast<uint64_t>(carry);
+            carry >>= 64;
+        }
+    }
+    return table;
+}
+
+/// Schoolbook long division by 64-bit digits (Knuth, TAOCP vol. 2, 4.3.1, algorithm D): one 128-by-64-bit
+/// hardware division per quotient item instead of the one trial subtraction per quotient bit of `operator/`.
+/// `den` must not be zero.
+template <size_t Bits>
+integer<Bits, unsigned> long_divide(const integer<Bits, unsigned> & num, const integer<Bits, unsigned> & den) noexcept
+{
+    using UInt = integer<Bits, unsigned>;
+    using Impl = typename UInt::_impl;
+    constexpr unsigned N = Impl::item_count;
+
+    unsigned vn = N;
+    while (vn > 1 && den.items[Impl::little(vn - 1)] == 0)
+        --vn;
+    if (vn == 1)
+    {
+        UInt quotient = num;
+        Impl::div_mod_small(quotient, den.items[Impl::little(0)]);
+        return quotient;
+    }
+    if (num < den)
+        return UInt(0);
+
+    unsigned un = N;
+    while (num.items[Impl::little(un - 1)] == 0)
+        --un;
+
+    /// Normalize so that the top digit of the divisor has its high bit set, then every quotient
+    /// digit estimate from the top two digits of the remainder is at most 2 too large.
+    const unsigned shift = __builtin_clzll(den.items[Impl::little(vn - 1)]);
+    uint64_t v[N] = {};
+    uint64_t u[N + 1] = {};
+    for (unsigned i = 0; i < vn; ++i)
+    {
+        const uint64_t lower = i > 0 && shift ? den.items[Impl::little(i - 1)] >> (64 - shift) : 0;
+        v[i] = (den.items[Impl::little(i)] << shift) | lower;
+    }
+    for (unsigned i = 0; i < un; ++i)
+    {
+        const uint64_t lower = i > 0 && shift ? num.items[Impl::little(i - 1)] >> (64 - shift) : 0;
+        u[i] = (num.items[Impl::little(i)] << shift) | lower;
+    }
+    u[un] = shift ? num.items[Impl::little(un - 1)] >> (64 - shift) : 0;
+
+    UInt quotient{};
+    for (unsigned j = un - vn + 1; j-- > 0;)
+    {
+        const unsigned __int128 top = (static_cast<unsigned __int128>(u[j + vn]) << 64) | u[j + vn - 1];
+        unsigned __int128 qhat = top / v[vn - 1];
+        unsigned __int128 rhat = top % v[vn - 1];
+        while (qhat >> 64 || qhat * v[vn - 2] > ((rhat << 64) | u[j + vn - 2]))
+        {
+            --qhat;
+            rhat += v[vn - 1];
+            if (rhat >> 64)
+                break;
+        }
+
+        /// u[j .. j + vn] -= qhat * v
+        unsigned __int128 carry = 0;
+        uint64_t borrow = 0;
+        for (unsigned i = 0; i < vn; ++i)
+        {
+            carry += qhat * v[i];
+            const uint64_t product = static_cast<uint64_t>(carry);
+            carry >>= 64;
+            const uint64_t diff = u[i + j] - product;
+            const uint64_t next_borrow = (u[i + j] < product) + (diff < borrow);
+            u[i + j] = diff - borrow;
+            borrow = next_borrow;
+        }
+        const uint64_t product = static_cast<uint64_t>(carry);
+        const bool negative = u[j + vn] < product + borrow || (product + borrow < product);
+        u[j + vn] -= product + borrow;
+
+        /// The estimate was one too large: add the divisor back.
+        if (negative)
+        {
+            --qhat;
+            unsigned __int128 sum = 0;
+            for (unsigned i = 0; i < vn; ++i)
+            {
+                sum += static_cast<unsigned __int128>(u[i + j]) + v[i];
+                u[i + j] = static_cast<uint64_t>(sum);
+                sum >>= 64;
+            }
+            u[j + vn] += static_cast<uint64_t>(sum);
+        }
+        quotient.items[Impl::little(j)] = static_cast<uint64_t>(qhat);
+    }
+    return quotient;
+}
+
+template <size_t Bits>
+constexpr bool fits_item(const integer<Bits, unsigned> & x) noexcept
+{
+    using Impl = typename integer<Bits, unsigned>::_impl;
+    for (unsigned i = 1; i < Impl::item_count; ++i)
+        if (x.items[Impl::little(i)])
+            return false;
+    return true;
+}
+
+/// u * a - v * b modulo 2^Bits, in a single pass over the items.
+template <size_t Bits>
+constexpr integer<Bits, unsigned> mul_sub(
+    const integer<Bits, unsigned> & u, uint64_t a, const integer<Bits, unsigned> & v, uint64_t b) noexcept
+{
+    using UInt = integer<Bits, unsigned>;
+    using Impl = typename UInt::_impl;
+    UInt res{};
+    unsigned __int128 carry_u = 0;
+    unsigned __int128 carry_v = 0;
+    uint64_t borrow = 0;
+    for (unsigned i = 0; i < Impl::item_count; ++i)
+    {
+        carry_u += static_cast<unsigned __int128>(u.items[Impl::little(i)]) * a;
+        carry_v += static_cast<unsigned __int128>(v.items[Impl::little(i)]) * b;
+        const uint64_t lhs = static_cast<uint64_t>(carry_u);
+        const uint64_t rhs = static_cast<uint64_t>(carry_v);
+        carry_u >>= 64;
+        carry_v >>= 64;
+        const uint64_t diff = lhs - rhs;
+        const uint64_t next_borrow = (lhs < rhs) + (diff < borrow);
+        res.items[Impl::little(i)] = diff - borrow;
+        borrow = next_borrow;
+    }
+    return res;
+}
+
+/// a * u + b * v for cofactors of opposite signs (or zero) whose combination is known to be non-negative.
+template <size_t Bits>
+constexpr integer<Bits, unsigned> combine(
+    int64_t a, const integer<Bits, unsigned> & u, int64_t b, const integer<Bits, unsigned> & v) noexcept
+{
+    if (a >= 0 && b <= 0)
+        return mul_sub(u, static_cast<uint64_t>(a), v, static_cast<uint64_t>(-b));
+    return mul_sub(v, static_cast<uint64_t>(b), u, static_cast<uint64_t>(-a));
+}
+
+/// Stein's algorithm on a single item, the tail of the wide loop.
+constexpr uint64_t binary_gcd(uint64_t a, uint64_t b) noexcept
+{
+    if (a == 0)
+        return b;
+    if (b == 0)
+        return a;
+    const int shift = __builtin_ctzll(a | b);
+    a >>= __builtin_ctzll(a);
+    while (b)
+    {
+        b >>= __builtin_ctzll(b);
+        if (a > b)
+        {
+            const uint64_t t = a;
+            a = b;
+            b = t;
+        }
+        b -= a;
+    }
+    return a << shift;
+}
+
+/// x / 2 mod m for odd m and x < m.
+template <size_t Bits>
+constexpr integer<Bits, unsigned> halve_mod(const integer<Bits, unsigned> & x, const integer<Bits, unsigned> & m) noexcept
+{
+    using UInt = integer<Bits, unsigned>;
+    using Impl = typename UInt::_impl;
+    if (!(x.items[Impl::little(0)] & 1))
+        return x >> 1;
+    UInt sum{};
+    const bool carry = Impl::add_carry(sum, x, m);
+    sum >>= 1;
+    sum.items[Impl::big(0)] |= static_cast<uint64_t>(carry) << 63;
+    return sum;
+}
+
+/// x - y mod m for x, y < m.
+template <size_t Bits>
+constexpr integer<Bits, unsigned> sub_mod(
+    const integer<Bits, unsigned> & x, const integer<Bits, unsigned> & y, const integer<Bits, unsigned> & m) noexcept
+{
+    using Impl = typename integer<Bits, unsigned>::_impl;
+    integer<Bits, unsigned> diff{};
+    if (Impl::sub_borrow(diff, x, y))
+        Impl::add_carry(diff, diff, m);
+    return diff;
+}
+
+/// Inverse of a modulo an odd m for 0 < a < m, by the binary extended Euclidean algorithm:
+/// the invariants a0 * x1 == u and a0 * x2 == v (mod m) hold throughout.
+template <size_t Bits>
+std::optional<integer<Bits, unsigned>> binary_modinv_odd(const integer<Bits, unsigned> & a, const integer<Bits, unsigned> & m)
+{
+    using UInt = integer<Bits, unsigned>;
+    UInt u = a;
+    UInt v = m;
+    UInt x1 = 1;
+    UInt x2 = 0;
+    while (u != 1 && v != 1)
+    {
+        if (u == 0 || v == 0)
+            return std::nullopt;
+        while (!(u.items[UInt::_impl::little(0)] & 1))
+        {
+            u >>= 1;
+            x1 = halve_mod(x1, m);
+        }
+        while (!(v.items[UInt::_impl::little(0)] & 1))
+        {
+            v >>= 1;
+            x2 = halve_mod(x2, m);
+        }
+        if (u >= v)
+        {
+            UInt::_impl::sub_borrow(u, u, v);
+            x1 = sub_mod(x1, x2, m);
+        }
+        else
+        {
+            UInt::_impl::sub_borrow(v, v, u);
+            x2 = sub_mod(x2, x1, m);
+        }
+    }
+    return u == 1 ? x1 : x2;
+}
+
+}
+
+/// pow10<Bits>[k] == 10^k for every power of ten that fits into integer<Bits, unsigned>, built at compile time.
+template <size_t Bits>
+inline constexpr auto pow10 = detail::make_pow10_table<Bits>();
+
+/// base^exp modulo 2^Bits.
+template <size_t Bits, typename Signed>
+constexpr integer<Bits, Signed> pow(integer<Bits, Signed> base, unsigned exp) noexcept
+{
+    integer<Bits, Signed> res = 1;
+    while (exp)
+    {
+        if (exp & 1)
+            res *= base;
+        exp >>= 1;
+        if (exp)
+            base *= base;
+    }
+    return res;
+}
+
+/// floor(log2(x)) for x > 0: the position of the highest set bit, found with `__builtin_clzll`
+/// on the most significant non-zero item.
+template <size_t Bits, typename Signed>
+constexpr unsigned ilog2(const integer<Bits, Signed> & x)
+{
+    if (integer<Bits, Signed>::_impl::is_negative(x) || x == 0)
+        throwError("ilog2: argument must be positive");
+    return static_cast<unsigned>(bit_width(integer<Bits, unsigned>(x))) - 1;
+}
+
+/// floor(log10(x)) for x > 0. The binary logarithm gives the answer up to one, a single comparison
+/// with a power of ten from a compile-time table settles it.
+template <size_t Bits, typename Signed>
+constexpr unsigned ilog10(const integer<Bits, Signed> & x)
+{
+    const unsigned log2 = ilog2(x);
+    const unsigned guess = static_cast<unsigned>(((log2 + 1) * detail::log10_2_fixed) >> 31);
+    return guess - (integer<Bits, unsigned>(x) < pow10<Bits>[guess]);
+}
+
+/// Number of decimal digits of |x|, 1 for zero. Branch-light: the bit width gives the count up to one
+/// and a single comparison with the table settles it.
+template <size_t Bits, typename Signed>
+constexpr unsigned digits10(const integer<Bits, Signed> & x) noexcept
+{
+    const integer<Bits, unsigned> n = detail::unsigned_magnitude(x);
+    const unsigned width = static_cast<unsigned>(bit_width(n));
+    const unsigned guess = static_cast<unsigned>((width * detail::log10_2_fixed) >> 31);
+    return guess + (n >= pow10<Bits>[guess]) + (width == 0);
+}
+
+/// Decimal representation of `x` in [first, last) with the contract of `std::to_chars`. The size is known up
+/// front from `digits10`, so the digits are written in place from the end, 19 digits per wide division.
+template <size_t Bits, typename Signed>
+std::to_chars_result to_chars(char * first, char * last, const integer<Bits, Signed> & x) noexcept
+{
+    using UInt = integer<Bits, unsigned>;
+    using Impl = typename UInt::_impl;
+    constexpr uint64_t chunk_divisor = 10000000000000000000ULL;
+    constexpr unsigned chunk_digits = 19;
+
+    const bool negative = integer<Bits, Signed>::_impl::is_negative(x);
+    const std::ptrdiff_t size = digits10(x) + negative;
+    if (last - first < size)
+        return {last, std::errc::value_too_large};
+
+    if (negative)
+        *first = '-';
+    char * pos = first + size;
+    UInt n = detail::unsigned_magnitude(x);
+    while (true)
+    {
+        bool fits_item = true;
+        for (unsigned i = 1; i < Impl::item_count; ++i)
+            fits_item = fits_item && n.items[Impl::little(i)] == 0;
+        if (fits_item)
+            break;
+
+        uint64_t chunk = Impl::div_mod_small(n, chunk_divisor);
+        for (unsigned i = 0; i < chunk_digits; ++i)
+        {
+            *--pos = static_cast<char>('0' + chunk % 10);
+            chunk /= 10;
+        }
+    }
+
+    uint64_t low = n.items[Impl::little(0)];
+    do
+    {
+        *--pos = static_cast<char>('0' + low % 10);
+        low /= 10;
+    } while (low);
+    return {first + size, std::errc{}};
+}
+
+/// floor(sqrt(x)) for x >= 0.
+template <size_t Bits, typename Signed>
+integer<Bits, Signed> isqrt(const integer<Bits, Signed> & x)
+{
+    using UInt = integer<Bits, unsigned>;
+    if (integer<Bits, Signed>::_impl::is_negative(x))
+        throwError("isqrt: argument must not be negative");
+
+    const UInt n(x);
+    if (n < 2)
+        return x;
+
+    /// The seed carries the ~53 significant bits that survive the round trip through double (the widest
+    /// floating type `integer` is constructible from), so only a few divisions follow. Past the range of
+    /// double it is 2^ceil(width / 2), which is at or above the root. One step from any positive value lands
+    /// at or above the root, from there the iteration decreases until it stops at the root.
+    const double estimate = static_cast<double>(std::sqrt(static_cast<long double>(n)));
+    UInt y = std::isfinite(estimate) && estimate >= 1 ? UInt(estimate) : UInt(1) << static_cast<int>((bit_width(n) + 1) / 2);
+    y = (y + detail::long_divide(n, y)) >> 1;
+    while (true)
+    {
+        const UInt next = (y + detail::long_divide(n, y)) >> 1;
+        if (next >= y)
+            break;
+        y = next;
+    }
+    return integer<Bits, Signed>(y);
+}
+
+/// floor(cbrt(x)) for x >= 0 and -floor(cbrt(-x)) for x < 0.
+template <size_t Bits, typename Signed>
+integer<Bits, Signed> icbrt(const integer<Bits, Signed> & x)
+{
+    using UInt = integer<Bits, unsigned>;
+    const bool negative = integer<Bits, Signed>::_impl::is_negative(x);
+    const UInt n = detail::unsigned_magnitude(x);
+    if (n < 2)
+        return x;
+
+    /// Same scheme as isqrt with y' = (2y + x / y^2) / 3, seeded with 2^ceil(width / 3) past double.
+    const double estimate = static_cast<double>(std::cbrt(static_cast<long double>(n)));
+    UInt y = std::isfinite(estimate) && estimate >= 1 ? UInt(estimate) : UInt(1) << static_cast<int>((bit_width(n) + 2) / 3);
+    y = (y + y + detail::long_divide(detail::long_divide(n, y), y)) / 3;
+    while (true)
+    {
+        const UInt next = (y + y + detail::long_divide(detail::long_divide(n, y), y)) / 3;
+        if (next >= y)
+            break;
+        y = next;
+    }
+
+    const integer<Bits, Signed> res(y);
+    return negative ? -res : res;
+}
+
+/// Greatest common divisor of |a| and |b| by Lehmer's algorithm (Knuth, TAOCP vol. 2, 4.5.2, algorithm L):
+/// the Euclidean steps are simulated on the leading 62 bits of both operands with single-item cofactors for as
+/// long as the quotients are certain, then applied to the full values at once. Once both operands fit into an
+/// item the rest is Stein's binary algorithm. gcd(0, 0) == 0; for signed types the result wraps if it is
+/// 2^(Bits - 1).
+template <size_t Bits, typename Signed>
+integer<Bits, Signed> gcd(const integer<Bits, Signed> & a, const integer<Bits, Signed> & b) noexcept
+{
+    using UInt = integer<Bits, unsigned>;
+    using Impl = typename UInt::_impl;
+    constexpr unsigned window = 62;
+
+    UInt u = detail::unsigned_magnitude(a);
+    UInt v = detail::unsigned_magnitude(b);
+    if (u < v)
+        std::swap(u, v);
+
+    while (v != 0)
+    {
+        if (detail::fits_item(v))
+        {
+            const uint64_t divisor = v.items[Impl::little(0)];
+            const uint64_t rem = Impl::div_mod_small(u, divisor);
+            return integer<Bits, Signed>(detail::binary_gcd(divisor, rem));
+        }
+
+        /// v does not fit into an item, so neither does u and the window is full.
+        const unsigned shift = static_cast<unsigned>(bit_width(u)) - window;
+        int64_t x = static_cast<int64_t>((u >> int(shift)).items[Impl::little(0)]);
+        int64_t y = static_cast<int64_t>((v >> int(shift)).items[Impl::little(0)]);
+        int64_t ca = 1;
+        int64_t cb = 0;
+        int64_t cc = 0;
+        int64_t cd = 1;
+        while (y + cc > 0 && y + cd > 0)
+        {
+            /// The quotient of the true values lies between these two; stop when they disagree.
+            const int64_t q = (x + ca) / (y + cc);
+            if (q != (x + cb) / (y + cd))
+                break;
+            int64_t t = ca - q * cc;
+            ca = cc;
+            cc = t;
+            t = cb - q * cd;
+            cb = cd;
+            cd = t;
+            t = x - q * y;
+            x = y;
+            y = t;
+        }
+
+        if (cb == 0)
+        {
+            /// Not even one quotient was certain: a full division step.
+            UInt rem = u - detail::long_divide(u, v) * v;
+            u = v;
+            v = rem;
+        }
+        else
+        {
+            const UInt next_u = detail::combine(ca, u, cb, v);
+            v = detail::combine(cc, u, cd, v);
+            u = next_u;
+        }
+    }
+    return integer<Bits, Signed>(u);
+}
+
+/// Least common multiple of |a| and |b|, 0 if either is 0. Wraps if the result does not fit.
+template <size_t Bits, typename Signed>
+integer<Bits, Signed> lcm(const integer<Bits, Signed> & a, const integer<Bits, Signed> & b) noexcept
+{
+    using UInt = integer<Bits, unsigned>;
+    const UInt x = detail::unsigned_magnitude(a);
+    const UInt y = detail::unsigned_magnitude(b);
+    if (x == 0 || y == 0)
+        return 0;
+    return integer<Bits, Signed>(detail::long_divide(x, gcd(x, y)) * y);
+}
+
+/// The inverse of a modulo m, i.e. x < m with a * x == 1 (mod m), or nullopt when gcd(a, m) != 1.
+/// Odd moduli use the binary extended Euclidean algorithm directly. For an even m, a must be odd and the
+/// inverse follows from that of m modulo a: x = (1 + m * (a - (m^-1 mod a))) / a.
+template <size_t Bits>
+std::optional<integer<Bits, unsigned>> modinv(const integer<Bits, unsigned> & a, const integer<Bits, unsigned> & m)
+{
+    using UInt = integer<Bits, unsigned>;
+    using Wide = integer<Bits * 2, unsigned>;
+    if (m <= 1)
+        throwError("modinv: modulus must be greater than 1");
+
+    const UInt r = a < m ? a : a - detail::long_divide(a, m) * m;
+    if (r == 0)
+        return std::nullopt;
+    if (r == 1)
+        return r;
+    if (m.items[UInt::_impl::little(0)] & 1)
+        return detail::binary_modinv_odd(r, m);
+    if (!(r.items[UInt::_impl::little(0)] & 1))
+        return std::nullopt;
+
+    const auto m_inv = detail::binary_modinv_odd(m - detail::long_divide(m, r) * r, r);
+    if (!m_inv)
+        return std::nullopt;
+    const Wide numerator = mul_wide(m, r - *m_inv) + Wide(1);
+    return UInt(detail::long_divide(numerator, Wide(r)));
+}
+
+}
@@ -0,0 +1,591 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <charconv>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <system_error>
+#include <thread>
+#include <type_traits>
+#include <vector>
+#include "numeric.h"
+
+/// Subquadratic multiplication and decimal conversion for very wide integers (thousands of bits and
+/// up), optionally spread over a thread pool.
+///
+/// mul_wide(x, y, pool)          - Karatsuba product on the items, above 32 items per operand.
+/// to_chars(first, last, x, pool),
+/// to_string(x, pool)            - divide-and-conquer conversion by 10^(19 * 2^k).
+///
+/// Both recurse on halves of the operands and, above 128 items, hand one of the halves to the pool.
+/// Where the work is split depends only on the operand sizes, never on the number of threads or on
+/// timing, and each half writes its own part of the result, so the output is the same for every
+/// pool size; a pool of size 1 runs everything on the calling thread.
+
+namespace wide
+{
+
+/// A fork-join pool with one task deque per thread. A thread pushes the tasks it forks to the back
+/// of its own deque and takes them back from there; idle threads steal from the front of the others.
+/// Threads that wait for a stolen task run other tasks meanwhile, so nested forks cannot deadlock.
+class thread_pool
+{
+public:
+    /// `threads` counts the calling thread, so thread_pool(1) starts no threads at all.
+    explicit thread_pool(size_t threads = std::thread::hardware_concurrency()) : queues(std::max<size_t>(threads, 1))
+    {
+        workers.reserve(queues.size() - 1);
+        for (size_t i = 1; i < queues.size(); ++i)
+            workers.emplace_back([this, i] { work(i); });
+    }
+
+    thread_pool(const thread_pool &) = delete;
+    thread_pool & operator=(const thread_pool &) = delete;
+
+    ~thread_pool()
+    {
+        {
+            std::lock_guard<std::mutex> lock(sleep_mutex);
+            stopping = true;
+        }
+        wake.notify_all();
+        for (auto & worker : workers)
+            worker.join();
+    }
+
+    size_t size() const noexcept { return queues.size(); }
+
+    /// Runs f() and g(), possibly in parallel, and returns when both have finished. Neither may throw.
+    template <typename F, typename G>
+    void invoke(F && f, G && g)
+    {
+        if (queues.size() == 1)
+        {
+            f();
+            g();
+            return;
+        }
+
+        closure<G> forked(g);
+        const size_t self = queue_index();
+        push(self, forked);
+        f();
+        if (!take_back(self, forked))
+            wait(self, forked);
+    }
+
+private:
+    struct task
+    {
+        void (*run)(task &) noexcept;
+        std::atomic<bool> done{false};
+    };
+
+    template <typename F>
+    struct closure : task
+    {
+        explicit closure(F & f_) : f(f_) { this->run = &call; }
+
+        static void call(task & self) noexcept { static_cast<closure &>(self).f(); }
+
+        F & f;
+    };
+
+    struct alignas(64) queue
+    {
+        std::mutex mutex;
+        std::deque<task *> tasks;
+    };
+
+    /// Workers own queues 1 ... size() - 1; threads outside the pool share queue 0.
+    size_t queue_index() const noexcept { return current_pool() == this ? current_queue() : 0; }
+
+    static const thread_pool *& current_pool() noexcept
+    {
+        thread_local const thread_pool * pool = nullptr;
+        return pool;
+    }
+
+    static size_t & current_queue() noexcept
+    {
+        thread_local size_t index = 0;
+        return index;
+    }
+
+    void push(size_t index, task & t)
+    {
+        {
+            std::lock_guard<std::mutex> lock(queues[index].mutex);
+            queues[index].tasks.push_back(&t);
+        }
+        pending.fetch_add(1, std::memory_order_release);
+        {
+            std::lock_guard<std::mutex> lock(sleep_mutex);
+        }
+        wake.notify_one();
+    }
+
+    bool take_back(size_t index, task & t)
+    {
+        {
+            std::lock_guard<std::mutex> lock(queues[index].mutex);
+            auto & tasks = queues[index].tasks;
+            if (tasks.empty() || tasks.back() != &t)
+                return false;
+            tasks.pop_back();
+        }
+        pending.fetch_sub(1, std::memory_order_relaxed);
+        t.run(t);
+        return true;
+    }
+
+    /// The newest task of our own queue, else the oldest of the next non-empty one.
+    task * take(size_t index)
+    {
+        for (size_t i = 0; i < queues.size(); ++i)
+        {
+            queue & q = queues[(index + i) % queues.size()];
+            std::lock_guard<std::mutex> lock(q.mutex);
+            if (q.tasks.empty())
+                continue;
+            task * t;
+            if (i == 0)
+            {
+                t = q.tasks.back();
+                q.tasks.pop_back();
+            }
+            else
+            {
+                t = q.tasks.front();
+                q.tasks.pop_front();
+            }
+            pending.fetch_sub(1, std::memory_order_relaxed);
+            return t;
+        }
+        return nullptr;
+    }
+
+    static void execute(task & t) noexcept
+    {
+        t.run(t);
+        /// The owner may destroy the task as soon as it sees this store.
+        t.done.store(true, std::memory_order_release);
+    }
+
+    void wait(size_t index, const task & t)
+    {
+        while (!t.done.load(std::memory_order_acquire))
+        {
+            if (task * other = take(index))
+                execute(*other);
+            else
+                std::this_thread::yield();
+        }
+    }
+
+    void work(size_t index)
+    {
+        current_pool() = this;
+        current_queue() = index;
+        while (true)
+        {
+            if (task * t = take(index))
+            {
+                execute(*t);
+                continue;
+            }
+            std::unique_lock<std::mutex> lock(sleep_mutex);
+            wake.wait_for(lock, std::chrono::milliseconds(100), [this] { return stopping || pending.load(std::memory_order_acquire) > 0; });
+            if (stopping)
+                return;
+        }
+    }
+
+    std::vector<queue> queues;
+    std::vector<std::thread> workers;
+    std::atomic<size_t> pending{0};
+    std::mutex sleep_mutex;
+    std::condition_variable wake;
+    bool stopping = false;
+};
+
+namespace detail
+{
+
+/// Operands shorter than this many items are multiplied by the schoolbook method.
+inline constexpr size_t karatsuba_threshold = 32;
+/// Subproblems of at least this many items are offered to the pool.
+inline constexpr size_t parallel_threshold = 128;
+/// Numbers of at most this many items are converted to decimal by repeated division by 10^19.
+inline constexpr size_t conversion_threshold = 24;
+
+inline constexpr uint64_t chunk_divisor = 10000000000000000000ULL;
+inline constexpr size_t chunk_digits = 19;
+
+inline size_t significant_limbs(const uint64_t * x, size_t n) noexcept
+{
+    while (n && !x[n - 1])
+        --n;
+    return n;
+}
+
+/// Runs f and g, in parallel when a pool is given and the subproblem is large enough.
+template <typename F, typename G>
+void fork(thread_pool * pool, size_t size, F && f, G && g)
+{
+    if (pool && size >= parallel_threshold)
+        pool->invoke(f, g);
+    else
+    {
+        f();
+        g();
+    }
+}
+
+/// r[0, rn) += a[0, an) with rn >= an; the sum must fit into rn items.
+inline void add_limbs(uint64_t * r, size_t rn, const uint64_t * a, size_t an) noexcept
+{
+    bool carry = false;
+    size_t i = 0;
+    for (; i < an; ++i)
+    {
+        const uint64_t sum = r[i] + a[i];
+        const uint64_t res = sum + carry;
+        carry = sum < a[i] || res < sum;
+        r[i] = res;
+    }
+    for (; carry && i < rn; ++i)
+        carry = ++r[i] == 0;
+}
+
+/// r[0, rn) -= a[0, an) with rn >= an; the difference must not be negative.
+inline void sub_limbs(uint64_t * r, size_t rn, const uint64_t * a, size_t an) noexcept
+{
+    bool borrow = false;
+    size_t i = 0;
+    for (; i < an; ++i)
+    {
+        const uint64_t diff = r[i] - a[i];
+        const bool underflow = r[i] < a[i];
+        r[i] = diff - borrow;
+        borrow = underflow || diff < static_cast<uint64_t>(borrow);
+    }
+    for (; borrow && i < rn; ++i)
+        borrow = r[i]-- == 0;
+}
+
+/// r[0, an + bn) = a * b, the schoolbook way; r must not overlap the operands.
+inline void mul_basecase(const uint64_t * a, size_t an, const uint64_t * b, size_t bn, uint64_t * r) noexcept
+{
+    std::fill(r, r + an + bn, 0);
+    for (size_t i = 0; i < an; ++i)
+    {
+        if (!a[i])
+            continue;
+        unsigned __int128 carry = 0;
+        for (size_t j = 0; j < bn; ++j)
+        {
+            const unsigned __int128 cur = static_cast<unsigned __int128>(a[i]) * b[j] + r[i + j] + carry;
+            r[i + j] = static_cast<uint64_t>(cur);
+            carry = cur >> 64;
+        }
+        r[i + bn] = static_cast<uint64_t>(carry);
+    }
+}
+
+/// d[0, m) = |x[0, m) - y[0, h)| for h <= m; returns whether x < y.
+inline bool abs_diff(uint64_t * d, const uint64_t * x, size_t m, const uint64_t * y, size_t h) noexcept
+{
+    bool less = false;
+    if (significant_limbs(x + h, m - h) == 0)
+    {
+        size_t i = h;
+        while (i && x[i - 1] == y[i - 1])
+            --i;
+        less = i && x[i - 1] < y[i - 1];
+    }
+    if (less)
+    {
+        std::copy(y, y + h, d);
+        std::fill(d + h, d + m, 0);
+        sub_limbs(d, m, x, h);
+    }
+    else
+    {
+        std::copy(x, x + m, d);
+        sub_limbs(d, m, y, h);
+    }
+    return less;
+}
+
+/// r[0, 2n) = a[0, n) * b[0, n). With a = a1 * B^h + a0 and b = b1 * B^h + b0, the middle term
+/// a0 * b1 + a1 * b0 is a0 * b0 + a1 * b1 - (a1 - a0) * (b1 - b0), so three half-size products suffice.
+inline void mul_karatsuba(const uint64_t * a, const uint64_t * b, size_t n, uint64_t * r, thread_pool * pool)
+{
+    if (n < karatsuba_threshold)
+    {
+        mul_basecase(a, n, b, n, r);
+        return;
+    }
+
+    const size_t h = n / 2;
+    const size_t m = n - h;
+    std::vector<uint64_t> buffer(6 * m + 1);
+    uint64_t * da = buffer.data();
+    uint64_t * db = da + m;
+    uint64_t * z1 = db + m;
+    uint64_t * middle = z1 + 2 * m;
+    const bool negative = abs_diff(da, a + h, m, a, h) != abs_diff(db, b + h, m, b, h);
+
+    fork(
+        pool,
+        n,
+        [&] { mul_karatsuba(a, b, h, r, pool); },
+        [&] {
+            fork(
+                pool, n, [&] { mul_karatsuba(a + h, b + h, m, r + 2 * h, pool); }, [&] { mul_karatsuba(da, db, m, z1, pool); });
+        });
+
+    std::copy(r + 2 * h, r + 2 * n, middle);
+    middle[2 * m] = 0;
+    add_limbs(middle, 2 * m + 1, r, 2 * h);
+    if (negative)
+        add_limbs(middle, 2 * m + 1, z1, 2 * m);
+    else
+        sub_limbs(middle, 2 * m + 1, z1, 2 * m);
+    add_limbs(r + h, 2 * n - h, middle, 2 * m + 1);
+}
+
+/// r[0, an + bn) = a * b for operands of any length. An operand much longer than the other is cut
+/// into pieces of the shorter length, so that every Karatsuba product is balanced.
+inline void mul_limbs(const uint64_t * a, size_t an, const uint64_t * b, size_t bn, uint64_t * r, thread_pool * pool)
+{
+    if (an < bn)
+    {
+        std::swap(a, b);
+        std::swap(an, bn);
+    }
+    if (bn < karatsuba_threshold)
+    {
+        mul_basecase(a, an, b, bn, r);
+        return;
+    }
+    if (an == bn)
+    {
+        mul_karatsuba(a, b, an, r, pool);
+        return;
+    }
+
+    std::fill(r, r + an + bn, 0);
+    std::vector<uint64_t> piece(2 * bn);
+    for (size_t offset = 0; offset < an; offset += bn)
+    {
+        const size_t length = std::min(bn, an - offset);
+        mul_limbs(a + offset, length, b, bn, piece.data(), pool);
+        add_limbs(r + offset, an + bn - offset, piece.data(), length + bn);
+    }
+}
+
+/// x[0, n) /= d; returns the remainder.
+inline uint64_t div_small_limbs(uint64_t * x, size_t n, uint64_t d) noexcept
+{
+    unsigned __int128 rem = 0;
+    for (size_t i = n; i--;)
+    {
+        const unsigned __int128 cur = (rem << 64) | x[i];
+        x[i] = static_cast<uint64_t>(cur / d);
+        rem = cur % d;
+    }
+    return static_cast<uint64_t>(rem);
+}
+
+/// q[0, m - n + 1) = u / v and r[0, n) = u % v for m >= n >= 2 and v[n - 1] != 0, by Knuth's
+/// algorithm D: one estimate of each quotient item from the top items, corrected at most twice.
+inline void divmod_limbs(const uint64_t * u, size_t m, const uint64_t * v, size_t n, uint64_t * q, uint64_t * r)
+{
+    const unsigned shift = static_cast<unsigned>(__builtin_clzll(v[n - 1]));
+    std::vector<uint64_t> buffer(m + 1 + n);
+    uint64_t * un = buffer.data();
+    uint64_t * vn = un + m + 1;
+    for (size_t i = n; i--;)
+        vn[i] = (v[i] << shift) | (shift && i ? v[i - 1] >> (64 - shift) : 0);
+    un[m] = shift ? u[m - 1] >> (64 - shift) : 0;
+    for (size_t i = m; i--;)
+        un[i] = (u[i] << shift) | (shift && i ? u[i - 1] >> (64 - shift) : 0);
+
+    const unsigned __int128 base = static_cast<unsigned __int128>(1) << 64;
+    for (size_t j = m - n + 1; j--;)
+    {
+        const unsigned __int128 top = (static_cast<unsigned __int128>(un[j + n]) << 64) | un[j + n - 1];
+        unsigned __int128 qhat = top / vn[n - 1];
+        unsigned __int128 rhat = top % vn[n - 1];
+        while (qhat >= base || qhat * vn[n - 2] > ((rhat << 64) | un[j + n - 2]))
+        {
+            --qhat;
+            rhat += vn[n - 1];
+            if (rhat >= base)
+                break;
+        }
+
+        uint64_t product_carry = 0;
+        bool borrow = false;
+        for (size_t i = 0; i < n; ++i)
+        {
+            const unsigned __int128 p = static_cast<unsigned __int128>(static_cast<uint64_t>(qhat)) * vn[i] + product_carry;
+            product_carry = static_cast<uint64_t>(p >> 64);
+            const uint64_t low = static_cast<uint64_t>(p);
+            const uint64_t diff = un[i + j] - low;
+            const bool underflow = un[i + j] < low;
+            un[i + j] = diff - borrow;
+            borrow = underflow || diff < static_cast<uint64_t>(borrow);
+        }
+        const uint64_t diff = un[j + n] - product_carry;
+        const bool underflow = un[j + n] < product_carry;
+        un[j + n] = diff - borrow;
+        borrow = underflow || diff < static_cast<uint64_t>(borrow);
+
+        /// The estimate was one too large: add the divisor back.
+        if (borrow)
+        {
+            --qhat;
+            add_limbs(un + j, n + 1, vn, n);
+        }
+        q[j] = static_cast<uint64_t>(qhat);
+    }
+
+    for (size_t i = 0; i < n; ++i)
+        r[i] = (un[i] >> shift) | (shift ? un[i + 1] << (64 - shift) : 0);
+}
+
+/// powers[k] == 10^(19 * 2^k) without leading zero items, up to the largest power below 10^width.
+inline std::vector<std::vector<uint64_t>> decimal_powers(size_t width, thread_pool * pool)
+{
+    std::vector<std::vector<uint64_t>> powers{{chunk_divisor}};
+    while ((chunk_digits << powers.size()) < width)
+    {
+        const std::vector<uint64_t> & last = powers.back();
+        std::vector<uint64_t> square(2 * last.size());
+        mul_limbs(last.data(), last.size(), last.data(), last.size(), square.data(), pool);
+        square.resize(significant_limbs(square.data(), square.size()));
+        powers.push_back(std::move(square));
+    }
+    return powers;
+}
+
+/// Writes x[0, n) < 10^width as exactly `width` digits, with leading zeros. Splits x by the largest
+/// power 10^(19 * 2^k) below 10^width into a high and a low part that are converted independently.
+inline void to_decimal(
+    const uint64_t * x, size_t n, char * out, size_t width, const std::vector<std::vector<uint64_t>> & powers, thread_pool * pool)
+{
+    n = significant_limbs(x, n);
+    if (n <= conversion_threshold || width <= chunk_digits)
+    {
+        std::vector<uint64_t> rest(x, x + n);
+        char * pos = out + width;
+        while (n)
+        {
+            uint64_t chunk = div_small_limbs(rest.data(), n, chunk_divisor);
+            n = significant_limbs(rest.data(), n);
+            for (size_t i = 0; i < chunk_digits && pos != out; ++i)
+            {
+                *--pos = static_cast<char>('0' + chunk % 10);
+                chunk /= 10;
+            }
+        }
+        std::fill(out, pos, '0');
+        return;
+    }
+
+    size_t k = 0;
+    while ((chunk_digits << (k + 1)) < width)
+        ++k;
+    const size_t low_width = chunk_digits << k;
+    const std::vector<uint64_t> & divisor = powers[k];
+    if (n < divisor.size())
+    {
+        std::fill(out, out + width - low_width, '0');
+        to_decimal(x, n, out + width - low_width, low_width, powers, pool);
+        return;
+    }
+
+    std::vector<uint64_t> high(n - divisor.size() + 1);
+    std::vector<uint64_t> low(divisor.size());
+    if (divisor.size() == 1)
+    {
+        std::copy(x, x + n, high.begin());
+        low[0] = div_small_limbs(high.data(), n, divisor[0]);
+    }
+    else
+        divmod_limbs(x, n, divisor.data(), divisor.size(), high.data(), low.data());
+
+    fork(
+        pool,
+        n,
+        [&] { to_decimal(high.data(), high.size(), out, width - low_width, powers, pool); },
+        [&] { to_decimal(low.data(), low.size(), out + width - low_width, low_width, powers, pool); });
+}
+
+}
+
+/// Widening multiplication by Karatsuba's method, with the recursion spread over `pool`. Equal to
+/// mul_wide(lhs, rhs) and faster from about 4096 bits on, even with a pool of size 1.
+template <size_t Bits, typename Signed>
+integer<Bits * 2, Signed> mul_wide(const integer<Bits, Signed> & lhs, const integer<Bits, Signed> & rhs, thread_pool & pool)
+{
+    using UInt = integer<Bits, unsigned>;
+    const UInt a = detail::unsigned_magnitude(lhs);
+    const UInt b = detail::unsigned_magnitude(rhs);
+    const limb_span<const uint64_t> a_limbs = limbs(a);
+    const limb_span<const uint64_t> b_limbs = limbs(b);
+    const size_t an = detail::significant_limbs(a_limbs.data(), a_limbs.size());
+    const size_t bn = detail::significant_limbs(b_limbs.data(), b_limbs.size());
+
+    integer<Bits * 2, Signed> res = 0;
+    if (an && bn)
+        detail::mul_limbs(a_limbs.data(), an, b_limbs.data(), bn, limbs(res).data(), pool.size() > 1 ? &pool : nullptr);
+    if constexpr (std::is_same_v<Signed, signed>)
+    {
+        if (integer<Bits, Signed>::_impl::is_negative(lhs) != integer<Bits, Signed>::_impl::is_negative(rhs))
+            res = -res;
+    }
+    return res;
+}
+
+/// Decimal representation by divide and conquer, with the halves spread over `pool`. Unlike
+/// to_string(x) and to_chars(first, last, x) it needs no pow10<Bits> table, so it works for any width.
+template <size_t Bits, typename Signed>
+std::string to_string(const integer<Bits, Signed> & x, thread_pool & pool)
+{
+    thread_pool * workers = pool.size() > 1 ? &pool : nullptr;
+    const integer<Bits, unsigned> n = detail::unsigned_magnitude(x);
+    const limb_span<const uint64_t> n_limbs = limbs(n);
+
+    /// Two digits more than floor(bit_width * log10(2)) always suffice; the leading zeros are
+    /// dropped afterwards.
+    const size_t width = ((static_cast<uint64_t>(bit_width(n)) * detail::log10_2_fixed) >> 31) + 2;
+    std::string res(width, '0');
+    detail::to_decimal(n_limbs.data(), n_limbs.size(), res.data(), width, detail::decimal_powers(width, workers), workers);
+    res.erase(0, std::min(res.find_first_not_of('0'), width - 1));
+    if (integer<Bits, Signed>::_impl::is_negative(x))
+        res.insert(res.begin(), '-');
+    return res;
+}
+
+/// to_chars(first, last, x) with the digits of to_string(x, pool).
+template <size_t Bits, typename Signed>
+std::to_chars_result to_chars(char * first, char * last, const integer<Bits, Signed> & x, thread_pool & pool)
+{
+    const std::string digits = to_string(x, pool);
+    if (last - first < static_cast<std::ptrdiff_t>(digits.size()))
+        return {last, std::errc::value_too_large};
+    return {std::copy(digits.begin(), digits.end(), first), std::errc{}};
+}
+
+}
@@ -0,0 +1,301 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include "bits.h"
+
+/// Variable-length encodings for values that are mostly small: LEB128 (7 bits per byte with a
+/// continuation bit) and a prefix scheme whose first byte holds either the value itself or the
+/// number of little-endian bytes that follow. Signed integers are mapped through zigzag first, so
+/// small negative values stay short.
+
+namespace wide
+{
+
+enum class varint_format
+{
+    leb128,
+    prefix,
+};
+
+/// The longest encoding of a Bits-bit value.
+template <size_t Bits, varint_format Format = varint_format::prefix>
+inline constexpr size_t varint_max_length = Format == varint_format::leb128 ? (Bits + 6) / 7 : Bits / 8 + 1;
+
+/// The room an encoder needs: it stores whole 8-byte words and may write past the encoded length,
+/// but never past this bound.
+template <size_t Bits, varint_format Format = varint_format::prefix>
+inline constexpr size_t varint_max_size = Format == varint_format::leb128 ? (varint_max_length<Bits, Format> + 7) / 8 * 8 : Bits / 8 + 1;
+
+/// Interleaves negative and non-negative values: 0, -1, 1, -2, ... map to 0, 1, 2, 3, ...
+template <size_t Bits>
+constexpr integer<Bits, unsigned> zigzag_encode(const integer<Bits, signed> & x) noexcept
+{
+    using Impl = typename integer<Bits, signed>::_impl;
+    const integer<Bits, unsigned> sign
+        = Impl::is_negative(x) ? std::numeric_limits<integer<Bits, unsigned>>::max() : integer<Bits, unsigned>(0);
+    return shl<1>(integer<Bits, unsigned>(x)) ^ sign;
+}
+
+template <size_t Bits>
+constexpr integer<Bits, signed> zigzag_decode(const integer<Bits, unsigned> & x) noexcept
+{
+    using Impl = typename integer<Bits, unsigned>::_impl;
+    const integer<Bits, unsigned> sign
+        = (x.items[Impl::little(0)] & 1) ? std::numeric_limits<integer<Bits, unsigned>>::max() : integer<Bits, unsigned>(0);
+    return integer<Bits, signed>(shr<1>(x) ^ sign);
+}
+
+namespace detail
+{
+
+inline uint64_t load_le64(const uint8_t * in) noexcept
+{
+    uint64_t word;
+    std::memcpy(&word, in, sizeof(word));
+    if constexpr (std::endian::native != std::endian::little)
+        word = __builtin_bswap64(word);
+    return word;
+}
+
+inline void store_le64(uint8_t * out, uint64_t word) noexcept
+{
+    if constexpr (std::endian::native != std::endian::little)
+        word = __builtin_bswap64(word);
+    std::memcpy(out, &word, sizeof(word));
+}
+
+/// 56 bits to eight 7-bit groups, one per byte, and back: three shift-and-mask steps each.
+constexpr uint64_t leb128_spread(uint64_t v) noexcept
+{
+    v = ((v & 0x00FFFFFFF0000000ULL) << 4) | (v & 0x000000000FFFFFFFULL);
+    v = ((v & 0x0FFFC0000FFFC000ULL) << 2) | (v & 0x00003FFF00003FFFULL);
+    v = ((v & 0x3F803F803F803F80ULL) << 1) | (v & 0x007F007F007F007FULL);
+    return v;
+}
+
+constexpr uint64_t leb128_compact(uint64_t v) noexcept
+{
+    v &= 0x7F7F7F7F7F7F7F7FULL;
+    v = ((v & 0x7F007F007F007F00ULL) >> 1) | (v & 0x007F007F007F007FULL);
+    v = ((v & 0x3FFF00003FFF0000ULL) >> 2) | (v & 0x00003FFF00003FFFULL);
+    v = ((v & 0x0FFFFFFF00000000ULL) >> 4) | (v & 0x000000000FFFFFFFULL);
+    return v;
+}
+
+template <size_t Bits>
+size_t leb128_encode(const integer<Bits, unsigned> & x, uint8_t * out) noexcept
+{
+    const unsigned width = bit_width(x);
+    const size_t size = width ? (width + 6) / 7 : 1;
+
+    unsigned offset = 0;
+    for (size_t pos = 0; pos < size; pos += 8, offset += 56)
+    {
+        const size_t bytes = size - pos < 8 ? size - pos : 8;
+        /// Continuation bits on all bytes but the very last one; bytes past it are scratch.
+        uint64_t continuation = 0x8080808080808080ULL;
+        if (pos + bytes == size)
+            continuation &= ~(uint64_t(0x80) << (8 * (bytes - 1)));
+        store_le64(out + pos, leb128_spread(read_bits64(x, offset) & ((uint64_t(1) << 56) - 1)) | continuation);
+    }
+    return size;
+}
+
+/// Whole words of eight groups while there is room to load them; the terminating byte is the lowest
+/// one without the continuation bit.
+template <size_t Bits>
+size_t leb128_decode(const uint8_t * in, const uint8_t * end, integer<Bits, unsigned> & x) noexcept
+{
+    constexpr size_t max_size = varint_max_length<Bits, varint_format::leb128>;
+
+    x = 0;
+    size_t pos = 0;
+    unsigned offset = 0;
+    while (true)
+    {
+        const size_t left = static_cast<size_t>(end - in) - pos;
+        if (left == 0 || pos >= max_size)
+            return 0;
+
+        uint64_t word;
+        size_t bytes;
+        bool last;
+        if (left >= 8)
+        {
+            word = load_le64(in + pos);
+            const uint64_t stops = ~word & 0x8080808080808080ULL;
+            last = stops != 0;
+            bytes = last ? static_cast<size_t>(__builtin_ctzll(stops)) / 8 + 1 : 8;
+        }
+        else
+        {
+            word = 0;
+            bytes = 0;
+            last = false;
+            while (bytes < left && !last)
+            {
+                word |= uint64_t(in[pos + bytes]) << (8 * bytes);
+                last = !(in[pos + bytes] & 0x80);
+                ++bytes;
+            }
+        }
+        if (pos + bytes > max_size)
+            return 0;
+        word &= ~uint64_t(0) >> (64 - 8 * bytes);
+
+        const uint64_t value = leb128_compact(word);
+        /// Groups past the top of the type must be zero.
+        if (offset + 7 * bytes > Bits && (offset >= Bits || (value >> (Bits - offset)) != 0))
+            return 0;
+        or_bits64(x, offset, value);
+
+        pos += bytes;
+        offset += 56;
+        if (last)
+            return pos;
+        if (bytes < 8)
+            return 0;
+    }
+}
+
+/// Values below `limit` take a single byte; above it the header is limit + (length - 1).
+template <size_t Bits>
+inline constexpr unsigned prefix_limit = 256 - Bits / 8;
+
+template <size_t Bits>
+size_t prefix_encode(const integer<Bits, unsigned> & x, uint8_t * out) noexcept
+{
+    using Impl = typename integer<Bits, unsigned>::_impl;
+    constexpr unsigned limit = prefix_limit<Bits>;
+
+    const unsigned width = bit_width(x);
+    if (width <= 8 && x.items[Impl::little(0)] < limit)
+    {
+        out[0] = static_cast<uint8_t>(x.items[Impl::little(0)]);
+        return 1;
+    }
+
+    /// At Bits == 2048 the limit is 0, so even zero takes a payload byte.
+    const size_t bytes = std::max<size_t>(1, (width + 7) / 8);
+    out[0] = static_cast<uint8_t>(limit + bytes - 1);
+    for (size_t pos = 0, i = 0; pos < bytes; pos += 8, ++i)
+        store_le64(out + 1 + pos, x.items[Impl::little(static_cast<unsigned>(i))]);
+    return bytes + 1;
+}
+
+template <size_t Bits>
+size_t prefix_decode(const uint8_t * in, const uint8_t * end, integer<Bits, unsigned> & x) noexcept
+{
+    using Impl = typename integer<Bits, unsigned>::_impl;
+    constexpr unsigned limit = prefix_limit<Bits>;
+
+    if (in == end)
+        return 0;
+    const unsigned header = in[0];
+    if (header < limit)
+    {
+        x = header;
+        return 1;
+    }
+
+    const size_t bytes = header - limit + 1;
+    if (static_cast<size_t>(end - in) < bytes + 1)
+        return 0;
+    if (static_cast<size_t>(end - in) >= Bits / 8 + 1)
+    {
+        /// Room for a full load: read all items and clear the bytes past the length.
+        x = load_le<integer<Bits, unsigned>>(in + 1);
+        for (unsigned i = 0; i < Impl::item_count; ++i)
+        {
+            const size_t low = size_t(8) * i;
+            if (bytes <= low)
+                x.items[Impl::little(i)] = 0;
+            else if (bytes < low + 8)
+                x.items[Impl::little(i)] &= (uint64_t(1) << (8 * (bytes - low))) - 1;
+        }
+    }
+    else
+    {
+        uint8_t buffer[Bits / 8] = {};
+        std::memcpy(buffer, in + 1, bytes);
+        x = load_le<integer<Bits, unsigned>>(buffer);
+    }
+    return bytes + 1;
+}
+
+}
+
+/// Returns the encoded length. `out` needs room for varint_max_size<Bits, Format> bytes; those past
+/// the encoded length may be overwritten.
+template <varint_format Format = varint_format::prefix, size_t Bits, typename Signed>
+size_t varint_encode(const integer<Bits, Signed> & x, uint8_t * out) noexcept
+{
+    static_assert(Bits <= 2048, "the prefix header has room for 256 bytes");
+    integer<Bits, unsigned> u;
+    if constexpr (std::is_same_v<Signed, signed>)
+        u = zigzag_encode(x);
+    else
+        u = x;
+
+    if constexpr (Format == varint_format::leb128)
+        return detail::leb128_encode(u, out);
+    else
+        return detail::prefix_encode(u, out);
+}
+
+/// Reads one value from [in, end) and returns the number of bytes consumed, or 0 if the input is
+/// truncated or the value does not fit in Bits.
+template <varint_format Format = varint_format::prefix, size_t Bits, typename Signed>
+size_t varint_decode(const uint8_t * in, const uint8_t * end, integer<Bits, Signed> & x) noexcept
+{
+    static_assert(Bits <= 2048, "the prefix header has room for 256 bytes");
+    integer<Bits, unsigned> u;
+    size_t size;
+    if constexpr (Format == varint_format::leb128)
+        size = detail::leb128_decode(in, end, u);
+    else
+        size = detail::prefix_decode(in, end, u);
+
+    if constexpr (std::is_same_v<Signed, signed>)
+        x = zigzag_decode(u);
+    else
+        x = u;
+    return size;
+}
+
+namespace batch
+{
+
+/// Encodes n values back to back into `out`, which needs room for n * varint_max_size bytes, and
+/// returns the encoded length.
+template <varint_format Format = varint_format::prefix, size_t Bits, typename Signed>
+size_t varint_encode(const integer<Bits, Signed> * in, uint8_t * out, size_t n) noexcept
+{
+    size_t pos = 0;
+    for (size_t i = 0; i < n; ++i)
+        pos += wide::varint_encode<Format>(in[i], out + pos);
+    return pos;
+}
+
+/// Decodes n values from [in, end) and returns the number of bytes consumed, or 0 if the input is
+/// malformed; `out` is then filled up to the bad value.
+template <varint_format Format = varint_format::prefix, size_t Bits, typename Signed>
+size_t varint_decode(const uint8_t * in, const uint8_t * end, integer<Bits, Signed> * out, size_t n) noexcept
+{
+    size_t pos = 0;
+    for (size_t i = 0; i < n; ++i)
+    {
+        const size_t size = wide::varint_decode<Format>(in + pos, end, out[i]);
+        if (size == 0)
+            return 0;
+        pos += size;
+    }
+    return pos;
+}
+
+}
+
+}
@@ -27,6 +27,7 @@
 #include <cfloat>
 #include <cmath>
 #include <cstdint>
+#include <cstring>
 #include <functional>
 #include <initializer_list>
 #include <limits>
@@ -229,14 +230,26 @@ constexpr integer<Bits, Signed> operator<<(const integer<Bits, Signed> & lhs, in
 template <size_t Bits, typename Signed>
 constexpr integer<Bits, Signed> operator>>(const integer<Bits, Signed> & lhs, int n) noexcept;
 
+/// Other shift count types are range-checked before narrowing, so that e.g. a size_t of 2^32 + 1
+/// does not wrap to a shift by one.
 template <size_t Bits, typename Signed, typename Int, std::enable_if_t<!std::is_same_v<Int, int>, int> = 0>
 constexpr integer<Bits, Signed> operator<<(const integer<Bits, Signed> & lhs, Int n) noexcept
 {
+    if constexpr (std::is_integral_v<Int> && sizeof(Int) >= sizeof(int))
+    {
+        if (static_cast<std::make_unsigned_t<Int>>(n) >= Bits)
+            return integer<Bits, Signed>(0);
+    }
     return lhs << int(n);
 }
 template <size_t Bits, typename Signed, typename Int, std::enable_if_t<!std::is_same_v<Int, int>, int> = 0>
 constexpr integer<Bits, Signed> operator>>(const integer<Bits, Signed> & lhs, Int n) noexcept
 {
+    if constexpr (std::is_integral_v<Int> && sizeof(Int) >= sizeof(int))
+    {
+        if (static_cast<std::make_unsigned_t<Int>>(n) >= Bits)
+            return integer<Bits, Signed>(0);
+    }
     return lhs >> int(n);
 }
 
@@ -291,18 +304,6 @@ struct hash<wide::integer<Bits, Signed>>;
 
 // NOLINTBEGIN(*)
 
-/// Use same extended double for all platforms
-#if (LDBL_MANT_DIG == 64)
-#    define CONSTEXPR_FROM_DOUBLE constexpr
-using FromDoubleIntermediateType = long double;
-#else
-#    include <boost/math/special_functions/fpclassify.hpp>
-#    include <boost/multiprecision/cpp_bin_float.hpp>
-/// `wide_integer_from_builtin` can't be constexpr with non-literal `cpp_bin_float_double_extended`
-#    define CONSTEXPR_FROM_DOUBLE
-using FromDoubleIntermediateType = boost::multiprecision::cpp_bin_float_double_extended;
-#endif
-
 namespace CityHash_v1_0_2
 {
 struct uint128;
@@ -653,89 +654,102 @@ struct integer<Bits, Signed>::_impl
             wide_integer_from_tuple_like(self, std::make_pair(value.high64, value.low64));
     }
 
-    /**
-     * N.B. t is constructed from double, so max(t) = max(double) ~ 2^310
-     * the recursive call happens when t / 2^64 > 2^64, so there won't be more than 5 of them.
-     *
-     * t = a1 * max_int + b1,   a1 > max_int, b1 < max_int
-     * a1 = a2 * max_int + b2,  a2 > max_int, b2 < max_int
-     * a_(n - 1) = a_n * max_int + b2, a_n <= max_int <- base case.
-     */
-    template <class T>
-    constexpr static void set_multiplier(integer<Bits, Signed> & self, T t) noexcept
+    /// Truncates towards zero like a built-in conversion; values of 2^Bits and above keep their low
+    /// Bits bits. |rhs| < 2^64 * 2^(64 k) is split into items k and k - 1, both of which are exact:
+    /// a double has fewer significant bits than one item.
+    constexpr static void wide_integer_from_builtin(integer<Bits, Signed> & self, double rhs) noexcept
     {
-        constexpr uint64_t max_int = std::numeric_limits<uint64_t>::max();
-        static_assert(std::is_same_v<T, double> || std::is_same_v<T, FromDoubleIntermediateType>);
-        /// Implementation specific behaviour on overflow (if we don't check here, stack overflow will triggered in bigint_cast).
-#if (LDBL_MANT_DIG == 64)
-        if (!std::isfinite(t))
+        constexpr double item_scale = 18446744073709551616.0; /// 2^64
+
+        if (rhs > -9223372036854775808.0 && rhs < 9223372036854775808.0)
         {
-            self = 0;
+            self = static_cast<int64_t>(rhs);
             return;
         }
-#else
-        if constexpr (std::is_same_v<T, double>)
+
+        /// Implementation specific behaviour on overflow.
+        if (!std::isfinite(rhs))
         {
-            if (!std::isfinite(t))
-            {
-                self = 0;
-                return;
-            }
+            self = 0;
+            return;
         }
-        else
+
+        double value = rhs < 0 ? -rhs : rhs;
+        unsigned index = 0;
+        while (value >= item_scale)
         {
-            if (!boost::math::isfinite(t))
-            {
-                self = 0;
-                return;
-            }
+            value *= 1 / item_scale;
+            ++index;
         }
-#endif
 
-        const T alpha = t / static_cast<T>(max_int);
+        const base_type high = static_cast<base_type>(value);
+        const base_type low = static_cast<base_type>((value - static_cast<double>(high)) * item_scale);
 
-        /** Here we have to use strict comparison.
-          * The max_int is 2^64 - 1.
-          * When cast to a floating point type, it will be rounded to the closest representable number,
-          * which is 2^64.
-          * But 2^64 is not representable in uint64_t,
-          * so the maximum representable number will be strictly less.
-          */
-        if (alpha < static_cast<T>(max_int))
-            self = static_cast<uint64_t>(alpha);
-        else // max(double) / 2^64 will surely contain less than 52 precision bits, so speed up computations.
-            set_multiplier<double>(self, static_cast<double>(alpha));
+        for (unsigned i = 0; i < item_count; ++i)
+            self.items[i] = 0;
+        if (index < item_count)
+            self.items[little(index)] = high;
+        if (index != 0 && index - 1 < item_count)
+            self.items[little(index - 1)] = low;
 
-        self *= max_int;
-        self += static_cast<uint64_t>(t - floor(alpha) * static_cast<T>(max_int)); // += b_i
+        if (rhs < 0)
+            self = -self;
     }
 
-    CONSTEXPR_FROM_DOUBLE static void wide_integer_from_builtin(integer<Bits, Signed> & self, double rhs) noexcept
+    /// The magnitude x (items read as unsigned) rounded to the nearest F, ties to even. The top 64
+    /// bits go through the hardware uint64 -> F conversion with a sticky bit for everything below
+    /// them, and the exponent is applied afterwards with exact multiplications by powers of two.
+    template <typename F>
+    constexpr static F unsigned_to_floating(const integer<Bits, Signed> & x) noexcept
     {
-        constexpr int64_t max_int = std::numeric_limits<int64_t>::max();
-        constexpr int64_t min_int = std::numeric_limits<int64_t>::lowest();
+        constexpr F item_scale = static_cast<F>(18446744073709551616.0); /// 2^64
 
-        /// There are values in int64 that have more than 53 significant bits (in terms of double
-        /// representation). Such values, being promoted to double, are rounded up or down. If they are rounded up,
-        /// the result may not fit in 64 bits.
-        /// The example of such a number is 9.22337e+18.
-        /// As to_Integral does a static_cast to int64_t, it may result in UB.
-        /// The necessary check here is that FromDoubleIntermediateType has enough significant (mantissa) bits to store the
-        /// int64_t max value precisely.
+        unsigned top = item_count;
+        while (top > 1 && x.items[little(top - 1)] == 0)
+            --top;
+        if (top == 1)
+            return static_cast<F>(x.items[little(0)]);
 
-        if (rhs > static_cast<FromDoubleIntermediateType>(min_int) && rhs < static_cast<FromDoubleIntermediateType>(max_int))
+        const unsigned t = top - 1;
+        F res = 0;
+        if constexpr (std::numeric_limits<F>::digits > base_bits)
         {
-            self = static_cast<int64_t>(rhs);
-            return;
+            for (unsigned i = top; i-- > 0;)
+                res = res * item_scale + static_cast<F>(x.items[little(i)]);
+            return res;
         }
 
-        const FromDoubleIntermediateType rhs_long_double
-            = (static_cast<FromDoubleIntermediateType>(rhs) < 0) ? -static_cast<FromDoubleIntermediateType>(rhs) : rhs;
+        const base_type high = x.items[little(t)];
+        const base_type next = x.items[little(t - 1)];
+        const unsigned lz = static_cast<unsigned>(__builtin_clzll(high));
 
-        set_multiplier(self, rhs_long_double);
+        base_type mantissa = lz ? funnel_left(high, next, lz) : high;
+        const base_type rest = next << lz;
+        bool sticky = false;
+        for (unsigned i = 0; i + 1 < t; ++i)
+            sticky |= x.items[little(i)] != 0;
 
-        if (rhs < 0)
-            self = -self;
+        if constexpr (std::numeric_limits<F>::digits < base_bits)
+        {
+            /// The lowest bit of the mantissa is dropped by the conversion anyway, so it can carry
+            /// the sticky bit.
+            res = static_cast<F>(mantissa | static_cast<base_type>(rest != 0 || sticky));
+        }
+        else
+        {
+            /// A 64-bit significand keeps the whole mantissa; round on the first dropped bit.
+            const bool round = (rest >> (base_bits - 1)) != 0;
+            sticky |= (rest << 1) != 0;
+            bool carry = false;
+            if (round && (sticky || (mantissa & 1)))
+                carry = ++mantissa == 0;
+            res = carry ? item_scale : static_cast<F>(mantissa);
+        }
+
+        F scale = item_scale / static_cast<F>(base_type(1) << lz);
+        for (unsigned i = 1; i < t; ++i)
+            scale *= item_scale;
+        return res * scale;
     }
 
     template <size_t Bits2, typename Signed2>
@@ -770,71 +784,197 @@ struct integer<Bits, Signed>::_impl
         return sizeof(T) <= byte_count;
     }
 
-    constexpr static integer<Bits, Signed> shift_left(const integer<Bits, Signed> & rhs, unsigned n) noexcept
+    /// Upper item of (hi:lo) << n and lower item of (hi:lo) >> n for 0 < n < base_bits; both compile
+    /// to a single SHLD/SHRD on x86-64.
+    constexpr static base_type funnel_left(base_type hi, base_type lo, unsigned n) noexcept
     {
-        integer<Bits, Signed> lhs;
-        unsigned items_shift = n / base_bits;
+        return (hi << n) | (lo >> (base_bits - n));
+    }
 
-        if (unsigned bit_shift = n % base_bits)
-        {
-            unsigned overflow_shift = base_bits - bit_shift;
+    constexpr static base_type funnel_right(base_type hi, base_type lo, unsigned n) noexcept
+    {
+        return (lo >> n) | (hi << (base_bits - n));
+    }
 
-            lhs.items[big(0)] = rhs.items[big(items_shift)] << bit_shift;
-            for (unsigned i = 1; i < item_count - items_shift; ++i)
-            {
-                lhs.items[big(i - 1)] |= rhs.items[big(items_shift + i)] >> overflow_shift;
-                lhs.items[big(i)] = rhs.items[big(items_shift + i)] << bit_shift;
-            }
+    /// res = x << n for n < Bits, one funnel shift per item. `res` may alias `x`: items are written
+    /// from the most significant down, after the items they read.
+    constexpr static void shift_left_to(integer<Bits, Signed> & res, const integer<Bits, Signed> & x, unsigned n) noexcept
+    {
+        const unsigned items_shift = n / base_bits;
+        const unsigned bit_shift = n % base_bits;
+
+        if (bit_shift && !items_shift)
+        {
+            // the common sub-item shift, with a constant trip count that unrolls
+            for (unsigned i = item_count - 1; i > 0; --i)
+                res.items[little(i)] = funnel_left(x.items[little(i)], x.items[little(i - 1)], bit_shift);
+            res.items[little(0)] = x.items[little(0)] << bit_shift;
+        }
+        else if (bit_shift)
+        {
+            for (unsigned i = item_count - 1; i > items_shift; --i)
+                res.items[little(i)] = funnel_left(x.items[little(i - items_shift)], x.items[little(i - items_shift - 1)], bit_shift);
+            res.items[little(items_shift)] = x.items[little(0)] << bit_shift;
         }
         else
         {
-            for (unsigned i = 0; i < item_count - items_shift; ++i)
-                lhs.items[big(i)] = rhs.items[big(items_shift + i)];
+            for (unsigned i = item_count; i-- > items_shift;)
+                res.items[little(i)] = x.items[little(i - items_shift)];
         }
 
         for (unsigned i = 0; i < items_shift; ++i)
-            lhs.items[little(i)] = 0;
+            res.items[little(i)] = 0;
+    }
+
+    /// res = x >> n for n < Bits, arithmetic for a negative `x`. `res` may alias `x`: items are written
+    /// from the least significant up, after the items they read.
+    constexpr static void shift_right_to(integer<Bits, Signed> & res, const integer<Bits, Signed> & x, unsigned n) noexcept
+    {
+        const unsigned items_shift = n / base_bits;
+        const unsigned bit_shift = n % base_bits;
+        const unsigned top = item_count - 1 - items_shift;
+        const base_type fill = is_negative(x) ? std::numeric_limits<base_type>::max() : 0;
+
+        if (bit_shift && !items_shift)
+        {
+            for (unsigned i = 0; i + 1 < item_count; ++i)
+                res.items[little(i)] = funnel_right(x.items[little(i + 1)], x.items[little(i)], bit_shift);
+            res.items[little(top)] = funnel_right(fill, x.items[little(top)], bit_shift);
+        }
+        else if (bit_shift)
+        {
+            for (unsigned i = 0; i < top; ++i)
+                res.items[little(i)] = funnel_right(x.items[little(i + items_shift + 1)], x.items[little(i + items_shift)], bit_shift);
+            res.items[little(top)] = funnel_right(fill, x.items[little(item_count - 1)], bit_shift);
+        }
+        else
+        {
+            for (unsigned i = 0; i <= top; ++i)
+                res.items[little(i)] = x.items[little(i + items_shift)];
+        }
+
+        for (unsigned i = top + 1; i < item_count; ++i)
+            res.items[little(i)] = fill;
+    }
+
+    constexpr static integer<Bits, Signed> shift_left(const integer<Bits, Signed> & rhs, unsigned n) noexcept
+    {
+        integer<Bits, Signed> lhs{};
+        shift_left_to(lhs, rhs, n);
         return lhs;
     }
 
     constexpr static integer<Bits, Signed> shift_right(const integer<Bits, Signed> & rhs, unsigned n) noexcept
     {
-        integer<Bits, Signed> lhs;
-        unsigned items_shift = n / base_bits;
-        unsigned bit_shift = n % base_bits;
+        integer<Bits, Signed> lhs{};
+        shift_right_to(lhs, rhs, n);
+        return lhs;
+    }
 
-        if (bit_shift)
+    /// res = lhs + rhs in a single carry chain; returns the carry out of the most significant item.
+    /// `res` may alias either operand.
+    constexpr static bool
+    add_carry(integer<Bits, Signed> & res, const integer<Bits, Signed> & lhs, const integer<Bits, Signed> & rhs) noexcept
+    {
+        bool carry = false;
+        for (unsigned i = 0; i < item_count; ++i)
         {
-            unsigned overflow_shift = base_bits - bit_shift;
-
-            lhs.items[little(0)] = rhs.items[little(items_shift)] >> bit_shift;
-            for (unsigned i = 1; i < item_count - items_shift; ++i)
-            {
-                lhs.items[little(i - 1)] |= rhs.items[little(items_shift + i)] << overflow_shift;
-                lhs.items[little(i)] = rhs.items[little(items_shift + i)] >> bit_shift;
-            }
+            base_type lhs_item = lhs.items[little(i)];
+            base_type sum = lhs_item + rhs.items[little(i)];
+            bool overflow = sum < lhs_item;
+            base_type res_item = sum + carry;
+            carry = overflow || res_item < sum;
+            res.items[little(i)] = res_item;
         }
-        else
+        return carry;
+    }
+
+    /// res = lhs - rhs in a single borrow chain; returns the borrow out of the most significant item.
+    /// `res` may alias either operand.
+    constexpr static bool
+    sub_borrow(integer<Bits, Signed> & res, const integer<Bits, Signed> & lhs, const integer<Bits, Signed> & rhs) noexcept
+    {
+        bool borrow = false;
+        for (unsigned i = 0; i < item_count; ++i)
         {
-            for (unsigned i = 0; i < item_count - items_shift; ++i)
-                lhs.items[little(i)] = rhs.items[little(items_shift + i)];
+            base_type lhs_item = lhs.items[little(i)];
+            base_type rhs_item = rhs.items[little(i)];
+            base_type diff = lhs_item - rhs_item;
+            bool underflow = lhs_item < rhs_item;
+            base_type res_item = diff - borrow;
+            borrow = underflow || diff < static_cast<base_type>(borrow);
+            res.items[little(i)] = res_item;
         }
+        return borrow;
+    }
+
+    /// Full double-width product of the raw items, both operands are treated as unsigned.
+    constexpr static integer<Bits * 2, unsigned>
+    multiply_wide(const integer<Bits, Signed> & lhs, const integer<Bits, Signed> & rhs) noexcept
+    {
+        using Wide = integer<Bits * 2, unsigned>;
+        Wide res{};
 
-        if (is_negative(rhs))
+        for (unsigned i = 0; i < item_count; ++i)
         {
-            if (bit_shift)
-                lhs.items[big(items_shift)] |= std::numeric_limits<base_type>::max() << (base_bits - bit_shift);
+            base_type lhs_item = lhs.items[little(i)];
+            if (!lhs_item)
+                continue;
 
-            for (unsigned i = 0; i < items_shift; ++i)
-                lhs.items[big(i)] = std::numeric_limits<base_type>::max();
+            unsigned __int128 carry = 0;
+            for (unsigned j = 0; j < item_count; ++j)
+            {
+                unsigned __int128 cur = static_cast<unsigned __int128>(lhs_item) * rhs.items[little(j)]
+                    + res.items[Wide::_impl::little(i + j)] + carry;
+                res.items[Wide::_impl::little(i + j)] = static_cast<base_type>(cur);
+                carry = cur >> base_bits;
+            }
+            res.items[Wide::_impl::little(i + item_count)] = static_cast<base_type>(carry);
         }
-        else
+
+        return res;
+    }
+
+    /// res += lhs * rhs, or res -= lhs * rhs, wrapped to Bits. Each row of the schoolbook product is
+    /// added into `res` as it is formed; items above Bits are never computed. `res` must not alias.
+    template <bool Subtract>
+    constexpr static void
+    multiply_accumulate(integer<Bits, Signed> & res, const integer<Bits, Signed> & lhs, const integer<Bits, Signed> & rhs) noexcept
+    {
+        for (unsigned i = 0; i < item_count; ++i)
         {
-            for (unsigned i = 0; i < items_shift; ++i)
-                lhs.items[big(i)] = 0;
+            base_type lhs_item = lhs.items[little(i)];
+            if (!lhs_item)
+                continue;
+            multiply_accumulate_row<Subtract>(res, i, lhs_item, rhs);
         }
+    }
 
-        return lhs;
+    /// res += lhs_item * rhs * 2^(base_bits * offset), or res -= ..., wrapped to Bits.
+    template <bool Subtract>
+    constexpr static void
+    multiply_accumulate_row(integer<Bits, Signed> & res, unsigned offset, base_type lhs_item, const integer<Bits, Signed> & rhs) noexcept
+    {
+        /// The high half of the product is at most 2^64 - 2 unless the low half is 0, so adding the
+        /// carry flag to it cannot overflow.
+        base_type carry = 0;
+        for (unsigned j = 0; j + offset < item_count; ++j)
+        {
+            unsigned __int128 cur = static_cast<unsigned __int128>(lhs_item) * rhs.items[little(j)] + carry;
+            base_type low = static_cast<base_type>(cur);
+            carry = static_cast<base_type>(cur >> base_bits);
+            base_type & res_item = res.items[little(offset + j)];
+            if constexpr (Subtract)
+            {
+                carry += res_item < low;
+                res_item -= low;
+            }
+            else
+            {
+                res_item += low;
+                carry += res_item < low;
+            }
+        }
     }
 
 private:
@@ -1661,7 +1801,7 @@ constexpr integer<Bits, Signed> & integer<Bits, Signed>::operator<<=(int n) noex
     if (static_cast<size_t>(n) >= Bits)
         *this = 0;
     else if (n > 0)
-        *this = _impl::shift_left(*this, n);
+        _impl::shift_left_to(*this, *this, n);
     return *this;
 }
 
@@ -1676,7 +1816,7 @@ constexpr integer<Bits, Signed> & integer<Bits, Signed>::operator>>=(int n) noex
             *this = 0;
     }
     else if (n > 0)
-        *this = _impl::shift_right(*this, n);
+        _impl::shift_right_to(*this, *this, n);
     return *this;
 }
 
@@ -1737,38 +1877,25 @@ constexpr integer<Bits, Signed>::operator T() const noexcept
 template <size_t Bits, typename Signed>
 constexpr integer<Bits, Signed>::operator long double() const noexcept
 {
-    if (_impl::operator_eq(*this, 0))
-        return 0;
-
-    integer<Bits, Signed> tmp = *this;
     if (_impl::is_negative(*this))
-        tmp = -tmp;
-
-    long double res = 0;
-    for (unsigned i = 0; i < _impl::item_count; ++i)
-    {
-        long double t = res;
-        res *= static_cast<long double>(std::numeric_limits<base_type>::max());
-        res += t;
-        res += tmp.items[_impl::big(i)];
-    }
-
-    if (_impl::is_negative(*this))
-        res = -res;
-
-    return res;
+        return -_impl::template unsigned_to_floating<long double>(_impl::operator_unary_minus(*this));
+    return _impl::template unsigned_to_floating<long double>(*this);
 }
 
 template <size_t Bits, typename Signed>
 constexpr integer<Bits, Signed>::operator double() const noexcept
 {
-    return static_cast<double>(static_cast<long double>(*this));
+    if (_impl::is_negative(*this))
+        return -_impl::template unsigned_to_floating<double>(_impl::operator_unary_minus(*this));
+    return _impl::template unsigned_to_floating<double>(*this);
 }
 
 template <size_t Bits, typename Signed>
 constexpr integer<Bits, Signed>::operator float() const noexcept
 {
-    return static_cast<float>(static_cast<long double>(*this));
+    if (_impl::is_negative(*this))
+        return -_impl::template unsigned_to_floating<float>(_impl::operator_unary_minus(*this));
+    return _impl::template unsigned_to_floating<float>(*this);
 }
 template <size_t Bits, typename Signed>
 constexpr integer<Bits, Signed>::operator __int128() const noexcept
@@ -2001,6 +2128,650 @@ constexpr bool operator!=(const Arithmetic & lhs, const Arithmetic2 & rhs)
 }
 #undef CT
 
+/// Counterparts of the <bit> functions for unsigned wide integers. Each works item by item with the
+/// corresponding compiler intrinsic and stays usable in constant expressions.
+template <size_t Bits>
+constexpr int popcount(const integer<Bits, unsigned> & x) noexcept
+{
+    int res = 0;
+    for (auto item : x.items)
+    {
+#if defined(__POPCNT__)
+        res += __builtin_popcountll(item);
+#else
+        /// Without the popcnt instruction the builtin becomes a library call per item, the SWAR sum is faster.
+        item -= (item >> 1) & 0x5555555555555555ULL;
+        item = (item & 0x3333333333333333ULL) + ((item >> 2) & 0x3333333333333333ULL);
+        item = (item + (item >> 4)) & 0x0F0F0F0F0F0F0F0FULL;
+        res += static_cast<int>((item * 0x0101010101010101ULL) >> 56);
+#endif
+    }
+    return res;
+}
+
+template <size_t Bits>
+constexpr int countl_zero(const integer<Bits, unsigned> & x) noexcept
+{
+    using Impl = typename integer<Bits, unsigned>::_impl;
+    for (unsigned i = 0; i < Impl::item_count; ++i)
+    {
+        const uint64_t item = x.items[Impl::big(i)];
+        if (item)
+            return static_cast<int>(i * 64 + __builtin_clzll(item));
+    }
+    return static_cast<int>(Bits);
+}
+
+template <size_t Bits>
+constexpr int countr_zero(const integer<Bits, unsigned> & x) noexcept
+{
+    using Impl = typename integer<Bits, unsigned>::_impl;
+    for (unsigned i = 0; i < Impl::item_count; ++i)
+    {
+        const uint64_t item = x.items[Impl::little(i)];
+        if (item)
+            return static_cast<int>(i * 64 + __builtin_ctzll(item));
+    }
+    return static_cast<int>(Bits);
+}
+
+template <size_t Bits>
+constexpr int countl_one(const integer<Bits, unsigned> & x) noexcept
+{
+    return countl_zero(~x);
+}
+
+template <size_t Bits>
+constexpr int countr_one(const integer<Bits, unsigned> & x) noexcept
+{
+    return countr_zero(~x);
+}
+
+template <size_t Bits>
+constexpr int bit_width(const integer<Bits, unsigned> & x) noexcept
+{
+    return static_cast<int>(Bits) - countl_zero(x);
+}
+
+template <size_t Bits>
+constexpr bool has_single_bit(const integer<Bits, unsigned> & x) noexcept
+{
+    return popcount(x) == 1;
+}
+
+/// Rotation to the left by `s` bits, to the right for negative `s`.
+template <size_t Bits>
+constexpr integer<Bits, unsigned> rotl(const integer<Bits, unsigned> & x, int s) noexcept
+{
+    using Impl = typename integer<Bits, unsigned>::_impl;
+    constexpr unsigned count = Impl::item_count;
+    const unsigned r = static_cast<unsigned>(((s % static_cast<int>(Bits)) + static_cast<int>(Bits)) % static_cast<int>(Bits));
+    const unsigned items_shift = r / 64;
+    const unsigned bit_shift = r % 64;
+
+    integer<Bits, unsigned> res{};
+    for (unsigned i = 0; i < count; ++i)
+    {
+        const uint64_t item = x.items[Impl::little((i + count - items_shift) % count)];
+        const uint64_t lower = x.items[Impl::little((i + count - items_shift - 1) % count)];
+        res.items[Impl::little(i)] = bit_shift ? (item << bit_shift) | (lower >> (64 - bit_shift)) : item;
+    }
+    return res;
+}
+
+template <size_t Bits>
+constexpr integer<Bits, unsigned> rotr(const integer<Bits, unsigned> & x, int s) noexcept
+{
+    return rotl(x, -(s % static_cast<int>(Bits)));
+}
+
+template <size_t Bits>
+constexpr integer<Bits, unsigned> byteswap(const integer<Bits, unsigned> & x) noexcept
+{
+    using Impl = typename integer<Bits, unsigned>::_impl;
+    integer<Bits, unsigned> res{};
+    for (unsigned i = 0; i < Impl::item_count; ++i)
+        res.items[Impl::little(i)] = __builtin_bswap64(x.items[Impl::big(i)]);
+    return res;
+}
+
+/// x << N and x >> N for a shift count known at compile time, with the same results as the operators.
+/// The item offset and bit offset are constants, so the loops unroll into plain item moves (N a multiple
+/// of 64) or one funnel shift per item.
+template <unsigned N, size_t Bits, typename Signed>
+constexpr integer<Bits, Signed> shl(const integer<Bits, Signed> & x) noexcept
+{
+    using Impl = typename integer<Bits, Signed>::_impl;
+    constexpr unsigned items_shift = N / 64;
+    constexpr unsigned bit_shift = N % 64;
+
+    integer<Bits, Signed> res{};
+    if constexpr (N < Bits)
+    {
+        for (unsigned i = items_shift; i < Impl::item_count; ++i)
+        {
+            if constexpr (bit_shift == 0)
+                res.items[Impl::little(i)] = x.items[Impl::little(i - items_shift)];
+            else if (i == items_shift)
+                res.items[Impl::little(i)] = x.items[Impl::little(0)] << bit_shift;
+            else
+                res.items[Impl::little(i)]
+                    = Impl::funnel_left(x.items[Impl::little(i - items_shift)], x.items[Impl::little(i - items_shift - 1)], bit_shift);
+        }
+    }
+    return res;
+}
+
+template <unsigned N, size_t Bits, typename Signed>
+constexpr integer<Bits, Signed> shr(const integer<Bits, Signed> & x) noexcept
+{
+    using Impl = typename integer<Bits, Signed>::_impl;
+    constexpr unsigned items_shift = N / 64;
+    constexpr unsigned bit_shift = N % 64;
+
+    integer<Bits, Signed> res{};
+    if constexpr (N == 0)
+        res = x;
+    else if constexpr (N < Bits)
+    {
+        constexpr unsigned top = Impl::item_count - 1 - items_shift;
+        const uint64_t fill = Impl::is_negative(x) ? ~uint64_t(0) : 0;
+        for (unsigned i = 0; i < Impl::item_count; ++i)
+        {
+            if (i > top)
+                res.items[Impl::little(i)] = fill;
+            else if constexpr (bit_shift == 0)
+                res.items[Impl::little(i)] = x.items[Impl::little(i + items_shift)];
+            else if (i == top)
+                res.items[Impl::little(i)] = Impl::funnel_right(fill, x.items[Impl::little(Impl::item_count - 1)], bit_shift);
+            else
+                res.items[Impl::little(i)]
+                    = Impl::funnel_right(x.items[Impl::little(i + items_shift + 1)], x.items[Impl::little(i + items_shift)], bit_shift);
+        }
+    }
+    return res;
+}
+
+/// Serialization to and from Bits / 8 bytes in little- or big-endian order, as in binary protocols
+/// with 256-bit words. Each item is one unaligned copy, byte swapped when the order differs from the
+/// host's. Use as `wide::load_be<UInt256>(bytes)`.
+template <size_t Bits, typename Signed>
+inline void store_le(const integer<Bits, Signed> & x, uint8_t * out) noexcept
+{
+    using Impl = typename integer<Bits, Signed>::_impl;
+    for (unsigned i = 0; i < Impl::item_count; ++i)
+    {
+        uint64_t item = x.items[Impl::little(i)];
+        if constexpr (std::endian::native != std::endian::little)
+            item = __builtin_bswap64(item);
+        std::memcpy(out + i * sizeof(item), &item, sizeof(item));
+    }
+}
+
+template <size_t Bits, typename Signed>
+inline void store_be(const integer<Bits, Signed> & x, uint8_t * out) noexcept
+{
+    using Impl = typename integer<Bits, Signed>::_impl;
+    for (unsigned i = 0; i < Impl::item_count; ++i)
+    {
+        uint64_t item = x.items[Impl::big(i)];
+        if constexpr (std::endian::native != std::endian::big)
+            item = __builtin_bswap64(item);
+        std::memcpy(out + i * sizeof(item), &item, sizeof(item));
+    }
+}
+
+template <typename Integer>
+inline Integer load_le(const uint8_t * in) noexcept
+{
+    static_assert(IsWideInteger<Integer>::value);
+    using Impl = typename Integer::_impl;
+    Integer x;
+    for (unsigned i = 0; i < Impl::item_count; ++i)
+    {
+        uint64_t item;
+        std::memcpy(&item, in + i * sizeof(item), sizeof(item));
+        if constexpr (std::endian::native != std::endian::little)
+            item = __builtin_bswap64(item);
+        x.items[Impl::little(i)] = item;
+    }
+    return x;
+}
+
+template <typename Integer>
+inline Integer load_be(const uint8_t * in) noexcept
+{
+    static_assert(IsWideInteger<Integer>::value);
+    using Impl = typename Integer::_impl;
+    Integer x;
+    for (unsigned i = 0; i < Impl::item_count; ++i)
+    {
+        uint64_t item;
+        std::memcpy(&item, in + i * sizeof(item), sizeof(item));
+        if constexpr (std::endian::native != std::endian::big)
+            item = __builtin_bswap64(item);
+        x.items[Impl::big(i)] = item;
+    }
+    return x;
+}
+
+/// An integer is exactly its Bits / 64 items and nothing else: it can be copied with memcpy, written
+/// to disk and mapped back. The items are in native order, least significant first on little-endian
+/// hosts and most significant first on big-endian ones, like a built-in integer of that width.
+template <size_t Bits, typename Signed>
+struct has_plain_layout
+    : std::bool_constant<
+          std::is_trivially_copyable_v<integer<Bits, Signed>> && std::is_standard_layout_v<integer<Bits, Signed>>
+          && sizeof(integer<Bits, Signed>) == Bits / 8 && alignof(integer<Bits, Signed>) == alignof(uint64_t)>
+{
+};
+
+static_assert(has_plain_layout<128, unsigned>::value && has_plain_layout<128, signed>::value);
+static_assert(has_plain_layout<256, unsigned>::value && has_plain_layout<256, signed>::value);
+static_assert(has_plain_layout<512, unsigned>::value && has_plain_layout<1024, signed>::value);
+
+/// A view of the items of an integer in memory order, see has_plain_layout.
+template <typename T>
+class limb_span
+{
+public:
+    constexpr limb_span(T * data, size_t size) noexcept : data_(data), size_(size) { }
+
+    constexpr T * data() const noexcept { return data_; }
+    constexpr size_t size() const noexcept { return size_; }
+    constexpr T * begin() const noexcept { return data_; }
+    constexpr T * end() const noexcept { return data_ + size_; }
+    constexpr T & operator[](size_t i) const noexcept { return data_[i]; }
+
+private:
+    T * data_;
+    size_t size_;
+};
+
+template <size_t Bits, typename Signed>
+constexpr limb_span<uint64_t> limbs(integer<Bits, Signed> & x) noexcept
+{
+    static_assert(has_plain_layout<Bits, Signed>::value);
+    return {x.items, Bits / 64};
+}
+
+template <size_t Bits, typename Signed>
+constexpr limb_span<const uint64_t> limbs(const integer<Bits, Signed> & x) noexcept
+{
+    static_assert(has_plain_layout<Bits, Signed>::value);
+    return {x.items, Bits / 64};
+}
+
+namespace detail
+{
+/// The size rounded up to a power of two, at most a cache line.
+constexpr size_t natural_alignment(size_t size) noexcept
+{
+    size_t alignment = alignof(uint64_t);
+    while (alignment < size && alignment < 64)
+        alignment *= 2;
+    return alignment;
+}
+}
+
+/// An integer over-aligned to `Alignment` bytes, by default its size rounded up to a power of two
+/// and capped at 64. Arrays and hash table slots of aligned 128- and 256-bit values never straddle a
+/// cache line. It converts to and from integer<Bits, Signed> implicitly; arithmetic yields plain
+/// integers.
+template <size_t Bits, typename Signed, size_t Alignment = detail::natural_alignment(Bits / 8)>
+class alignas(Alignment) aligned_integer : public integer<Bits, Signed>
+{
+public:
+    using integer<Bits, Signed>::integer;
+
+    constexpr aligned_integer() noexcept = default;
+    constexpr aligned_integer(const integer<Bits, Signed> & x) noexcept : integer<Bits, Signed>(x) { }
+
+    constexpr aligned_integer & operator=(const integer<Bits, Signed> & x) noexcept
+    {
+        integer<Bits, Signed>::operator=(x);
+        return *this;
+    }
+};
+
+/// Overflow-reporting arithmetic in the spirit of `__builtin_*_overflow`: `*res` always receives the
+/// wrapped result and the return value tells whether the mathematically exact result did not fit.
+/// The flag is derived from the carry/borrow of the same item pass that produces the result.
+template <size_t Bits, typename Signed>
+constexpr bool add_overflow(const integer<Bits, Signed> & lhs, const integer<Bits, Signed> & rhs, integer<Bits, Signed> * res) noexcept
+{
+    using Impl = typename integer<Bits, Signed>::_impl;
+    const bool lhs_neg = Impl::is_negative(lhs);
+    const bool rhs_neg = Impl::is_negative(rhs);
+    const bool carry = Impl::add_carry(*res, lhs, rhs);
+    if constexpr (std::is_same_v<Signed, signed>)
+        return lhs_neg == rhs_neg && Impl::is_negative(*res) != lhs_neg;
+    else
+        return carry;
+}
+
+template <size_t Bits, typename Signed>
+constexpr bool sub_overflow(const integer<Bits, Signed> & lhs, const integer<Bits, Signed> & rhs, integer<Bits, Signed> * res) noexcept
+{
+    using Impl = typename integer<Bits, Signed>::_impl;
+    const bool lhs_neg = Impl::is_negative(lhs);
+    const bool rhs_neg = Impl::is_negative(rhs);
+    const bool borrow = Impl::sub_borrow(*res, lhs, rhs);
+    if constexpr (std::is_same_v<Signed, signed>)
+        return lhs_neg != rhs_neg && Impl::is_negative(*res) != lhs_neg;
+    else
+        return borrow;
+}
+
+template <size_t Bits, typename Signed>
+constexpr bool mul_overflow(const integer<Bits, Signed> & lhs, const integer<Bits, Signed> & rhs, integer<Bits, Signed> * res) noexcept
+{
+    using Impl = typename integer<Bits, Signed>::_impl;
+    using Wide = integer<Bits * 2, unsigned>;
+
+    const bool lhs_neg = Impl::is_negative(lhs);
+    const bool rhs_neg = Impl::is_negative(rhs);
+    const Wide full = Impl::multiply_wide(Impl::make_positive(lhs), Impl::make_positive(rhs));
+
+    bool overflow = false;
+    for (unsigned i = 0; i < Impl::item_count; ++i)
+    {
+        res->items[Impl::little(i)] = full.items[Wide::_impl::little(i)];
+        overflow = overflow || full.items[Wide::_impl::little(Impl::item_count + i)] != 0;
+    }
+
+    if constexpr (std::is_same_v<Signed, signed>)
+    {
+        /// The magnitude must stay below 2^(Bits - 1), except for exactly 2^(Bits - 1) with a negative sign.
+        if (Impl::is_negative(*res))
+        {
+            bool is_min = (res->items[Impl::big(0)] << 1) == 0;
+            for (unsigned i = 1; i < Impl::item_count; ++i)
+                is_min = is_min && res->items[Impl::big(i)] == 0;
+            overflow = overflow || !(lhs_neg != rhs_neg && is_min);
+        }
+        if (lhs_neg != rhs_neg)
+            *res = Impl::operator_unary_minus(*res);
+    }
+
+    return overflow;
+}
+
+/// Widening multiplication: the exact product in twice the width, never overflows.
+template <size_t Bits, typename Signed>
+constexpr integer<Bits * 2, Signed> mul_wide(const integer<Bits, Signed> & lhs, const integer<Bits, Signed> & rhs) noexcept
+{
+    using Impl = typename integer<Bits, Signed>::_impl;
+    integer<Bits * 2, Signed> res = Impl::multiply_wide(Impl::make_positive(lhs), Impl::make_positive(rhs));
+    if constexpr (std::is_same_v<Signed, signed>)
+    {
+        if (Impl::is_negative(lhs) != Impl::is_negative(rhs))
+            res = -res;
+    }
+    return res;
+}
+
+/// Fused multiply-add: lhs * rhs + addend, wrapped to Bits like the separate operators. The product
+/// is accumulated straight into the result without a temporary for it, and only its low Bits are formed.
+template <size_t Bits, typename Signed>
+constexpr integer<Bits, Signed>
+fma(const integer<Bits, Signed> & lhs, const integer<Bits, Signed> & rhs, const integer<Bits, Signed> & addend) noexcept
+{
+    integer<Bits, Signed> res = addend;
+    integer<Bits, Signed>::_impl::template multiply_accumulate<false>(res, lhs, rhs);
+    return res;
+}
+
+/// acc += lhs * rhs in one pass, wrapped to Bits. `acc` may not be one of the factors.
+template <size_t Bits, typename Signed>
+constexpr void mul_add(integer<Bits, Signed> & acc, const integer<Bits, Signed> & lhs, const integer<Bits, Signed> & rhs) noexcept
+{
+    integer<Bits, Signed>::_impl::template multiply_accumulate<false>(acc, lhs, rhs);
+}
+
+/// acc -= lhs * rhs in one pass, wrapped to Bits. `acc` may not be one of the factors.
+template <size_t Bits, typename Signed>
+constexpr void mul_sub(integer<Bits, Signed> & acc, const integer<Bits, Signed> & lhs, const integer<Bits, Signed> & rhs) noexcept
+{
+    integer<Bits, Signed>::_impl::template multiply_accumulate<true>(acc, lhs, rhs);
+}
+
+/// acc += x * k for an unsigned 64-bit k in a single row, wrapped to Bits. `acc` may not be `x`.
+template <size_t Bits, typename Signed>
+constexpr void add_mul_scalar(integer<Bits, Signed> & acc, const integer<Bits, Signed> & x, uint64_t k) noexcept
+{
+    integer<Bits, Signed>::_impl::template multiply_accumulate_row<false>(acc, 0, k, x);
+}
+
+/// Overflow policy for `checked`: throw `std::overflow_error` on the first overflow.
+struct throw_on_overflow
+{
+    [[noreturn]] static void on_overflow(const char * what) { throw std::overflow_error(what); }
+};
+
+/// Overflow policy for `checked`: keep the wrapped value and only set the sticky overflow flag.
+struct record_overflow
+{
+    static constexpr void on_overflow(const char *) noexcept { }
+};
+
+/// Integer wrapper that detects overflow of every arithmetic operation.
+/// The overflow flag is sticky: it is propagated through all values derived from an overflowed one.
+template <size_t Bits, typename Signed, typename OverflowPolicy = throw_on_overflow>
+class checked
+{
+public:
+    using value_type = integer<Bits, Signed>;
+
+    constexpr checked() noexcept = default;
+    constexpr checked(const value_type & v) noexcept
+        : value_(v)
+    {
+    }
+
+    constexpr const value_type & value() const noexcept { return value_; }
+    constexpr bool overflowed() const noexcept { return overflowed_; }
+
+    constexpr checked & operator+=(const checked & rhs)
+    {
+        overflowed_ = overflowed_ || rhs.overflowed_;
+        report(add_overflow(value_, rhs.value_, &value_), "wide::checked: addition overflow");
+        return *this;
+    }
+
+    constexpr checked & operator-=(const checked & rhs)
+    {
+        overflowed_ = overflowed_ || rhs.overflowed_;
+        report(sub_overflow(value_, rhs.value_, &value_), "wide::checked: subtraction overflow");
+        return *this;
+    }
+
+    constexpr checked & operator*=(const checked & rhs)
+    {
+        overflowed_ = overflowed_ || rhs.overflowed_;
+        report(mul_overflow(value_, rhs.value_, &value_), "wide::checked: multiplication overflow");
+        return *this;
+    }
+
+    constexpr checked & operator/=(const checked & rhs)
+    {
+        overflowed_ = overflowed_ || rhs.overflowed_;
+        /// min / -1 is the only quotient that does not fit; it wraps back to min.
+        bool overflow = std::is_same_v<Signed, signed> && value_ == std::numeric_limits<value_type>::min() && rhs.value_ == -1;
+        if (!overflow)
+            value_ /= rhs.value_;
+        report(overflow, "wide::checked: division overflow");
+        return *this;
+    }
+
+    friend constexpr checked operator+(checked lhs, const checked & rhs)
+    {
+        lhs += rhs;
+        return lhs;
+    }
+
+    friend constexpr checked operator-(checked lhs, const checked & rhs)
+    {
+        lhs -= rhs;
+        return lhs;
+    }
+
+    friend constexpr checked operator*(checked lhs, const checked & rhs)
+    {
+        lhs *= rhs;
+        return lhs;
+    }
+
+    friend constexpr checked operator/(checked lhs, const checked & rhs)
+    {
+        lhs /= rhs;
+        return lhs;
+    }
+
+    friend constexpr checked operator-(const checked & v)
+    {
+        checked res;
+        res -= v;
+        return res;
+    }
+
+    friend constexpr bool operator==(const checked & lhs, const checked & rhs) noexcept { return lhs.value_ == rhs.value_; }
+    friend constexpr bool operator!=(const checked & lhs, const checked & rhs) noexcept { return lhs.value_ != rhs.value_; }
+    friend constexpr bool operator<(const checked & lhs, const checked & rhs) noexcept { return lhs.value_ < rhs.value_; }
+    friend constexpr bool operator>(const checked & lhs, const checked & rhs) noexcept { return lhs.value_ > rhs.value_; }
+    friend constexpr bool operator<=(const checked & lhs, const checked & rhs) noexcept { return lhs.value_ <= rhs.value_; }
+    friend constexpr bool operator>=(const checked & lhs, const checked & rhs) noexcept { return lhs.value_ >= rhs.value_; }
+
+private:
+    constexpr void report(bool overflow, const char * what)
+    {
+        if (!overflow)
+            return;
+        overflowed_ = true;
+        OverflowPolicy::on_overflow(what);
+    }
+
+    value_type value_{};
+    bool overflowed_ = false;
+};
+
+/// Saturating arithmetic: results that do not fit are clamped to numeric_limits<>::min()/max().
+/// The direction of the clamp follows from the operand signs, so no widening is needed.
+template <size_t Bits, typename Signed>
+constexpr integer<Bits, Signed> add_sat(const integer<Bits, Signed> & lhs, const integer<Bits, Signed> & rhs) noexcept
+{
+    using Impl = typename integer<Bits, Signed>::_impl;
+    integer<Bits, Signed> res{};
+    if (!add_overflow(lhs, rhs, &res))
+        return res;
+    return Impl::is_negative(lhs) ? std::numeric_limits<integer<Bits, Signed>>::min() : std::numeric_limits<integer<Bits, Signed>>::max();
+}
+
+template <size_t Bits, typename Signed>
+constexpr integer<Bits, Signed> sub_sat(const integer<Bits, Signed> & lhs, const integer<Bits, Signed> & rhs) noexcept
+{
+    using Impl = typename integer<Bits, Signed>::_impl;
+    integer<Bits, Signed> res{};
+    if (!sub_overflow(lhs, rhs, &res))
+        return res;
+    if constexpr (std::is_same_v<Signed, signed>)
+        return Impl::is_negative(lhs) ? std::numeric_limits<integer<Bits, Signed>>::min()
+                                      : std::numeric_limits<integer<Bits, Signed>>::max();
+    else
+        return std::numeric_limits<integer<Bits, Signed>>::min();
+}
+
+template <size_t Bits, typename Signed>
+constexpr integer<Bits, Signed> mul_sat(const integer<Bits, Signed> & lhs, const integer<Bits, Signed> & rhs) noexcept
+{
+    using Impl = typename integer<Bits, Signed>::_impl;
+    integer<Bits, Signed> res{};
+    if (!mul_overflow(lhs, rhs, &res))
+        return res;
+    return Impl::is_negative(lhs) != Impl::is_negative(rhs) ? std::numeric_limits<integer<Bits, Signed>>::min()
+                                                            : std::numeric_limits<integer<Bits, Signed>>::max();
+}
+
+/// Integer wrapper whose arithmetic saturates instead of wrapping.
+template <size_t Bits, typename Signed>
+class saturating
+{
+public:
+    using value_type = integer<Bits, Signed>;
+
+    constexpr saturating() noexcept = default;
+    constexpr saturating(const value_type & v) noexcept
+        : value_(v)
+    {
+    }
+
+    constexpr const value_type & value() const noexcept { return value_; }
+
+    constexpr saturating & operator+=(const saturating & rhs) noexcept
+    {
+        value_ = add_sat(value_, rhs.value_);
+        return *this;
+    }
+
+    constexpr saturating & operator-=(const saturating & rhs) noexcept
+    {
+        value_ = sub_sat(value_, rhs.value_);
+        return *this;
+    }
+
+    constexpr saturating & operator*=(const saturating & rhs) noexcept
+    {
+        value_ = mul_sat(value_, rhs.value_);
+        return *this;
+    }
+
+    constexpr saturating & operator/=(const saturating & rhs)
+    {
+        /// min / -1 is the only quotient that does not fit.
+        if (std::is_same_v<Signed, signed> && value_ == std::numeric_limits<value_type>::min() && rhs.value_ == -1)
+            value_ = std::numeric_limits<value_type>::max();
+        else
+            value_ /= rhs.value_;
+        return *this;
+    }
+
+    friend constexpr saturating operator+(saturating lhs, const saturating & rhs) noexcept
+    {
+        lhs += rhs;
+        return lhs;
+    }
+
+    friend constexpr saturating operator-(saturating lhs, const saturating & rhs) noexcept
+    {
+        lhs -= rhs;
+        return lhs;
+    }
+
+    friend constexpr saturating operator*(saturating lhs, const saturating & rhs) noexcept
+    {
+        lhs *= rhs;
+        return lhs;
+    }
+
+    friend constexpr saturating operator/(saturating lhs, const saturating & rhs)
+    {
+        lhs /= rhs;
+        return lhs;
+    }
+
+    friend constexpr saturating operator-(const saturating & v) noexcept { return saturating() - v; }
+
+    friend constexpr bool operator==(const saturating & lhs, const saturating & rhs) noexcept { return lhs.value_ == rhs.value_; }
+    friend constexpr bool operator!=(const saturating & lhs, const saturating & rhs) noexcept { return lhs.value_ != rhs.value_; }
+    friend constexpr bool operator<(const saturating & lhs, const saturating & rhs) noexcept { return lhs.value_ < rhs.value_; }
+    friend constexpr bool operator>(const saturating & lhs, const saturating & rhs) noexcept { return lhs.value_ > rhs.value_; }
+    friend constexpr bool operator<=(const saturating & lhs, const saturating & rhs) noexcept { return lhs.value_ <= rhs.value_; }
+    friend constexpr bool operator>=(const saturating & lhs, const saturating & rhs) noexcept { return lhs.value_ >= rhs.value_; }
+
+private:
+    value_type value_{};
+};
+
 }
 #pragma clang attribute pop
 
@@ -2010,20 +2781,32 @@ namespace std
 template <size_t Bits, typename Signed>
 struct hash<wide::integer<Bits, Signed>>
 {
-    std::size_t operator()(const wide::integer<Bits, Signed> & lhs) const
+    /// Each pair of items, salted by its position, is multiplied to 128 bits and the halves folded,
+    /// so that every input bit affects the low bits open addressing tables use. The pairs are
+    /// independent and their products overlap. An XOR of the items would map all values with equal
+    /// items, e.g. x:x, to the same hash.
+    std::size_t operator()(const wide::integer<Bits, Signed> & lhs) const noexcept
     {
-        static_assert(Bits % (sizeof(size_t) * 8) == 0);
-
-        const auto * ptr = reinterpret_cast<const size_t *>(lhs.items);
-        unsigned count = Bits / (sizeof(size_t) * 8);
+        using Impl = typename wide::integer<Bits, Signed>::_impl;
 
-        size_t res = 0;
-        for (unsigned i = 0; i < count; ++i)
-            res ^= ptr[i];
-        return res;
+        uint64_t res = 0;
+        for (unsigned i = 0; i < Impl::item_count; i += 2)
+        {
+            const uint64_t salt = 0x9e3779b97f4a7c15ULL * (i + 1);
+            const uint64_t low = lhs.items[Impl::little(i)] ^ 0xa0761d6478bd642fULL ^ salt;
+            const uint64_t high = (i + 1 < Impl::item_count ? lhs.items[Impl::little(i + 1)] : 0) ^ 0xe7037ed1a0b428dbULL ^ salt;
+            const unsigned __int128 product = static_cast<unsigned __int128>(low) * high;
+            res ^= static_cast<uint64_t>(product) ^ static_cast<uint64_t>(product >> 64);
+        }
+        return static_cast<size_t>(res);
     }
 };
 
+template <size_t Bits, typename Signed, size_t Alignment>
+struct hash<wide::aligned_integer<Bits, Signed, Alignment>> : hash<wide::integer<Bits, Signed>>
+{
+};
+
 }
 
 // NOLINTEND(*)
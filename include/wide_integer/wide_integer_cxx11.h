@@ -4,8 +4,10 @@
 #include <climits>
 #include <cmath>
 #include <cstdint>
+#include <cstring>
 #include <limits>
 #include <ostream>
+#include <stdexcept>
 #include <string>
 #include <type_traits>
 #include <fmt/format.h>
@@ -72,8 +74,9 @@ struct limbs_equal<0>
     }
 };
 
+/// Returns the carry out of the most significant limb.
 template <size_t L>
-inline void add_limbs(uint64_t * lhs, const uint64_t * rhs) noexcept
+inline uint64_t add_limbs(uint64_t * lhs, const uint64_t * rhs) noexcept
 {
     unsigned __int128 carry = 0;
     for (size_t i = 0; i < L; ++i)
@@ -82,10 +85,11 @@ inline void add_limbs(uint64_t * lhs, const uint64_t * rhs) noexcept
         lhs[i] = static_cast<uint64_t>(sum);
         carry = sum >> 64;
     }
+    return static_cast<uint64_t>(carry);
 }
 
 template <>
-inline void add_limbs<4>(uint64_t * lhs, const uint64_t * rhs) noexcept
+inline uint64_t add_limbs<4>(uint64_t * lhs, const uint64_t * rhs) noexcept
 {
     unsigned __int128 sum;
     sum = static_cast<unsigned __int128>(lhs[0]) + rhs[0];
@@ -96,10 +100,12 @@ inline void add_limbs<4>(uint64_t * lhs, const uint64_t * rhs) noexcept
     lhs[2] = static_cast<uint64_t>(sum);
     sum = static_cast<unsigned __int128>(lhs[3]) + rhs[3] + (sum >> 64);
     lhs[3] = static_cast<uint64_t>(sum);
+    return static_cast<uint64_t>(sum >> 64);
 }
 
+/// Returns the borrow out of the most significant limb.
 template <size_t L>
-inline void sub_limbs(uint64_t * lhs, const uint64_t * rhs) noexcept
+inline uint64_t sub_limbs(uint64_t * lhs, const uint64_t * rhs) noexcept
 {
     unsigned __int128 borrow = 0;
     for (size_t i = 0; i < L; ++i)
@@ -109,10 +115,11 @@ inline void sub_limbs(uint64_t * lhs, const uint64_t * rhs) noexcept
         lhs[i] = static_cast<uint64_t>(lhs_i - subtrahend);
         borrow = lhs_i < subtrahend;
     }
+    return static_cast<uint64_t>(borrow);
 }
 
 template <>
-inline void sub_limbs<4>(uint64_t * lhs, const uint64_t * rhs) noexcept
+inline uint64_t sub_limbs<4>(uint64_t * lhs, const uint64_t * rhs) noexcept
 {
     unsigned __int128 borrow = 0;
     unsigned __int128 lhs0 = lhs[0];
@@ -133,6 +140,7 @@ inline void sub_limbs<4>(uint64_t * lhs, const uint64_t * rhs) noexcept
     unsigned __int128 lhs3 = lhs[3];
     unsigned __int128 rhs3 = static_cast<unsigned __int128>(rhs[3]) + borrow;
     lhs[3] = static_cast<uint64_t>(lhs3 - rhs3);
+    return lhs3 < rhs3;
 }
 
 inline void mul_128(uint64_t * res, const uint64_t * a, const uint64_t * b) noexcept
@@ -203,6 +211,58 @@ inline void mul_limbs<4>(uint64_t * res, const uint64_t * lhs, const uint64_t *
     res[2] = static_cast<uint64_t>(r12 >> 64);
 }
 
+/// res += lhs * rhs (Subtract: res -= lhs * rhs) modulo 2^(64 * L), one product row at a time.
+/// The high half of a product is at most 2^64 - 2 unless the low half is 0, so the carry flag fits.
+template <size_t L, bool Subtract>
+inline void mul_accumulate_row(uint64_t * res, size_t offset, uint64_t lhs, const uint64_t * rhs) noexcept
+{
+    uint64_t carry = 0;
+    for (size_t j = 0; j + offset < L; ++j)
+    {
+        unsigned __int128 cur = static_cast<unsigned __int128>(lhs) * rhs[j] + carry;
+        uint64_t low = static_cast<uint64_t>(cur);
+        carry = static_cast<uint64_t>(cur >> 64);
+        uint64_t & item = res[offset + j];
+        if (Subtract)
+        {
+            carry += item < low;
+            item -= low;
+        }
+        else
+        {
+            item += low;
+            carry += item < low;
+        }
+    }
+}
+
+template <size_t L, bool Subtract>
+inline void mul_accumulate(uint64_t * res, const uint64_t * lhs, const uint64_t * rhs) noexcept
+{
+    for (size_t i = 0; i < L; ++i)
+        if (lhs[i])
+            mul_accumulate_row<L, Subtract>(res, i, lhs[i], rhs);
+}
+
+/// Full product: `res` receives all 2 * L limbs of `lhs * rhs`.
+template <size_t L>
+inline void mul_limbs_full(uint64_t * res, const uint64_t * lhs, const uint64_t * rhs) noexcept
+{
+    for (size_t i = 0; i < L; ++i)
+        res[i] = 0;
+    for (size_t i = 0; i < L; ++i)
+    {
+        unsigned __int128 carry = 0;
+        for (size_t j = 0; j < L; ++j)
+        {
+            unsigned __int128 cur = static_cast<unsigned __int128>(res[i + j]) + static_cast<unsigned __int128>(lhs[i]) * rhs[j] + carry;
+            res[i + j] = static_cast<uint64_t>(cur);
+            carry = cur >> 64;
+        }
+        res[i + L] = static_cast<uint64_t>(carry);
+    }
+}
+
 template <size_t L>
 inline void mul_limb(uint64_t * lhs, uint64_t rhs) noexcept
 {
@@ -236,6 +296,28 @@ inline void mul_limb<4>(uint64_t * lhs, uint64_t rhs) noexcept
     lhs[1] = static_cast<uint64_t>(r12);
     lhs[2] = static_cast<uint64_t>(r12 >> 64);
 }
+
+/// Grants free functions outside of the class access to the limbs of an integer.
+struct limb_access
+{
+    template <typename Int>
+    static uint64_t * get(Int & v) noexcept
+    {
+        return v.data_;
+    }
+
+    template <typename Int>
+    static const uint64_t * get(const Int & v) noexcept
+    {
+        return v.data_;
+    }
+
+    template <size_t Bits, typename Signed>
+    static bool is_negative(const integer<Bits, Signed> & v) noexcept
+    {
+        return std::is_same<Signed, signed>::value && (v.data_[integer<Bits, Signed>::limbs - 1] >> 63);
+    }
+};
 } // namespace detail
 
 template <size_t Bits, typename Signed>
@@ -246,6 +328,7 @@ public:
     using limb_type = uint64_t;
     template <size_t>
     friend struct detail::limbs_equal;
+    friend struct detail::limb_access;
     friend class std::numeric_limits<integer<Bits, Signed>>;
 
     constexpr integer() noexcept = default;
@@ -343,24 +426,11 @@ public:
         return value;
     }
 
-    explicit operator long double() const noexcept
-    {
-        if (is_zero())
-            return 0;
-        bool neg = std::is_same<Signed, signed>::value && (data_[limbs - 1] >> 63);
-        integer tmp = neg ? -*this : *this;
-        long double res = 0;
-        for (size_t i = limbs; i-- > 0;)
-        {
-            res *= std::ldexp(1.0L, 64);
-            res += static_cast<long double>(tmp.data_[i]);
-        }
-        return neg ? -res : res;
-    }
+    explicit operator long double() const noexcept { return to_floating<long double>(); }
 
-    explicit operator double() const noexcept { return static_cast<double>(static_cast<long double>(*this)); }
+    explicit operator double() const noexcept { return to_floating<double>(); }
 
-    explicit operator float() const noexcept { return static_cast<float>(static_cast<long double>(*this)); }
+    explicit operator float() const noexcept { return to_floating<float>(); }
 
     integer & operator+=(const integer & rhs) noexcept
     {
@@ -413,29 +483,40 @@ public:
         return *this;
     }
 
+    /// Each limb is a funnel shift of two source limbs (SHLD/SHRD), written in an order that
+    /// never overwrites a limb before it is read.
     integer & operator<<=(int n) noexcept
     {
         if (n <= 0)
             return *this;
-        size_t limb_shift = static_cast<size_t>(n) / 64;
-        int bit_shift = n % 64;
-        if (limb_shift)
+        if (static_cast<size_t>(n) >= Bits)
         {
-            for (size_t i = limbs; i-- > limb_shift;)
-                data_[i] = data_[i - limb_shift];
-            for (size_t i = 0; i < limb_shift; ++i)
+            for (size_t i = 0; i < limbs; ++i)
                 data_[i] = 0;
+            return *this;
         }
-        if (bit_shift)
+        size_t limb_shift = static_cast<size_t>(n) / 64;
+        unsigned bit_shift = static_cast<unsigned>(n) % 64;
+        if (bit_shift && !limb_shift)
         {
-            for (size_t i = limbs; i-- > 0;)
-            {
-                unsigned __int128 part = static_cast<unsigned __int128>(data_[i]) << bit_shift;
-                if (i)
-                    part |= data_[i - 1] >> (64 - bit_shift);
-                data_[i] = static_cast<limb_type>(part);
-            }
+            // the common sub-limb shift, with a constant trip count that unrolls
+            for (size_t i = limbs - 1; i > 0; --i)
+                data_[i] = (data_[i] << bit_shift) | (data_[i - 1] >> (64 - bit_shift));
+            data_[0] <<= bit_shift;
+        }
+        else if (bit_shift)
+        {
+            for (size_t i = limbs - 1; i > limb_shift; --i)
+                data_[i] = (data_[i - limb_shift] << bit_shift) | (data_[i - limb_shift - 1] >> (64 - bit_shift));
+            data_[limb_shift] = data_[0] << bit_shift;
+        }
+        else
+        {
+            for (size_t i = limbs; i-- > limb_shift;)
+                data_[i] = data_[i - limb_shift];
         }
+        for (size_t i = 0; i < limb_shift; ++i)
+            data_[i] = 0;
         return *this;
     }
 
@@ -443,25 +524,34 @@ public:
     {
         if (n <= 0)
             return *this;
-        size_t limb_shift = static_cast<size_t>(n) / 64;
-        int bit_shift = n % 64;
-        if (limb_shift)
+        if (static_cast<size_t>(n) >= Bits)
         {
-            for (size_t i = 0; i < limbs - limb_shift; ++i)
-                data_[i] = data_[i + limb_shift];
-            for (size_t i = limbs - limb_shift; i < limbs; ++i)
+            for (size_t i = 0; i < limbs; ++i)
                 data_[i] = 0;
+            return *this;
+        }
+        size_t limb_shift = static_cast<size_t>(n) / 64;
+        unsigned bit_shift = static_cast<unsigned>(n) % 64;
+        size_t top = limbs - 1 - limb_shift;
+        if (bit_shift && !limb_shift)
+        {
+            for (size_t i = 0; i + 1 < limbs; ++i)
+                data_[i] = (data_[i] >> bit_shift) | (data_[i + 1] << (64 - bit_shift));
+            data_[limbs - 1] >>= bit_shift;
         }
-        if (bit_shift)
+        else if (bit_shift)
         {
-            for (size_t i = 0; i < limbs; ++i)
-            {
-                unsigned __int128 part = static_cast<unsigned __int128>(data_[i]) >> bit_shift;
-                if (i + 1 < limbs)
-                    part |= static_cast<unsigned __int128>(data_[i + 1]) << (64 - bit_shift);
-                data_[i] = static_cast<limb_type>(part);
-            }
+            for (size_t i = 0; i < top; ++i)
+                data_[i] = (data_[i + limb_shift] >> bit_shift) | (data_[i + limb_shift + 1] << (64 - bit_shift));
+            data_[top] = data_[limbs - 1] >> bit_shift;
         }
+        else
+        {
+            for (size_t i = 0; i <= top; ++i)
+                data_[i] = data_[i + limb_shift];
+        }
+        for (size_t i = top + 1; i < limbs; ++i)
+            data_[i] = 0;
         return *this;
     }
 
@@ -1078,31 +1168,90 @@ private:
         }
     }
 
+    /// Truncates towards zero; |v| < 2^64 * 2^(64 k) is split exactly into limbs k and k - 1.
     template <typename T>
     void assign_float(T v) noexcept
     {
+        if (v > static_cast<T>(-9223372036854775808.0) && v < static_cast<T>(9223372036854775808.0))
+        {
+            assign(static_cast<int64_t>(v));
+            return;
+        }
         for (size_t i = 0; i < limbs; ++i)
             data_[i] = 0;
-        if (v == 0)
+        if (!std::isfinite(v))
             return;
-        bool neg = v < 0;
-        if (neg)
-            v = -v;
-        long double val = static_cast<long double>(v);
-        long double intpart;
-        std::modf(val, &intpart);
-        val = intpart;
-        long double base = std::ldexp(1.0L, 64);
-        for (size_t i = 0; i < limbs && val > 0; ++i)
+
+        const T base = static_cast<T>(18446744073709551616.0);
+        const bool neg = v < 0;
+        T val = neg ? -v : v;
+        size_t index = 0;
+        while (val >= base)
         {
-            long double rem = std::fmod(val, base);
-            data_[i] = static_cast<limb_type>(rem);
-            val = std::floor(val / base);
+            val *= 1 / base;
+            ++index;
         }
+        const limb_type high = static_cast<limb_type>(val);
+        const limb_type low = static_cast<limb_type>((val - static_cast<T>(high)) * base);
+        if (index < limbs)
+            data_[index] = high;
+        if (index != 0 && index - 1 < limbs)
+            data_[index - 1] = low;
         if (neg)
             *this = -*this;
     }
 
+    /// Round to nearest, ties to even: the top 64 bits of the magnitude with a sticky bit for the
+    /// rest, scaled afterwards by exact powers of two.
+    template <typename F>
+    F to_floating() const noexcept
+    {
+        const bool neg = std::is_same<Signed, signed>::value && (data_[limbs - 1] >> 63);
+        const integer tmp = neg ? -*this : *this;
+        const limb_type * d = tmp.data_;
+        const F base = static_cast<F>(18446744073709551616.0);
+
+        size_t top = limbs;
+        while (top > 1 && d[top - 1] == 0)
+            --top;
+        F res;
+        if (top == 1)
+            res = static_cast<F>(d[0]);
+        else if (std::numeric_limits<F>::digits > 64)
+        {
+            res = 0;
+            for (size_t i = top; i-- > 0;)
+                res = res * base + static_cast<F>(d[i]);
+        }
+        else
+        {
+            const size_t t = top - 1;
+            const int lz = __builtin_clzll(d[t]);
+            limb_type mantissa = lz ? (d[t] << lz) | (d[t - 1] >> (64 - lz)) : d[t];
+            const limb_type rest = d[t - 1] << lz;
+            bool sticky = false;
+            for (size_t i = 0; i + 1 < t; ++i)
+                sticky |= d[i] != 0;
+
+            if (std::numeric_limits<F>::digits < 64)
+                res = static_cast<F>(mantissa | static_cast<limb_type>(rest != 0 || sticky));
+            else
+            {
+                const bool round = (rest >> 63) != 0;
+                sticky |= (rest << 1) != 0;
+                bool carry = false;
+                if (round && (sticky || (mantissa & 1)))
+                    carry = ++mantissa == 0;
+                res = carry ? base : static_cast<F>(mantissa);
+            }
+            F scale = base / static_cast<F>(1ULL << lz);
+            for (size_t i = 1; i < t; ++i)
+                scale *= base;
+            res *= scale;
+        }
+        return neg ? -res : res;
+    }
+
     bool is_zero() const noexcept
     {
         for (size_t i = 0; i < limbs; ++i)
@@ -1379,6 +1528,669 @@ inline std::ostream & operator<<(std::ostream & out, const integer<Bits, Signed>
     return out << to_string(value);
 }
 
+/// Counterparts of the <bit> functions for unsigned wide integers, each working limb by limb with the
+/// corresponding compiler intrinsic.
+template <size_t Bits>
+inline int popcount(const integer<Bits, unsigned> & x) noexcept
+{
+    const uint64_t * limbs = detail::limb_access::get(x);
+    int res = 0;
+    for (size_t i = 0; i < integer<Bits, unsigned>::limbs; ++i)
+    {
+#if defined(__POPCNT__)
+        res += __builtin_popcountll(limbs[i]);
+#else
+        /// Without the popcnt instruction the builtin becomes a library call per limb, the SWAR sum is faster.
+        uint64_t limb = limbs[i];
+        limb -= (limb >> 1) & 0x5555555555555555ULL;
+        limb = (limb & 0x3333333333333333ULL) + ((limb >> 2) & 0x3333333333333333ULL);
+        limb = (limb + (limb >> 4)) & 0x0F0F0F0F0F0F0F0FULL;
+        res += static_cast<int>((limb * 0x0101010101010101ULL) >> 56);
+#endif
+    }
+    return res;
+}
+
+template <size_t Bits>
+inline int countl_zero(const integer<Bits, unsigned> & x) noexcept
+{
+    const uint64_t * limbs = detail::limb_access::get(x);
+    for (size_t i = integer<Bits, unsigned>::limbs; i-- > 0;)
+    {
+        if (limbs[i])
+            return static_cast<int>((integer<Bits, unsigned>::limbs - 1 - i) * 64 + __builtin_clzll(limbs[i]));
+    }
+    return static_cast<int>(Bits);
+}
+
+template <size_t Bits>
+inline int countr_zero(const integer<Bits, unsigned> & x) noexcept
+{
+    const uint64_t * limbs = detail::limb_access::get(x);
+    for (size_t i = 0; i < integer<Bits, unsigned>::limbs; ++i)
+    {
+        if (limbs[i])
+            return static_cast<int>(i * 64 + __builtin_ctzll(limbs[i]));
+    }
+    return static_cast<int>(Bits);
+}
+
+template <size_t Bits>
+inline int countl_one(const integer<Bits, unsigned> & x) noexcept
+{
+    return countl_zero(~x);
+}
+
+template <size_t Bits>
+inline int countr_one(const integer<Bits, unsigned> & x) noexcept
+{
+    return countr_zero(~x);
+}
+
+template <size_t Bits>
+inline int bit_width(const integer<Bits, unsigned> & x) noexcept
+{
+    return static_cast<int>(Bits) - countl_zero(x);
+}
+
+template <size_t Bits>
+inline bool has_single_bit(const integer<Bits, unsigned> & x) noexcept
+{
+    return popcount(x) == 1;
+}
+
+/// Rotation to the left by `s` bits, to the right for negative `s`.
+template <size_t Bits>
+inline integer<Bits, unsigned> rotl(const integer<Bits, unsigned> & x, int s) noexcept
+{
+    const size_t count = integer<Bits, unsigned>::limbs;
+    const unsigned r = static_cast<unsigned>(((s % static_cast<int>(Bits)) + static_cast<int>(Bits)) % static_cast<int>(Bits));
+    const size_t limbs_shift = r / 64;
+    const unsigned bit_shift = r % 64;
+
+    const uint64_t * in = detail::limb_access::get(x);
+    integer<Bits, unsigned> res;
+    uint64_t * out = detail::limb_access::get(res);
+    for (size_t i = 0; i < count; ++i)
+    {
+        uint64_t limb = in[(i + count - limbs_shift) % count];
+        uint64_t lower = in[(i + count - limbs_shift - 1) % count];
+        out[i] = bit_shift ? (limb << bit_shift) | (lower >> (64 - bit_shift)) : limb;
+    }
+    return res;
+}
+
+template <size_t Bits>
+inline integer<Bits, unsigned> rotr(const integer<Bits, unsigned> & x, int s) noexcept
+{
+    return rotl(x, -(s % static_cast<int>(Bits)));
+}
+
+template <size_t Bits>
+inline integer<Bits, unsigned> byteswap(const integer<Bits, unsigned> & x) noexcept
+{
+    const size_t count = integer<Bits, unsigned>::limbs;
+    const uint64_t * in = detail::limb_access::get(x);
+    integer<Bits, unsigned> res;
+    uint64_t * out = detail::limb_access::get(res);
+    for (size_t i = 0; i < count; ++i)
+        out[i] = __builtin_bswap64(in[count - 1 - i]);
+    return res;
+}
+
+/// x << N and x >> N for a shift count known at compile time, with the same results as the operators.
+/// The limb offset and bit offset are constants, so the loops unroll into plain limb moves (N a multiple
+/// of 64) or one funnel shift per limb.
+template <unsigned N, size_t Bits, typename Signed>
+inline integer<Bits, Signed> shl(const integer<Bits, Signed> & x) noexcept
+{
+    const size_t count = integer<Bits, Signed>::limbs;
+    const size_t limb_shift = N / 64;
+    const unsigned bit_shift = N % 64;
+
+    const uint64_t * in = detail::limb_access::get(x);
+    integer<Bits, Signed> res{};
+    uint64_t * out = detail::limb_access::get(res);
+    if (N >= Bits)
+        return res;
+    for (size_t i = limb_shift; i < count; ++i)
+    {
+        if (!bit_shift)
+            out[i] = in[i - limb_shift];
+        else if (i == limb_shift)
+            out[i] = in[0] << bit_shift;
+        else
+            out[i] = (in[i - limb_shift] << bit_shift) | (in[i - limb_shift - 1] >> ((64 - bit_shift) % 64));
+    }
+    return res;
+}
+
+template <unsigned N, size_t Bits, typename Signed>
+inline integer<Bits, Signed> shr(const integer<Bits, Signed> & x) noexcept
+{
+    const size_t count = integer<Bits, Signed>::limbs;
+    const size_t limb_shift = N / 64;
+    const unsigned bit_shift = N % 64;
+
+    const uint64_t * in = detail::limb_access::get(x);
+    integer<Bits, Signed> res{};
+    uint64_t * out = detail::limb_access::get(res);
+    if (N >= Bits)
+        return res;
+    for (size_t i = 0; i + limb_shift < count; ++i)
+    {
+        if (!bit_shift)
+            out[i] = in[i + limb_shift];
+        else if (i + limb_shift + 1 == count)
+            out[i] = in[count - 1] >> bit_shift;
+        else
+            out[i] = (in[i + limb_shift] >> bit_shift) | (in[i + limb_shift + 1] << ((64 - bit_shift) % 64));
+    }
+    return res;
+}
+
+namespace detail
+{
+
+/// An unaligned 64-bit word in little-endian order (`big` = false) or big-endian order.
+inline uint64_t load_word(const uint8_t * bytes, bool big) noexcept
+{
+    uint64_t word;
+    std::memcpy(&word, bytes, sizeof(word));
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+    return big ? word : __builtin_bswap64(word);
+#else
+    return big ? __builtin_bswap64(word) : word;
+#endif
+}
+
+inline void store_word(uint8_t * bytes, uint64_t word, bool big) noexcept
+{
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+    word = big ? word : __builtin_bswap64(word);
+#else
+    word = big ? __builtin_bswap64(word) : word;
+#endif
+    std::memcpy(bytes, &word, sizeof(word));
+}
+
+}
+
+/// Serialization to and from Bits / 8 bytes in little- or big-endian order, as in binary protocols
+/// with 256-bit words. Each limb is one unaligned copy, byte swapped when the order differs from the
+/// host's. Use as `wide::load_be<UInt256>(bytes)`.
+template <size_t Bits, typename Signed>
+inline void store_le(const integer<Bits, Signed> & x, uint8_t * out) noexcept
+{
+    const uint64_t * limbs = detail::limb_access::get(x);
+    for (size_t i = 0; i < integer<Bits, Signed>::limbs; ++i)
+        detail::store_word(out + i * 8, limbs[i], false);
+}
+
+template <size_t Bits, typename Signed>
+inline void store_be(const integer<Bits, Signed> & x, uint8_t * out) noexcept
+{
+    const size_t count = integer<Bits, Signed>::limbs;
+    const uint64_t * limbs = detail::limb_access::get(x);
+    for (size_t i = 0; i < count; ++i)
+        detail::store_word(out + i * 8, limbs[count - 1 - i], true);
+}
+
+template <typename Integer>
+inline Integer load_le(const uint8_t * in) noexcept
+{
+    Integer x;
+    uint64_t * limbs = detail::limb_access::get(x);
+    for (size_t i = 0; i < Integer::limbs; ++i)
+        limbs[i] = detail::load_word(in + i * 8, false);
+    return x;
+}
+
+template <typename Integer>
+inline Integer load_be(const uint8_t * in) noexcept
+{
+    const size_t count = Integer::limbs;
+    Integer x;
+    uint64_t * limbs = detail::limb_access::get(x);
+    for (size_t i = 0; i < count; ++i)
+        limbs[count - 1 - i] = detail::load_word(in + i * 8, true);
+    return x;
+}
+
+/// An integer is exactly its Bits / 64 limbs and nothing else: it can be copied with memcpy, written
+/// to disk and mapped back. The limbs are stored least significant first on every host.
+template <size_t Bits, typename Signed>
+struct has_plain_layout
+{
+    static constexpr bool value = std::is_trivially_copyable<integer<Bits, Signed> >::value
+        && std::is_standard_layout<integer<Bits, Signed> >::value && sizeof(integer<Bits, Signed>) == Bits / 8
+        && alignof(integer<Bits, Signed>) == alignof(uint64_t);
+};
+
+static_assert(has_plain_layout<128, unsigned>::value && has_plain_layout<128, signed>::value, "layout");
+static_assert(has_plain_layout<256, unsigned>::value && has_plain_layout<256, signed>::value, "layout");
+static_assert(has_plain_layout<512, unsigned>::value && has_plain_layout<1024, signed>::value, "layout");
+
+/// A view of the limbs of an integer in memory order, see has_plain_layout.
+template <typename T>
+class limb_span
+{
+public:
+    constexpr limb_span(T * data, size_t size) noexcept : data_(data), size_(size) { }
+
+    constexpr T * data() const noexcept { return data_; }
+    constexpr size_t size() const noexcept { return size_; }
+    constexpr T * begin() const noexcept { return data_; }
+    constexpr T * end() const noexcept { return data_ + size_; }
+    constexpr T & operator[](size_t i) const noexcept { return data_[i]; }
+
+private:
+    T * data_;
+    size_t size_;
+};
+
+template <size_t Bits, typename Signed>
+limb_span<uint64_t> limbs(integer<Bits, Signed> & x) noexcept
+{
+    static_assert(has_plain_layout<Bits, Signed>::value, "layout");
+    return limb_span<uint64_t>(detail::limb_access::get(x), Bits / 64);
+}
+
+template <size_t Bits, typename Signed>
+limb_span<const uint64_t> limbs(const integer<Bits, Signed> & x) noexcept
+{
+    static_assert(has_plain_layout<Bits, Signed>::value, "layout");
+    return limb_span<const uint64_t>(detail::limb_access::get(x), Bits / 64);
+}
+
+namespace detail
+{
+/// The size rounded up to a power of two, at most a cache line.
+constexpr size_t natural_alignment(size_t size, size_t alignment = alignof(uint64_t)) noexcept
+{
+    return alignment < size && alignment < 64 ? natural_alignment(size, alignment * 2) : alignment;
+}
+}
+
+/// An integer over-aligned to `Alignment` bytes, by default its size rounded up to a power of two
+/// and capped at 64. Arrays and hash table slots of aligned 128- and 256-bit values never straddle a
+/// cache line. It converts to and from integer<Bits, Signed> implicitly; arithmetic yields plain
+/// integers.
+template <size_t Bits, typename Signed, size_t Alignment = detail::natural_alignment(Bits / 8)>
+class alignas(Alignment) aligned_integer : public integer<Bits, Signed>
+{
+public:
+    using integer<Bits, Signed>::integer;
+
+    constexpr aligned_integer() noexcept = default;
+    constexpr aligned_integer(const integer<Bits, Signed> & x) noexcept : integer<Bits, Signed>(x) { }
+
+    aligned_integer & operator=(const integer<Bits, Signed> & x) noexcept
+    {
+        integer<Bits, Signed>::operator=(x);
+        return *this;
+    }
+};
+
+/// Overflow-reporting arithmetic in the spirit of `__builtin_*_overflow`: `*res` always receives the
+/// wrapped result and the return value tells whether the mathematically exact result did not fit.
+/// The flag is derived from the carry/borrow of the same limb pass that produces the result.
+template <size_t Bits, typename Signed>
+inline bool add_overflow(const integer<Bits, Signed> & lhs, const integer<Bits, Signed> & rhs, integer<Bits, Signed> * res) noexcept
+{
+    typedef detail::limb_access access;
+    bool lhs_neg = access::is_negative(lhs);
+    bool rhs_neg = access::is_negative(rhs);
+    integer<Bits, Signed> addend = rhs;
+    *res = lhs;
+    uint64_t carry = detail::add_limbs<integer<Bits, Signed>::limbs>(access::get(*res), access::get(addend));
+    if (std::is_same<Signed, signed>::value)
+        return lhs_neg == rhs_neg && access::is_negative(*res) != lhs_neg;
+    return carry != 0;
+}
+
+template <size_t Bits, typename Signed>
+inline bool sub_overflow(const integer<Bits, Signed> & lhs, const integer<Bits, Signed> & rhs, integer<Bits, Signed> * res) noexcept
+{
+    typedef detail::limb_access access;
+    bool lhs_neg = access::is_negative(lhs);
+    bool rhs_neg = access::is_negative(rhs);
+    integer<Bits, Signed> subtrahend = rhs;
+    *res = lhs;
+    uint64_t borrow = detail::sub_limbs<integer<Bits, Signed>::limbs>(access::get(*res), access::get(subtrahend));
+    if (std::is_same<Signed, signed>::value)
+        return lhs_neg != rhs_neg && access::is_negative(*res) != lhs_neg;
+    return borrow != 0;
+}
+
+template <size_t Bits, typename Signed>
+inline bool mul_overflow(const integer<Bits, Signed> & lhs, const integer<Bits, Signed> & rhs, integer<Bits, Signed> * res) noexcept
+{
+    typedef detail::limb_access access;
+    const size_t L = integer<Bits, Signed>::limbs;
+    bool lhs_neg = access::is_negative(lhs);
+    bool rhs_neg = access::is_negative(rhs);
+    integer<Bits, Signed> a = lhs_neg ? -lhs : lhs;
+    integer<Bits, Signed> b = rhs_neg ? -rhs : rhs;
+
+    uint64_t full[2 * L];
+    detail::mul_limbs_full<L>(full, access::get(a), access::get(b));
+
+    uint64_t high = 0;
+    for (size_t i = L; i < 2 * L; ++i)
+        high |= full[i];
+    uint64_t * out = access::get(*res);
+    for (size_t i = 0; i < L; ++i)
+        out[i] = full[i];
+
+    bool overflow = high != 0;
+    if (std::is_same<Signed, signed>::value)
+    {
+        /// The magnitude must stay below 2^(Bits - 1), except for exactly 2^(Bits - 1) with a negative sign.
+        if (out[L - 1] >> 63)
+        {
+            uint64_t rest = out[L - 1] << 1;
+            for (size_t i = 0; i + 1 < L; ++i)
+                rest |= out[i];
+            overflow = overflow || !(lhs_neg != rhs_neg && rest == 0);
+        }
+        if (lhs_neg != rhs_neg)
+            *res = -*res;
+    }
+    return overflow;
+}
+
+/// Widening multiplication: the exact product in twice the width, never overflows.
+template <size_t Bits, typename Signed>
+inline integer<Bits * 2, Signed> mul_wide(const integer<Bits, Signed> & lhs, const integer<Bits, Signed> & rhs) noexcept
+{
+    typedef detail::limb_access access;
+    bool lhs_neg = access::is_negative(lhs);
+    bool rhs_neg = access::is_negative(rhs);
+    integer<Bits, Signed> a = lhs_neg ? -lhs : lhs;
+    integer<Bits, Signed> b = rhs_neg ? -rhs : rhs;
+
+    integer<Bits * 2, Signed> res;
+    detail::mul_limbs_full<integer<Bits, Signed>::limbs>(access::get(res), access::get(a), access::get(b));
+    if (lhs_neg != rhs_neg)
+        res = -res;
+    return res;
+}
+
+/// Fused multiply-add: lhs * rhs + addend, wrapped to Bits like the separate operators. The product
+/// is accumulated straight into the result without a temporary for it, and only its low Bits are formed.
+template <size_t Bits, typename Signed>
+inline integer<Bits, Signed>
+fma(const integer<Bits, Signed> & lhs, const integer<Bits, Signed> & rhs, const integer<Bits, Signed> & addend) noexcept
+{
+    typedef detail::limb_access access;
+    integer<Bits, Signed> res = addend;
+    detail::mul_accumulate<integer<Bits, Signed>::limbs, false>(access::get(res), access::get(lhs), access::get(rhs));
+    return res;
+}
+
+/// acc += lhs * rhs in one pass, wrapped to Bits. `acc` may not be one of the factors.
+template <size_t Bits, typename Signed>
+inline void mul_add(integer<Bits, Signed> & acc, const integer<Bits, Signed> & lhs, const integer<Bits, Signed> & rhs) noexcept
+{
+    typedef detail::limb_access access;
+    detail::mul_accumulate<integer<Bits, Signed>::limbs, false>(access::get(acc), access::get(lhs), access::get(rhs));
+}
+
+/// acc -= lhs * rhs in one pass, wrapped to Bits. `acc` may not be one of the factors.
+template <size_t Bits, typename Signed>
+inline void mul_sub(integer<Bits, Signed> & acc, const integer<Bits, Signed> & lhs, const integer<Bits, Signed> & rhs) noexcept
+{
+    typedef detail::limb_access access;
+    detail::mul_accumulate<integer<Bits, Signed>::limbs, true>(access::get(acc), access::get(lhs), access::get(rhs));
+}
+
+/// acc += x * k for an unsigned 64-bit k in a single row, wrapped to Bits. `acc` may not be `x`.
+template <size_t Bits, typename Signed>
+inline void add_mul_scalar(integer<Bits, Signed> & acc, const integer<Bits, Signed> & x, uint64_t k) noexcept
+{
+    typedef detail::limb_access access;
+    detail::mul_accumulate_row<integer<Bits, Signed>::limbs, false>(access::get(acc), 0, k, access::get(x));
+}
+
+/// Overflow policy for `checked`: throw `std::overflow_error` on the first overflow.
+struct throw_on_overflow
+{
+    static void on_overflow(const char * what) { throw std::overflow_error(what); }
+};
+
+/// Overflow policy for `checked`: keep the wrapped value and only set the sticky overflow flag.
+struct record_overflow
+{
+    static void on_overflow(const char *) noexcept { }
+};
+
+/// Integer wrapper that detects overflow of every arithmetic operation.
+/// The overflow flag is sticky: it is propagated through all values derived from an overflowed one.
+template <size_t Bits, typename Signed, typename OverflowPolicy = throw_on_overflow>
+class checked
+{
+public:
+    typedef integer<Bits, Signed> value_type;
+
+    checked() noexcept
+        : value_()
+        , overflowed_(false)
+    {
+    }
+
+    checked(const value_type & v) noexcept
+        : value_(v)
+        , overflowed_(false)
+    {
+    }
+
+    const value_type & value() const noexcept { return value_; }
+    bool overflowed() const noexcept { return overflowed_; }
+
+    checked & operator+=(const checked & rhs)
+    {
+        overflowed_ = overflowed_ || rhs.overflowed_;
+        report(add_overflow(value_, rhs.value_, &value_), "wide::checked: addition overflow");
+        return *this;
+    }
+
+    checked & operator-=(const checked & rhs)
+    {
+        overflowed_ = overflowed_ || rhs.overflowed_;
+        report(sub_overflow(value_, rhs.value_, &value_), "wide::checked: subtraction overflow");
+        return *this;
+    }
+
+    checked & operator*=(const checked & rhs)
+    {
+        overflowed_ = overflowed_ || rhs.overflowed_;
+        report(mul_overflow(value_, rhs.value_, &value_), "wide::checked: multiplication overflow");
+        return *this;
+    }
+
+    checked & operator/=(const checked & rhs)
+    {
+        overflowed_ = overflowed_ || rhs.overflowed_;
+        if (!rhs.value_)
+            throw std::runtime_error("Division by zero");
+        /// min / -1 is the only quotient that does not fit; it wraps back to min.
+        bool overflow = std::is_same<Signed, signed>::value && value_ == std::numeric_limits<value_type>::min() && rhs.value_ == -1;
+        value_ = overflow ? value_ : value_ / rhs.value_;
+        report(overflow, "wide::checked: division overflow");
+        return *this;
+    }
+
+    friend checked operator+(checked lhs, const checked & rhs)
+    {
+        lhs += rhs;
+        return lhs;
+    }
+
+    friend checked operator-(checked lhs, const checked & rhs)
+    {
+        lhs -= rhs;
+        return lhs;
+    }
+
+    friend checked operator*(checked lhs, const checked & rhs)
+    {
+        lhs *= rhs;
+        return lhs;
+    }
+
+    friend checked operator/(checked lhs, const checked & rhs)
+    {
+        lhs /= rhs;
+        return lhs;
+    }
+
+    friend checked operator-(const checked & v)
+    {
+        checked res;
+        res -= v;
+        return res;
+    }
+
+    friend bool operator==(const checked & lhs, const checked & rhs) noexcept { return lhs.value_ == rhs.value_; }
+    friend bool operator!=(const checked & lhs, const checked & rhs) noexcept { return lhs.value_ != rhs.value_; }
+    friend bool operator<(const checked & lhs, const checked & rhs) noexcept { return lhs.value_ < rhs.value_; }
+    friend bool operator>(const checked & lhs, const checked & rhs) noexcept { return lhs.value_ > rhs.value_; }
+    friend bool operator<=(const checked & lhs, const checked & rhs) noexcept { return lhs.value_ <= rhs.value_; }
+    friend bool operator>=(const checked & lhs, const checked & rhs) noexcept { return lhs.value_ >= rhs.value_; }
+
+private:
+    void report(bool overflow, const char * what)
+    {
+        if (!overflow)
+            return;
+        overflowed_ = true;
+        OverflowPolicy::on_overflow(what);
+    }
+
+    value_type value_;
+    bool overflowed_;
+};
+
+/// Saturating arithmetic: results that do not fit are clamped to numeric_limits<>::min()/max().
+/// The direction of the clamp follows from the operand signs, so no widening is needed.
+template <size_t Bits, typename Signed>
+inline integer<Bits, Signed> add_sat(const integer<Bits, Signed> & lhs, const integer<Bits, Signed> & rhs) noexcept
+{
+    integer<Bits, Signed> res;
+    if (!add_overflow(lhs, rhs, &res))
+        return res;
+    if (detail::limb_access::is_negative(lhs))
+        return std::numeric_limits<integer<Bits, Signed> >::min();
+    return std::numeric_limits<integer<Bits, Signed> >::max();
+}
+
+template <size_t Bits, typename Signed>
+inline integer<Bits, Signed> sub_sat(const integer<Bits, Signed> & lhs, const integer<Bits, Signed> & rhs) noexcept
+{
+    integer<Bits, Signed> res;
+    if (!sub_overflow(lhs, rhs, &res))
+        return res;
+    if (!std::is_same<Signed, signed>::value || detail::limb_access::is_negative(lhs))
+        return std::numeric_limits<integer<Bits, Signed> >::min();
+    return std::numeric_limits<integer<Bits, Signed> >::max();
+}
+
+template <size_t Bits, typename Signed>
+inline integer<Bits, Signed> mul_sat(const integer<Bits, Signed> & lhs, const integer<Bits, Signed> & rhs) noexcept
+{
+    integer<Bits, Signed> res;
+    if (!mul_overflow(lhs, rhs, &res))
+        return res;
+    if (detail::limb_access::is_negative(lhs) != detail::limb_access::is_negative(rhs))
+        return std::numeric_limits<integer<Bits, Signed> >::min();
+    return std::numeric_limits<integer<Bits, Signed> >::max();
+}
+
+/// Integer wrapper whose arithmetic saturates instead of wrapping.
+template <size_t Bits, typename Signed>
+class saturating
+{
+public:
+    typedef integer<Bits, Signed> value_type;
+
+    saturating() noexcept
+        : value_()
+    {
+    }
+
+    saturating(const value_type & v) noexcept
+        : value_(v)
+    {
+    }
+
+    const value_type & value() const noexcept { return value_; }
+
+    saturating & operator+=(const saturating & rhs) noexcept
+    {
+        value_ = add_sat(value_, rhs.value_);
+        return *this;
+    }
+
+    saturating & operator-=(const saturating & rhs) noexcept
+    {
+        value_ = sub_sat(value_, rhs.value_);
+        return *this;
+    }
+
+    saturating & operator*=(const saturating & rhs) noexcept
+    {
+        value_ = mul_sat(value_, rhs.value_);
+        return *this;
+    }
+
+    saturating & operator/=(const saturating & rhs) noexcept
+    {
+        /// min / -1 is the only quotient that does not fit.
+        if (std::is_same<Signed, signed>::value && value_ == std::numeric_limits<value_type>::min() && rhs.value_ == -1)
+            value_ = std::numeric_limits<value_type>::max();
+        else
+            value_ = value_ / rhs.value_;
+        return *this;
+    }
+
+    friend saturating operator+(saturating lhs, const saturating & rhs) noexcept
+    {
+        lhs += rhs;
+        return lhs;
+    }
+
+    friend saturating operator-(saturating lhs, const saturating & rhs) noexcept
+    {
+        lhs -= rhs;
+        return lhs;
+    }
+
+    friend saturating operator*(saturating lhs, const saturating & rhs) noexcept
+    {
+        lhs *= rhs;
+        return lhs;
+    }
+
+    friend saturating operator/(saturating lhs, const saturating & rhs) noexcept
+    {
+        lhs /= rhs;
+        return lhs;
+    }
+
+    friend saturating operator-(const saturating & v) noexcept { return saturating() - v; }
+
+    friend bool operator==(const saturating & lhs, const saturating & rhs) noexcept { return lhs.value_ == rhs.value_; }
+    friend bool operator!=(const saturating & lhs, const saturating & rhs) noexcept { return lhs.value_ != rhs.value_; }
+    friend bool operator<(const saturating & lhs, const saturating & rhs) noexcept { return lhs.value_ < rhs.value_; }
+    friend bool operator>(const saturating & lhs, const saturating & rhs) noexcept { return lhs.value_ > rhs.value_; }
+    friend bool operator<=(const saturating & lhs, const saturating & rhs) noexcept { return lhs.value_ <= rhs.value_; }
+    friend bool operator>=(const saturating & lhs, const saturating & rhs) noexcept { return lhs.value_ >= rhs.value_; }
+
+private:
+    value_type value_;
+};
+
 } // namespace wide
 
 namespace fmt
@@ -0,0 +1,143 @@
+#include <cstdint>
+#include <thread>
+#include <vector>
+#include <gtest/gtest.h>
+#include <wide_integer/atomic.h>
+
+namespace
+{
+
+using U128 = wide::integer<128, unsigned>;
+using S128 = wide::integer<128, signed>;
+using U256 = wide::integer<256, unsigned>;
+using S256 = wide::integer<256, signed>;
+using S512 = wide::integer<512, signed>;
+
+template <typename F>
+void run_threads(unsigned count, F && f)
+{
+    std::vector<std::thread> threads;
+    for (unsigned t = 0; t < count; ++t)
+        threads.emplace_back([&f, t] { f(t); });
+    for (auto & thread : threads)
+        thread.join();
+}
+
+template <typename T>
+void expect_single_threaded()
+{
+    const T low_max = T(~uint64_t(0));
+    wide::atomic<T> x(low_max);
+    EXPECT_EQ(x.load(), low_max);
+
+    /// The carry crosses the item boundary.
+    EXPECT_EQ(x.fetch_add(T(1)), low_max);
+    EXPECT_EQ(x.load(), T(1) << 64);
+    EXPECT_EQ(x -= T(1), low_max);
+    EXPECT_EQ(x += T(2), (T(1) << 64) + T(1));
+
+    T expected = 5;
+    EXPECT_FALSE(x.compare_exchange_strong(expected, T(7)));
+    EXPECT_EQ(expected, (T(1) << 64) + T(1));
+    EXPECT_TRUE(x.compare_exchange_weak(expected, T(7)));
+    EXPECT_EQ(x.load(), T(7));
+
+    EXPECT_EQ(x.exchange(T(9) << 100), T(7));
+    x.store(T(3));
+    EXPECT_EQ(x.load(), T(3));
+
+    wide::atomic<T> zero;
+    EXPECT_EQ(zero.load(), T(0));
+}
+
+}
+
+TEST(WideIntegerAtomic, SingleThreaded)
+{
+    expect_single_threaded<U128>();
+    expect_single_threaded<S128>();
+    expect_single_threaded<U256>();
+    expect_single_threaded<S512>();
+
+    wide::atomic<S128> s(S128(0));
+    s.fetch_sub(S128(5));
+    EXPECT_EQ(s.load(), S128(-5));
+
+    /// load() on a const atomic, including a constant-initialized one that could sit in read-only data.
+    static const wide::atomic<U128> constant_zero;
+    EXPECT_EQ(constant_zero.load(), U128(0));
+    const wide::atomic<U128> constant(U128(1) << 100);
+    EXPECT_EQ(constant.load(), U128(1) << 100);
+    const wide::atomic<U256> constant_wide(U256(7));
+    EXPECT_EQ(constant_wide.load(), U256(7));
+
+#if defined(__x86_64__)
+    EXPECT_TRUE(wide::atomic<U128>::is_always_lock_free);
+#endif
+    EXPECT_FALSE(wide::atomic<U256>::is_always_lock_free);
+}
+
+TEST(WideIntegerAtomic, ConcurrentAdd)
+{
+    constexpr unsigned threads = 4;
+    constexpr unsigned steps = 20000;
+    /// Each step carries into the high item and back, so torn updates would show.
+    const U128 step128 = (U128(1) << 64) - U128(1);
+    const U256 step256 = (U256(1) << 192) + (U256(1) << 64) - U256(1);
+
+    wide::atomic<U128> a;
+    wide::atomic<U256> b;
+    run_threads(threads, [&](unsigned) {
+        for (unsigned i = 0; i < steps; ++i)
+        {
+            a.fetch_add(step128);
+            b += step256;
+            const U256 seen = b.load();
+            ASSERT_EQ(seen % step256, U256(0));
+        }
+    });
+    EXPECT_EQ(a.load(), step128 * U128(threads * steps));
+    EXPECT_EQ(b.load(), step256 * U256(threads * steps));
+}
+
+TEST(WideIntegerAtomic, ConcurrentCompareExchange)
+{
+    constexpr unsigned threads = 4;
+    constexpr unsigned steps = 5000;
+    wide::atomic<U256> x(U256(1) << 200);
+    run_threads(threads, [&](unsigned) {
+        for (unsigned i = 0; i < steps; ++i)
+        {
+            U256 expected = x.load();
+            while (!x.compare_exchange_weak(expected, expected + U256(3)))
+            {
+            }
+        }
+    });
+    EXPECT_EQ(x.load(), (U256(1) << 200) + U256(3 * threads * steps));
+}
+
+TEST(WideIntegerAtomic, ShardedCounter)
+{
+    wide::sharded_counter<256, signed> counter(5);
+    EXPECT_EQ(counter.shards(), 8U);
+    EXPECT_EQ(counter.value(), S256(0));
+
+    constexpr unsigned threads = 6;
+    constexpr unsigned steps = 10000;
+    const S256 big = S256(1) << 130;
+    run_threads(threads, [&](unsigned t) {
+        for (unsigned i = 0; i < steps; ++i)
+        {
+            counter.add(big);
+            if (t % 2)
+                counter.sub(S256(1));
+        }
+    });
+    EXPECT_EQ(counter.value(), big * S256(threads * steps) - S256(threads / 2 * steps));
+
+    counter.reset();
+    EXPECT_EQ(counter.value(), S256(0));
+    const wide::sharded_counter<128, unsigned> by_default;
+    EXPECT_GE(by_default.shards(), 1U);
+}
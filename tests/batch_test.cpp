@@ -0,0 +1,160 @@
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <vector>
+#include <gtest/gtest.h>
+#include <wide_integer/batch.h>
+
+TEST(WideIntegerBatch, WrappingArithmetic)
+{
+    using U = wide::integer<256, unsigned>;
+    std::vector<U> a = {U(1), U(1) << 200, std::numeric_limits<U>::max()};
+    std::vector<U> b = {U(2), U(3), U(1)};
+    std::vector<U> res(a.size());
+
+    wide::batch::add(a.data(), b.data(), res.data(), a.size());
+    for (size_t i = 0; i < a.size(); ++i)
+        EXPECT_EQ(res[i], a[i] + b[i]);
+
+    wide::batch::sub(a.data(), b.data(), res.data(), a.size());
+    for (size_t i = 0; i < a.size(); ++i)
+        EXPECT_EQ(res[i], a[i] - b[i]);
+
+    wide::batch::mul(a.data(), b.data(), res.data(), a.size());
+    for (size_t i = 0; i < a.size(); ++i)
+        EXPECT_EQ(res[i], a[i] * b[i]);
+}
+
+TEST(WideIntegerBatch, Saturating)
+{
+    using S = wide::integer<256, signed>;
+    const S min = std::numeric_limits<S>::min();
+    const S max = std::numeric_limits<S>::max();
+    std::vector<S> a = {S(5), max, min, S(-7), max - S(1)};
+    std::vector<S> b = {S(-9), S(1), S(-1), S(3), S(1)};
+    std::vector<S> res(a.size());
+
+    EXPECT_EQ(wide::batch::add_sat(a.data(), b.data(), res.data(), a.size()), 2U);
+    EXPECT_EQ(res, (std::vector<S>{S(-4), max, min, S(-4), max}));
+
+    EXPECT_EQ(wide::batch::sub_sat(a.data(), b.data(), res.data(), a.size()), 0U);
+    EXPECT_EQ(res, (std::vector<S>{S(14), max - S(1), min + S(1), S(-10), max - S(2)}));
+
+    EXPECT_EQ(wide::batch::mul_sat(a.data(), b.data(), res.data(), a.size()), 1U);
+    EXPECT_EQ(res, (std::vector<S>{S(-45), max, max, S(-21), max - S(1)}));
+
+    /// In-place update of an accumulator column.
+    std::vector<S> acc = {max, S(0), min};
+    std::vector<S> delta = {S(10), S(10), S(-10)};
+    EXPECT_EQ(wide::batch::add_sat(acc.data(), delta.data(), acc.data(), acc.size()), 2U);
+    EXPECT_EQ(acc, (std::vector<S>{max, S(10), min}));
+    EXPECT_EQ(wide::batch::sub_sat(acc.data(), delta.data(), acc.data(), acc.size()), 0U);
+    EXPECT_EQ(acc, (std::vector<S>{max - S(10), S(0), min + S(10)}));
+}
+
+TEST(WideIntegerBatch, DoubleConversion)
+{
+    using S = wide::integer<256, signed>;
+    const S big = (S(1) << 200) + (S(1) << 147) + S(1);
+    std::vector<S> values = {S(0), S(-42), big, -big, std::numeric_limits<S>::min()};
+    std::vector<double> doubles(values.size());
+
+    wide::batch::to_double(values.data(), doubles.data(), values.size());
+    for (size_t i = 0; i < values.size(); ++i)
+        EXPECT_EQ(doubles[i], static_cast<double>(values[i]));
+    EXPECT_EQ(doubles[2], std::ldexp(1.0, 200) + std::ldexp(1.0, 148));
+
+    std::vector<S> back(values.size());
+    wide::batch::from_double(doubles.data(), back.data(), doubles.size());
+    const S rounded = (S(1) << 200) + (S(1) << 148);
+    const std::vector<S> expected{S(0), S(-42), rounded, -rounded, std::numeric_limits<S>::min()};
+    EXPECT_EQ(back, expected);
+}
+
+template <typename To, typename From>
+static void expect_convert(const std::vector<From> & in)
+{
+    std::vector<To> out(in.size());
+    wide::batch::convert(in.data(), out.data(), in.size());
+    for (size_t i = 0; i < in.size(); ++i)
+        EXPECT_EQ(out[i], static_cast<To>(in[i])) << i;
+}
+
+TEST(WideIntegerBatch, Convert)
+{
+    using S128 = wide::integer<128, signed>;
+    using U128 = wide::integer<128, unsigned>;
+    using S256 = wide::integer<256, signed>;
+    using U256 = wide::integer<256, unsigned>;
+    using S512 = wide::integer<512, signed>;
+
+    const std::vector<int64_t> narrow = {0, -1, 42, std::numeric_limits<int64_t>::min(), std::numeric_limits<int64_t>::max()};
+    expect_convert<S256>(narrow);
+    expect_convert<U256>(narrow);
+    expect_convert<S128>(narrow);
+    expect_convert<__int128>(std::vector<S256>{S256(-5), S256(1) << 100, std::numeric_limits<S256>::min()});
+    expect_convert<int32_t>(std::vector<S256>{S256(-5), (S256(1) << 40) + S256(7), S256(-1) << 31});
+
+    const std::vector<S512> wide_values = {S512(-3), (S512(1) << 300) - S512(1), std::numeric_limits<S512>::min(), S512(77)};
+    expect_convert<U128>(wide_values);
+    expect_convert<S256>(wide_values);
+    expect_convert<int64_t>(wide_values);
+    expect_convert<S512>(std::vector<U256>{std::numeric_limits<U256>::max(), U256(9)});
+    expect_convert<U256>(std::vector<uint32_t>{0xFFFFFFFFU, 3});
+}
+
+TEST(WideIntegerBatch, NarrowChecked)
+{
+    using S128 = wide::integer<128, signed>;
+    using U128 = wide::integer<128, unsigned>;
+    using S256 = wide::integer<256, signed>;
+    using U256 = wide::integer<256, unsigned>;
+
+    const std::vector<S256> in = {S256(-1), std::numeric_limits<int64_t>::min(), (S256(1) << 127) - S256(1), S256(1) << 127};
+    std::vector<S128> out(in.size());
+    EXPECT_EQ(wide::batch::narrow_checked(in.data(), out.data(), in.size()), 3U);
+    EXPECT_EQ(out[2], std::numeric_limits<S128>::max());
+
+    std::vector<int64_t> small(in.size());
+    EXPECT_EQ(wide::batch::narrow_checked(in.data(), small.data(), in.size()), 2U);
+    EXPECT_EQ(small[1], std::numeric_limits<int64_t>::min());
+
+    std::vector<U128> unsigned_out(in.size());
+    EXPECT_EQ(wide::batch::narrow_checked(in.data(), unsigned_out.data(), in.size()), 0U);
+    EXPECT_EQ(wide::batch::narrow_checked(in.data() + 2, unsigned_out.data(), 2), 2U);
+
+    const std::vector<U256> big = {U256(1), std::numeric_limits<U256>::max() >> 1, std::numeric_limits<U256>::max()};
+    std::vector<S256> same_width(big.size());
+    EXPECT_EQ(wide::batch::narrow_checked(big.data(), same_width.data(), big.size()), 2U);
+
+    const std::vector<int64_t> keys = {5, -6, 1LL << 40};
+    std::vector<int32_t> keys32(keys.size());
+    EXPECT_EQ(wide::batch::narrow_checked(keys.data(), keys32.data(), keys.size()), 2U);
+    std::vector<uint32_t> ukeys32(keys.size());
+    EXPECT_EQ(wide::batch::narrow_checked(keys.data(), ukeys32.data(), keys.size()), 1U);
+    std::vector<S256> widened(keys.size());
+    EXPECT_EQ(wide::batch::narrow_checked(keys.data(), widened.data(), keys.size()), keys.size());
+    EXPECT_EQ(widened[1], S256(-6));
+}
+
+TEST(WideIntegerBatch, Bytes)
+{
+    using U = wide::integer<256, unsigned>;
+    std::vector<U> values = {U(1), std::numeric_limits<U>::max() - U(5), U(0x0102030405060708ULL) << 130};
+    std::vector<uint8_t> bytes(values.size() * 32);
+    std::vector<U> back(values.size());
+
+    wide::batch::store_be(values.data(), bytes.data(), values.size());
+    EXPECT_EQ(bytes[31], 1);
+    EXPECT_EQ(bytes[63], 0xFA);
+    for (size_t i = 0; i < values.size(); ++i)
+        EXPECT_EQ(wide::load_be<U>(bytes.data() + 32 * i), values[i]);
+    wide::batch::load_be(bytes.data(), back.data(), back.size());
+    EXPECT_EQ(back, values);
+
+    wide::batch::store_le(values.data(), bytes.data(), values.size());
+    EXPECT_EQ(bytes[0], 1);
+    EXPECT_EQ(bytes[32], 0xFA);
+    wide::batch::load_le(bytes.data(), back.data(), back.size());
+    EXPECT_EQ(back, values);
+}
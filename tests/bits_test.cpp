@@ -0,0 +1,196 @@
+#include <array>
+#include <cstdint>
+#include <random>
+#include <gtest/gtest.h>
+#include <wide_integer/bits.h>
+
+namespace
+{
+
+using U128 = wide::integer<128, unsigned>;
+using U256 = wide::integer<256, unsigned>;
+using U512 = wide::integer<512, unsigned>;
+using U1024 = wide::integer<1024, unsigned>;
+
+template <size_t Bits>
+wide::integer<Bits, unsigned> random_value(std::mt19937_64 & rng)
+{
+    wide::integer<Bits, unsigned> x;
+    for (auto & item : x.items)
+        item = rng();
+    return x;
+}
+
+template <size_t Bits>
+bool bit(const wide::integer<Bits, unsigned> & x, unsigned i)
+{
+    return ((x >> int(i)) & 1) != 0;
+}
+
+template <size_t Bits>
+wide::integer<Bits, unsigned> naive_pdep(const wide::integer<Bits, unsigned> & x, const wide::integer<Bits, unsigned> & mask)
+{
+    wide::integer<Bits, unsigned> res = 0;
+    unsigned k = 0;
+    for (unsigned i = 0; i < Bits; ++i)
+    {
+        if (bit(mask, i))
+        {
+            if (bit(x, k))
+                res |= wide::integer<Bits, unsigned>(1) << int(i);
+            ++k;
+        }
+    }
+    return res;
+}
+
+template <size_t Bits>
+wide::integer<Bits, unsigned> naive_pext(const wide::integer<Bits, unsigned> & x, const wide::integer<Bits, unsigned> & mask)
+{
+    wide::integer<Bits, unsigned> res = 0;
+    unsigned k = 0;
+    for (unsigned i = 0; i < Bits; ++i)
+    {
+        if (bit(mask, i))
+        {
+            if (bit(x, i))
+                res |= wide::integer<Bits, unsigned>(1) << int(k);
+            ++k;
+        }
+    }
+    return res;
+}
+
+template <unsigned Dims, size_t Bits>
+wide::integer<Bits, unsigned> naive_morton(const std::array<uint64_t, Dims> & coords)
+{
+    constexpr unsigned coordinate_bits = Bits / Dims < 64 ? Bits / Dims : 64;
+    wide::integer<Bits, unsigned> key = 0;
+    for (unsigned j = 0; j < coordinate_bits; ++j)
+        for (unsigned d = 0; d < Dims; ++d)
+            if ((coords[d] >> j) & 1)
+                key |= wide::integer<Bits, unsigned>(1) << int(j * Dims + d);
+    return key;
+}
+
+template <unsigned Dims, size_t Bits>
+void check_morton(std::mt19937_64 & rng)
+{
+    constexpr unsigned coordinate_bits = Bits / Dims < 64 ? Bits / Dims : 64;
+    constexpr uint64_t coordinate_mask = coordinate_bits == 64 ? ~uint64_t(0) : (uint64_t(1) << coordinate_bits) - 1;
+    for (int iter = 0; iter < 50; ++iter)
+    {
+        std::array<uint64_t, Dims> coords;
+        for (auto & c : coords)
+            c = rng();
+        const auto key = wide::morton_encode<Dims, Bits>(coords);
+        EXPECT_EQ(key, (naive_morton<Dims, Bits>(coords))) << "dims " << Dims << " bits " << Bits;
+
+        const auto decoded = wide::morton_decode<Dims>(key);
+        for (unsigned d = 0; d < Dims; ++d)
+            EXPECT_EQ(decoded[d], coords[d] & coordinate_mask) << "dims " << Dims << " bits " << Bits;
+    }
+}
+
+}
+
+TEST(WideIntegerBitOps, PdepPext)
+{
+    std::mt19937_64 rng(35);
+    for (int iter = 0; iter < 200; ++iter)
+    {
+        const U256 x = random_value<256>(rng);
+        U256 mask = random_value<256>(rng);
+        if (iter % 3 == 1)
+            mask &= random_value<256>(rng) & random_value<256>(rng);
+        if (iter % 3 == 2)
+            mask.items[iter % 4] = 0;
+
+        const U256 deposited = wide::pdep(x, mask);
+        const U256 extracted = wide::pext(x, mask);
+        EXPECT_EQ(deposited, naive_pdep(x, mask));
+        EXPECT_EQ(extracted, naive_pext(x, mask));
+        const int count = wide::popcount(mask);
+        EXPECT_EQ(wide::pext(deposited, mask), count == 256 ? x : x & ~(~U256(0) << count));
+        EXPECT_EQ(wide::pdep(extracted, mask), x & mask);
+    }
+
+    const U512 all = ~U512(0);
+    const U512 y = random_value<512>(rng);
+    EXPECT_EQ(wide::pdep(y, all), y);
+    EXPECT_EQ(wide::pext(y, all), y);
+    EXPECT_EQ(wide::pdep(y, U512(0)), U512(0));
+    EXPECT_EQ(wide::pext(y, U512(0)), U512(0));
+
+    const U128 top = U128(1) << 127;
+    EXPECT_EQ(wide::pdep(U128(1), top), top);
+    EXPECT_EQ(wide::pext(top, top), U128(1));
+}
+
+TEST(WideIntegerBitOps, Morton)
+{
+    std::mt19937_64 rng(36);
+    check_morton<2, 128>(rng);
+    check_morton<3, 192>(rng);
+    check_morton<3, 128>(rng);
+    check_morton<4, 256>(rng);
+    check_morton<5, 320>(rng);
+    check_morton<6, 384>(rng);
+    check_morton<7, 448>(rng);
+    check_morton<7, 256>(rng);
+    check_morton<8, 512>(rng);
+    check_morton<8, 256>(rng);
+
+    const auto key = wide::morton_encode<2>({{1, 2}});
+    EXPECT_EQ(key, U128(0b1001));
+}
+
+TEST(WideIntegerBitOps, ExtractInsert)
+{
+    std::mt19937_64 rng(37);
+    const U1024 x = random_value<1024>(rng);
+    for (unsigned offset : {0u, 1u, 5u, 63u, 64u, 100u, 511u, 960u, 1000u, 1023u, 1024u, 2000u})
+    {
+        const U1024 shifted = offset >= 1024 ? U1024(0) : x >> int(offset);
+        EXPECT_EQ(wide::extract_bits<1>(x, offset), uint64_t(shifted & 1)) << offset;
+        EXPECT_EQ(wide::extract_bits<13>(x, offset), uint64_t(shifted & 0x1FFF)) << offset;
+        EXPECT_EQ(wide::extract_bits<64>(x, offset), uint64_t(shifted)) << offset;
+        EXPECT_EQ(wide::extract_bits<128>(x, offset), U128(shifted)) << offset;
+        EXPECT_EQ(wide::extract_bits<256>(x, offset), U256(shifted)) << offset;
+
+        const uint64_t value = rng();
+        U1024 y = x;
+        wide::insert_bits<13>(y, offset, value);
+        const U1024 mask13 = offset >= 1024 ? U1024(0) : U1024(0x1FFF) << int(offset);
+        const U1024 placed13 = offset >= 1024 ? U1024(0) : U1024(value & 0x1FFF) << int(offset);
+        EXPECT_EQ(y, (x & ~mask13) | placed13) << offset;
+
+        const U256 wide_value = random_value<256>(rng);
+        y = x;
+        wide::insert_bits<256>(y, offset, wide_value);
+        const U1024 mask256 = offset >= 1024 ? U1024(0) : U1024(~U256(0)) << int(offset);
+        const U1024 placed256 = offset >= 1024 ? U1024(0) : U1024(wide_value) << int(offset);
+        EXPECT_EQ(y, (x & ~mask256) | placed256) << offset;
+        if (offset + 256 <= 1024)
+        {
+            EXPECT_EQ(wide::extract_bits<256>(y, offset), wide_value) << offset;
+        }
+    }
+
+    static_assert(wide::extract_bits<8>(U256{0ULL, 0xABULL, 0ULL, 0ULL}, 64) == 0xAB);
+    static_assert(wide::extract_bits<8>(U256{0xF000000000000000ULL, 0xAULL, 0ULL, 0ULL}, 60) == 0xAF);
+}
+
+TEST(WideIntegerBitOps, FunnelShift)
+{
+    std::mt19937_64 rng(38);
+    const U256 hi = random_value<256>(rng);
+    const U256 lo = random_value<256>(rng);
+    const U512 concat = (U512(hi) << 256) | U512(lo);
+    for (unsigned n = 0; n <= 256; ++n)
+        EXPECT_EQ(wide::funnel_shift(hi, lo, n), U256(concat >> int(n))) << n;
+    EXPECT_EQ(wide::funnel_shift(hi, lo, 0), lo);
+    EXPECT_EQ(wide::funnel_shift(hi, lo, 256), hi);
+
+    static_assert(wide::funnel_shift(U128(1), U128(0), 127) == U128(2));
+}
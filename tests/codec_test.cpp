@@ -0,0 +1,125 @@
+#include <cstdint>
+#include <random>
+#include <vector>
+#include <gtest/gtest.h>
+#include <wide_integer/codec.h>
+
+namespace
+{
+
+using S256 = wide::integer<256, signed>;
+using U256 = wide::integer<256, unsigned>;
+
+constexpr wide::codec::scheme all_schemes[] = {
+    wide::codec::scheme::frame_of_reference,
+    wide::codec::scheme::delta,
+    wide::codec::scheme::delta_of_delta,
+    wide::codec::scheme::trim_limbs,
+};
+
+template <size_t Bits, typename Signed>
+size_t expect_roundtrip(const std::vector<wide::integer<Bits, Signed>> & values, wide::codec::scheme s)
+{
+    std::vector<uint8_t> bytes(wide::codec::max_encoded_size<Bits>(values.size()));
+    const size_t size = wide::codec::encode(values.data(), values.size(), bytes.data(), s);
+    EXPECT_LE(size, bytes.size());
+    EXPECT_EQ(wide::codec::decoded_count(bytes.data(), bytes.data() + size), values.size());
+
+    std::vector<wide::integer<Bits, Signed>> back(values.size());
+    EXPECT_EQ(wide::codec::decode(bytes.data(), bytes.data() + size, back.data()), size);
+    EXPECT_EQ(back, values);
+
+    /// Every truncation of the block is rejected.
+    if (size > 0)
+    {
+        EXPECT_EQ(wide::codec::decode(bytes.data(), bytes.data() + size - 1, back.data()), 0U);
+    }
+    return size;
+}
+
+}
+
+TEST(WideIntegerCodec, Roundtrip)
+{
+    std::mt19937_64 rng(43);
+    const S256 base = (S256(1) << 200) + S256(12345);
+
+    std::vector<S256> near_base;
+    for (int i = 0; i < 257; ++i)
+        near_base.push_back(base + S256(static_cast<int64_t>(rng() % 100000)) - S256(50000));
+
+    std::vector<S256> increasing;
+    S256 id = -(S256(1) << 180);
+    for (int i = 0; i < 300; ++i)
+        increasing.push_back(id += S256(rng() % 1000));
+
+    std::vector<S256> random;
+    for (int i = 0; i < 100; ++i)
+    {
+        S256 x;
+        for (auto & item : x.items)
+            item = rng();
+        random.push_back(x >> static_cast<int>(rng() % 256));
+    }
+    random.push_back(std::numeric_limits<S256>::min());
+    random.push_back(std::numeric_limits<S256>::max());
+
+    /// Offsets from a reference just below 2^64 carry into the second item; full 64-bit offsets too.
+    std::vector<U256> carrying;
+    std::vector<U256> offsets64;
+    for (int i = 0; i < 200; ++i)
+    {
+        carrying.push_back((U256(7) << 128) + U256(~uint64_t(0) - 1000) + U256(rng() % 5000));
+        offsets64.push_back((U256(3) << 192) + U256(rng()));
+    }
+
+    for (const auto s : all_schemes)
+    {
+        expect_roundtrip(near_base, s);
+        expect_roundtrip(increasing, s);
+        expect_roundtrip(random, s);
+        expect_roundtrip(carrying, s);
+        expect_roundtrip(offsets64, s);
+        expect_roundtrip(std::vector<S256>{}, s);
+        expect_roundtrip(std::vector<S256>{S256(-9)}, s);
+        expect_roundtrip(std::vector<S256>{S256(-9), S256(7)}, s);
+        expect_roundtrip(std::vector<U256>{U256(0), std::numeric_limits<U256>::max(), U256(5)}, s);
+        expect_roundtrip(std::vector<wide::integer<128, unsigned>>(10, wide::integer<128, unsigned>(77)), s);
+    }
+}
+
+TEST(WideIntegerCodec, Ratio)
+{
+    /// Timestamps with a fixed step: one value, one step and zero-width second differences.
+    std::vector<S256> ticks;
+    for (int i = 0; i < 1000; ++i)
+        ticks.push_back((S256(1) << 128) + S256(i * 1000));
+    EXPECT_EQ(expect_roundtrip(ticks, wide::codec::scheme::delta_of_delta), wide::codec::header_size + 2 * 32 + 2 + 32);
+    /// All differences equal their minimum, so they pack to zero bits as well.
+    EXPECT_EQ(expect_roundtrip(ticks, wide::codec::scheme::delta), wide::codec::header_size + 32 + 2 + 32);
+    /// Offsets up to 999000 take 20 bits.
+    EXPECT_EQ(
+        expect_roundtrip(ticks, wide::codec::scheme::frame_of_reference), wide::codec::header_size + 2 + 32 + (1000 * 20 + 63) / 64 * 8);
+    /// With jitter the differences span 994 to 1001: three bits each.
+    for (int i = 0; i < 1000; ++i)
+        ticks[i] += S256(i % 7);
+    EXPECT_EQ(expect_roundtrip(ticks, wide::codec::scheme::delta), wide::codec::header_size + 32 + 2 + 32 + (999 * 3 + 63) / 64 * 8);
+    /// Three items per value plus the count byte.
+    EXPECT_EQ(expect_roundtrip(ticks, wide::codec::scheme::trim_limbs), wide::codec::header_size + 1000 * 25);
+}
+
+TEST(WideIntegerCodec, Malformed)
+{
+    const std::vector<U256> values = {U256(1), U256(2), U256(3)};
+    std::vector<uint8_t> bytes(wide::codec::max_encoded_size<256>(values.size()));
+    const size_t size = wide::codec::encode(values.data(), values.size(), bytes.data(), wide::codec::scheme::frame_of_reference);
+    std::vector<wide::integer<512, unsigned>> wider(3);
+    EXPECT_EQ(wide::codec::decode(bytes.data(), bytes.data() + size, wider.data()), 0U);
+
+    std::vector<U256> back(3);
+    bytes[0] = 9;
+    EXPECT_EQ(wide::codec::decode(bytes.data(), bytes.data() + size, back.data()), 0U);
+    bytes[0] = 0;
+    bytes[10] = 0xFF;
+    EXPECT_EQ(wide::codec::decode(bytes.data(), bytes.data() + size, back.data()), 0U);
+}
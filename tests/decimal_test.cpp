@@ -0,0 +1,142 @@
+#include <cstdint>
+#include <random>
+#include <sstream>
+#include <string>
+#include <gtest/gtest.h>
+#include <wide_integer/decimal.h>
+
+namespace
+{
+
+using S256 = wide::integer<256, signed>;
+using U256 = wide::integer<256, unsigned>;
+using Price = wide::decimal<256, 6>;
+using Rate = wide::decimal<256, 9>;
+
+template <typename T>
+T parse(const std::string & text)
+{
+    T value;
+    const auto res = wide::from_chars(text.data(), text.data() + text.size(), value);
+    EXPECT_EQ(res.ec, std::errc{}) << text;
+    EXPECT_EQ(res.ptr, text.data() + text.size()) << text;
+    return value;
+}
+
+}
+
+TEST(WideIntegerDecimal, InvariantDivisor)
+{
+    std::mt19937_64 rng(38);
+    for (int iter = 0; iter < 200; ++iter)
+    {
+        U256 x;
+        for (auto & item : x.items)
+            item = rng();
+        uint64_t d = rng() >> (iter % 64);
+        if (d == 0)
+            d = 1;
+
+        U256 quotient = x;
+        U256 expected = x;
+        const uint64_t rem = wide::detail::div_mod_invariant(quotient, wide::detail::invariant_divisor(d));
+        const uint64_t expected_rem = U256::_impl::div_mod_small(expected, d);
+        EXPECT_EQ(quotient, expected) << d;
+        EXPECT_EQ(rem, expected_rem) << d;
+    }
+}
+
+TEST(WideIntegerDecimal, Text)
+{
+    EXPECT_EQ(wide::to_string(Price(12)), "12.000000");
+    EXPECT_EQ(wide::to_string(Price::from_raw(-5)), "-0.000005");
+    EXPECT_EQ(wide::to_string(Price::from_raw(1234567)), "1.234567");
+    EXPECT_EQ(wide::to_string(wide::decimal<128, 0>(-42)), "-42");
+    EXPECT_EQ(wide::to_string(Price()), "0.000000");
+
+    EXPECT_EQ(parse<Price>("12.5").raw(), S256(12500000));
+    EXPECT_EQ(parse<Price>("-0.0000019").raw(), S256(-1));
+    EXPECT_EQ(parse<Price>("+7").raw(), S256(7000000));
+    EXPECT_EQ(parse<Price>(".25").raw(), S256(250000));
+    EXPECT_EQ(parse<Price>("3.").raw(), S256(3000000));
+
+    const std::string long_text = "-123456789012345678901234567890123456789012345678901234567890.123456";
+    EXPECT_EQ(wide::to_string(parse<Price>(long_text)), long_text);
+
+    std::ostringstream out;
+    out << parse<Rate>("0.000000001");
+    EXPECT_EQ(out.str(), "0.000000001");
+
+    Price value;
+    const std::string bad = "-.x";
+    EXPECT_EQ(wide::from_chars(bad.data(), bad.data() + bad.size(), value).ec, std::errc::invalid_argument);
+    const std::string huge = "1" + std::string(80, '0');
+    EXPECT_EQ(wide::from_chars(huge.data(), huge.data() + huge.size(), value).ec, std::errc::result_out_of_range);
+    const std::string trailing = "1.5abc";
+    EXPECT_EQ(wide::from_chars(trailing.data(), trailing.data() + trailing.size(), value).ptr, trailing.data() + 3);
+
+    char small[4];
+    EXPECT_EQ(wide::to_chars(small, small + sizeof(small), Price(1)).ec, std::errc::value_too_large);
+}
+
+TEST(WideIntegerDecimal, Arithmetic)
+{
+    const Price a = parse<Price>("19.99");
+    const Rate b = parse<Rate>("0.075");
+    const auto sum = a + b;
+    static_assert(std::is_same_v<decltype(sum), const Rate>);
+    EXPECT_EQ(wide::to_string(sum), "20.065000000");
+    EXPECT_EQ(wide::to_string(a - b), "19.915000000");
+    EXPECT_EQ(wide::to_string(a * b), "1.499250000");
+    EXPECT_EQ(wide::to_string(-a * b), "-1.499250000");
+    EXPECT_EQ(wide::to_string(a * a), "399.600100");
+    EXPECT_EQ(wide::to_string(parse<Price>("0.000001") * parse<Price>("0.5")), "0.000000");
+    EXPECT_EQ(wide::to_string(parse<Price>("-0.000003") * parse<Price>("0.5")), "-0.000001");
+
+    Price total;
+    for (int i = 0; i < 10; ++i)
+        total += parse<Price>("0.1");
+    EXPECT_EQ(total, Price(1));
+    total -= Price(3);
+    EXPECT_EQ(wide::to_string(total), "-2.000000");
+    total *= Price(-2);
+    EXPECT_EQ(total, Price(4));
+    EXPECT_LT(Price(3), Price(4));
+
+    EXPECT_EQ(wide::to_string(a.rescale<2>()), "19.99");
+    EXPECT_EQ(wide::to_string(parse<Price>("-1.999999").rescale<1>()), "-1.9");
+    EXPECT_EQ(wide::to_string(a.rescale<30>()), "19.990000000000000000000000000000");
+
+    /// Products whose intermediate does not fit into 256 bits.
+    std::mt19937_64 rng(39);
+    for (int iter = 0; iter < 100; ++iter)
+    {
+        S256 x = S256(int64_t(rng())) * S256(int64_t(rng()));
+        S256 y = S256(int64_t(rng())) * S256(rng() >> 20);
+        const auto product = Price::from_raw(x) * Price::from_raw(y);
+        const wide::integer<512, signed> exact = wide::integer<512, signed>(x) * wide::integer<512, signed>(y);
+        EXPECT_EQ(product.raw(), S256(exact / wide::integer<512, signed>(1000000)));
+    }
+}
+
+TEST(WideIntegerDecimal, Dynamic)
+{
+    using Dec = wide::dynamic_decimal<256>;
+    const Dec a = parse<Dec>("19.99");
+    const Dec b = parse<Dec>("-0.075");
+    EXPECT_EQ(a.scale(), 2u);
+    EXPECT_EQ(b.scale(), 3u);
+    EXPECT_EQ(wide::to_string(a + b), "19.915");
+    EXPECT_EQ(wide::to_string(a - b), "20.065");
+    EXPECT_EQ(wide::to_string(a * b), "-1.499");
+    EXPECT_EQ(parse<Dec>("1.50"), parse<Dec>("1.5"));
+    EXPECT_LT(b, a);
+    EXPECT_EQ(wide::to_string(a.rescale(5)), "19.99000");
+    EXPECT_EQ(wide::to_string(b.rescale(1)), "0.0");
+    EXPECT_EQ(a.to_static<6>(), parse<Price>("19.99"));
+    EXPECT_EQ(Dec(parse<Price>("19.99")), a);
+    EXPECT_THROW(Dec::from_raw(1, 100), std::runtime_error);
+
+    const Dec big = parse<Dec>("5789604461865809771178549250434395392663499233282028201972879200395656481996");
+    EXPECT_GT(big, parse<Dec>("0.5"));
+}
@@ -0,0 +1,96 @@
+#include <cstdint>
+#include <limits>
+#include <random>
+#include <vector>
+#include <gtest/gtest.h>
+#include <wide_integer/dot.h>
+
+namespace
+{
+
+using S256 = wide::integer<256, signed>;
+using S576 = wide::integer<576, signed>;
+using U128 = wide::integer<128, unsigned>;
+using U320 = wide::integer<320, unsigned>;
+
+/// Full-width values, with the extremes mixed in.
+std::vector<S256> random_column(std::mt19937_64 & rng, size_t n)
+{
+    std::vector<S256> column(n);
+    for (auto & x : column)
+    {
+        for (auto & item : x.items)
+            item = rng();
+        const unsigned pick = rng() % 16;
+        if (pick == 0)
+            x = std::numeric_limits<S256>::min();
+        else if (pick == 1)
+            x = std::numeric_limits<S256>::max();
+        else if (pick == 2)
+            x >>= int(rng() % 250);
+    }
+    return column;
+}
+
+S576 reference_dot(const std::vector<S256> & a, const std::vector<S256> & b)
+{
+    S576 sum = 0;
+    for (size_t i = 0; i < a.size(); ++i)
+        sum += S576(wide::mul_wide(a[i], b[i]));
+    return sum;
+}
+
+}
+
+TEST(WideIntegerDot, MatchesWideningProducts)
+{
+    std::mt19937_64 rng(50);
+    for (size_t n : {0, 1, 2, 17, 1000})
+    {
+        const auto a = random_column(rng, n);
+        const auto b = random_column(rng, n);
+        EXPECT_EQ(wide::dot(a.data(), b.data(), n), reference_dot(a, b));
+    }
+
+    /// 2^10 products of (2^128 - 1)^2 overflow 256 bits, the result keeps all of them.
+    std::vector<U128> ones(1024, std::numeric_limits<U128>::max());
+    const U320 expected = U320(wide::mul_wide(ones[0], ones[0])) << 10;
+    EXPECT_EQ(wide::dot(ones.data(), ones.data(), ones.size()), expected);
+
+    const S256 min = std::numeric_limits<S256>::min();
+    const std::vector<S256> mins(8, min);
+    EXPECT_EQ(wide::dot(mins.data(), mins.data(), mins.size()), S576(1) << 513);
+}
+
+TEST(WideIntegerDot, AccumulatorMergeAndReset)
+{
+    std::mt19937_64 rng(51);
+    const auto a = random_column(rng, 300);
+    const auto b = random_column(rng, 300);
+
+    wide::mac_accumulator<256, signed> first;
+    wide::mac_accumulator<256, signed> second;
+    for (size_t i = 0; i < a.size(); ++i)
+        (i % 3 ? first : second).add(a[i], b[i]);
+    first.merge(second);
+    EXPECT_EQ(first.value(), reference_dot(a, b));
+
+    first.reset();
+    EXPECT_EQ(first.value(), S576(0));
+    first.add(S256(-3), S256(5));
+    first.add(S256(2), S256(4));
+    EXPECT_EQ(first.value(), S576(-7));
+}
+
+TEST(WideIntegerDot, Parallel)
+{
+    std::mt19937_64 rng(52);
+    const auto a = random_column(rng, 20000);
+    const auto b = random_column(rng, 20000);
+    const S576 expected = reference_dot(a, b);
+    for (size_t threads : {1, 3})
+    {
+        wide::thread_pool pool(threads);
+        EXPECT_EQ(wide::dot(a.data(), b.data(), a.size(), pool), expected);
+    }
+}
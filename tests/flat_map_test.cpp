@@ -0,0 +1,253 @@
+#include <cstdint>
+#include <memory>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+#include <gtest/gtest.h>
+#include <wide_integer/flat_map.h>
+
+namespace
+{
+
+using U256 = wide::integer<256, unsigned>;
+using S128 = wide::integer<128, signed>;
+using U192 = wide::integer<192, unsigned>;
+
+/// Counts live instances and throws from the constructor when asked, or from the copy
+/// constructor once `copies_left` reaches 0.
+struct fragile
+{
+    static inline int live = 0;
+    static inline int copies_left = -1;
+
+    explicit fragile(bool fail = false)
+    {
+        if (fail)
+            throw std::runtime_error("fragile");
+        ++live;
+    }
+
+    fragile(const fragile &)
+    {
+        if (copies_left == 0)
+            throw std::runtime_error("fragile copy");
+        --copies_left;
+        ++live;
+    }
+
+    ~fragile() { --live; }
+};
+
+/// Keys that differ only in a few high bits, equal items included, which an XOR fold maps together.
+U256 clustered_key(uint64_t i)
+{
+    const U256 x = U256(i >> 4);
+    return (x << 192) | (x << 128) | (U256(i & 15) << 64) | x;
+}
+
+}
+
+TEST(WideIntegerFlatMap, MatchesUnorderedMap)
+{
+    std::mt19937_64 rng(46);
+    wide::flat_map<256, unsigned, uint64_t> map;
+    std::unordered_map<U256, uint64_t> reference;
+
+    for (int step = 0; step < 200000; ++step)
+    {
+        const U256 key = clustered_key(rng() % 5000);
+        const unsigned op = rng() % 4;
+        if (op == 0)
+        {
+            const uint64_t value = rng();
+            const auto [slot, inserted] = map.insert(key, value);
+            const auto expected = reference.emplace(key, value);
+            ASSERT_EQ(inserted, expected.second);
+            ASSERT_EQ(*slot, expected.first->second);
+        }
+        else if (op == 1)
+        {
+            ASSERT_EQ(map.erase(key), reference.erase(key) == 1);
+        }
+        else if (op == 2)
+        {
+            map[key] += 3;
+            reference[key] += 3;
+        }
+        else
+        {
+            const uint64_t * value = map.find(key);
+            const auto it = reference.find(key);
+            ASSERT_EQ(value != nullptr, it != reference.end());
+            if (value)
+            {
+                ASSERT_EQ(*value, it->second);
+            }
+        }
+        ASSERT_EQ(map.size(), reference.size());
+    }
+
+    size_t visited = 0;
+    map.for_each([&](const U256 & key, uint64_t value) {
+        ++visited;
+        EXPECT_EQ(reference.at(key), value);
+    });
+    EXPECT_EQ(visited, reference.size());
+}
+
+TEST(WideIntegerFlatMap, GrowthCopyAndClear)
+{
+    wide::flat_map<128, signed, std::string> map;
+    EXPECT_TRUE(map.empty());
+    EXPECT_EQ(map.find(S128(1)), nullptr);
+    for (int i = -1000; i < 1000; ++i)
+        EXPECT_TRUE(map.try_emplace(S128(i) << 70, std::to_string(i)).second);
+    EXPECT_FALSE(map.try_emplace(S128(5) << 70, "other").second);
+    EXPECT_EQ(map.size(), 2000U);
+    EXPECT_GE(map.capacity() / 8 * 7, map.size());
+
+    const auto copy = map;
+    map.clear();
+    EXPECT_TRUE(map.empty());
+    EXPECT_FALSE(map.contains(S128(-7) << 70));
+    ASSERT_EQ(copy.size(), 2000U);
+    EXPECT_EQ(*copy.find(S128(-7) << 70), "-7");
+
+    map.reserve(5000);
+    const size_t capacity = map.capacity();
+    for (int i = 0; i < 5000; ++i)
+        map[S128(i)] = "x";
+    EXPECT_EQ(map.capacity(), capacity);
+
+    /// Churn leaves tombstones behind; the table must keep working and not grow without bound.
+    wide::flat_map<128, signed, int> churn;
+    for (int i = 0; i < 100000; ++i)
+    {
+        churn[S128(i)] = i;
+        EXPECT_TRUE(churn.erase(S128(i)));
+    }
+    EXPECT_TRUE(churn.empty());
+    EXPECT_LE(churn.capacity(), 64U);
+}
+
+TEST(WideIntegerFlatMap, Batch)
+{
+    std::mt19937_64 rng(47);
+    std::vector<U256> keys(10000);
+    std::vector<uint32_t> values(keys.size());
+    for (size_t i = 0; i < keys.size(); ++i)
+    {
+        keys[i] = (U256(rng()) << 128) | U256(rng() % 3000);
+        values[i] = static_cast<uint32_t>(i);
+    }
+
+    wide::flat_map<256, unsigned, uint32_t> map;
+    std::unordered_map<U256, uint32_t> reference;
+    for (size_t i = 0; i < keys.size(); ++i)
+        reference.emplace(keys[i], values[i]);
+    EXPECT_EQ(map.insert(keys.data(), values.data(), keys.size()), reference.size());
+    EXPECT_EQ(map.insert(keys.data(), values.data(), keys.size()), 0U);
+
+    std::vector<U256> probes = keys;
+    for (size_t i = 0; i < probes.size(); i += 3)
+        probes[i] += U256(1) << 255;
+    std::vector<const uint32_t *> found(probes.size());
+    const auto & cmap = map;
+    size_t expected = 0;
+    for (const auto & probe : probes)
+        expected += reference.count(probe);
+    EXPECT_EQ(cmap.find(probes.data(), probes.size(), found.data()), expected);
+    for (size_t i = 0; i < probes.size(); ++i)
+    {
+        const auto it = reference.find(probes[i]);
+        ASSERT_EQ(found[i] != nullptr, it != reference.end());
+        if (found[i])
+        {
+            EXPECT_EQ(*found[i], it->second);
+        }
+    }
+}
+
+TEST(WideIntegerFlatMap, ThrowingValue)
+{
+    using FragileMap = wide::flat_map<128, signed, fragile>;
+    {
+        FragileMap map;
+        for (int i = 0; i < 10; ++i)
+            map.try_emplace(S128(i));
+        EXPECT_THROW(map.try_emplace(S128(100), true), std::runtime_error);
+        EXPECT_EQ(map.size(), 10U);
+        EXPECT_FALSE(map.contains(S128(100)));
+        EXPECT_EQ(fragile::live, 10);
+        EXPECT_TRUE(map.try_emplace(S128(100)).second);
+
+        /// Growth copies the values, fragile has no noexcept move.
+        const auto grow = [&map] {
+            for (int i = 200; i < 300; ++i)
+                map.try_emplace(S128(i));
+        };
+        fragile::copies_left = 5;
+        EXPECT_THROW(grow(), std::runtime_error);
+        fragile::copies_left = -1;
+        const size_t size = map.size();
+        EXPECT_EQ(fragile::live, static_cast<int>(size));
+        for (int i = 0; i < 10; ++i)
+            EXPECT_TRUE(map.contains(S128(i)));
+
+        fragile::copies_left = 3;
+        EXPECT_THROW(FragileMap{map}, std::runtime_error);
+        fragile::copies_left = -1;
+        EXPECT_EQ(fragile::live, static_cast<int>(size));
+    }
+    EXPECT_EQ(fragile::live, 0);
+}
+
+TEST(WideIntegerFlatSet, InsertEraseBatch)
+{
+    wide::flat_set<192, unsigned> set;
+    std::unordered_set<uint64_t> reference;
+    std::mt19937_64 rng(48);
+    for (int step = 0; step < 50000; ++step)
+    {
+        const uint64_t i = rng() % 2000;
+        const U192 key = (U192(i) << 128) | U192(i);
+        if (rng() % 3)
+            ASSERT_EQ(set.insert(key), reference.insert(i).second);
+        else
+            ASSERT_EQ(set.erase(key), reference.erase(i) == 1);
+        ASSERT_EQ(set.size(), reference.size());
+    }
+
+    std::vector<U192> keys(4000);
+    for (size_t i = 0; i < keys.size(); ++i)
+        keys[i] = (U192(i) << 128) | U192(i);
+    std::unique_ptr<bool[]> present(new bool[keys.size()]);
+    EXPECT_EQ(set.contains(keys.data(), keys.size(), present.get()), reference.size());
+    for (size_t i = 0; i < keys.size(); ++i)
+        EXPECT_EQ(present[i], reference.count(i) == 1);
+
+    const size_t before = set.size();
+    EXPECT_EQ(set.insert(keys.data(), keys.size()), keys.size() - before);
+    EXPECT_EQ(set.size(), keys.size());
+    size_t visited = 0;
+    set.for_each([&](const U192 &) { ++visited; });
+    EXPECT_EQ(visited, keys.size());
+}
+
+TEST(WideIntegerFlatMap, HashSpreadsEqualItems)
+{
+    /// The XOR of the items of x:x:...:x is 0 for every x.
+    std::unordered_set<size_t> hashes;
+    for (uint64_t i = 0; i < 1000; ++i)
+        hashes.insert(std::hash<U256>()((U256(i) << 192) | (U256(i) << 128) | (U256(i) << 64) | U256(i)));
+    EXPECT_EQ(hashes.size(), 1000U);
+
+    /// The 7 low bits select the control byte; they must take many values on consecutive keys.
+    std::unordered_set<size_t> low;
+    for (uint64_t i = 0; i < 1000; ++i)
+        low.insert(std::hash<U256>()(U256(i) << 128) & 0x7F);
+    EXPECT_GT(low.size(), 100U);
+}
@@ -0,0 +1,130 @@
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+#include <random>
+#include <string>
+#include <vector>
+#include <gtest/gtest.h>
+#include <wide_integer/mapped_column.h>
+
+namespace
+{
+
+using S256 = wide::integer<256, signed>;
+using U256 = wide::integer<256, unsigned>;
+using U128 = wide::integer<128, unsigned>;
+
+std::string temp_path(const char * name)
+{
+    return testing::TempDir() + "wide_integer_" + name;
+}
+
+std::vector<uint8_t> read_file(const std::string & path)
+{
+    std::ifstream in(path, std::ios::binary);
+    return std::vector<uint8_t>(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+}
+
+void write_file(const std::string & path, const std::vector<uint8_t> & bytes)
+{
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    out.write(reinterpret_cast<const char *>(bytes.data()), static_cast<std::streamsize>(bytes.size()));
+}
+
+}
+
+TEST(WideIntegerMappedColumn, Roundtrip)
+{
+    const std::string path = temp_path("roundtrip.col");
+    std::mt19937_64 rng(7);
+    std::vector<S256> values(1000);
+    for (auto & v : values)
+        v = (S256(rng()) << 128) - S256(rng());
+
+    wide::write_column(path, values.data(), values.size());
+    const wide::mapped_column<256, signed> column(path, wide::access_hint::sequential);
+
+    ASSERT_EQ(column.size(), values.size());
+    EXPECT_EQ(reinterpret_cast<uintptr_t>(column.data()) % 64, 0U);
+    EXPECT_TRUE(std::equal(column.begin(), column.end(), values.begin()));
+    EXPECT_EQ(column[17], values[17]);
+    EXPECT_EQ(*column.min(), *std::min_element(values.begin(), values.end()));
+    EXPECT_EQ(*column.max(), *std::max_element(values.begin(), values.end()));
+    column.advise(wide::access_hint::random);
+    std::remove(path.c_str());
+}
+
+TEST(WideIntegerMappedColumn, IncrementalWriter)
+{
+    const std::string path = temp_path("incremental.col");
+    {
+        wide::column_writer<128, unsigned> writer(path, false);
+        for (unsigned i = 0; i < 100; ++i)
+            writer.append(U128(i) << 100);
+        /// The destructor finishes the file.
+    }
+
+    wide::mapped_column<128, unsigned> column(path);
+    ASSERT_EQ(column.size(), 100U);
+    for (unsigned i = 0; i < 100; ++i)
+        EXPECT_EQ(column[i], U128(i) << 100);
+    EXPECT_FALSE(column.min().has_value());
+    EXPECT_FALSE(column.max().has_value());
+
+    /// Moving keeps the mapping alive.
+    wide::mapped_column<128, unsigned> moved(std::move(column));
+    EXPECT_EQ(moved[99], U128(99) << 100);
+    std::remove(path.c_str());
+}
+
+TEST(WideIntegerMappedColumn, Empty)
+{
+    const std::string path = temp_path("empty.col");
+    wide::write_column<256, unsigned>(path, nullptr, 0);
+    const wide::mapped_column<256, unsigned> column(path);
+    EXPECT_TRUE(column.empty());
+    EXPECT_EQ(column.begin(), column.end());
+    EXPECT_FALSE(column.min().has_value());
+    std::remove(path.c_str());
+}
+
+TEST(WideIntegerMappedColumn, Rejects)
+{
+    const std::string path = temp_path("rejects.col");
+    const std::vector<U256> values = {U256(1), U256(2), U256(3)};
+    wide::write_column(path, values.data(), values.size());
+
+    using Unsigned = wide::mapped_column<256, unsigned>;
+    EXPECT_NO_THROW(Unsigned{path});
+    EXPECT_THROW((wide::mapped_column<256, signed>{path}), std::runtime_error);
+    EXPECT_THROW((wide::mapped_column<128, unsigned>{path}), std::runtime_error);
+    EXPECT_THROW(Unsigned{temp_path("missing.col")}, std::system_error);
+
+    const std::vector<uint8_t> bytes = read_file(path);
+
+    std::vector<uint8_t> truncated(bytes.begin(), bytes.end() - 1);
+    write_file(path, truncated);
+    EXPECT_THROW(Unsigned{path}, std::runtime_error);
+
+    std::vector<uint8_t> short_header(bytes.begin(), bytes.begin() + 20);
+    write_file(path, short_header);
+    EXPECT_THROW(Unsigned{path}, std::runtime_error);
+
+    std::vector<uint8_t> bad_magic = bytes;
+    bad_magic[0] = 'X';
+    write_file(path, bad_magic);
+    EXPECT_THROW(Unsigned{path}, std::runtime_error);
+
+    std::vector<uint8_t> other_order = bytes;
+    other_order[13] ^= 1;
+    write_file(path, other_order);
+    EXPECT_THROW(Unsigned{path}, std::runtime_error);
+
+    std::vector<uint8_t> bad_offset = bytes;
+    bad_offset[24] += 1;
+    write_file(path, bad_offset);
+    EXPECT_THROW(Unsigned{path}, std::runtime_error);
+    std::remove(path.c_str());
+}
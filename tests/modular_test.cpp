@@ -0,0 +1,180 @@
+#include <cstdint>
+#include <random>
+#include <gtest/gtest.h>
+#include <wide_integer/modular.h>
+
+namespace
+{
+
+using U256 = wide::integer<256, unsigned>;
+using U512 = wide::integer<512, unsigned>;
+
+/// secp256k1 field prime 2^256 - 2^32 - 977.
+struct Secp256k1Prime
+{
+    static constexpr U256 value{0xFFFFFFFEFFFFFC2FULL, 0xFFFFFFFFFFFFFFFFULL, 0xFFFFFFFFFFFFFFFFULL, 0xFFFFFFFFFFFFFFFFULL};
+};
+
+template <size_t Bits>
+wide::integer<Bits, unsigned> random_below(std::mt19937_64 & rng, const wide::integer<Bits, unsigned> & bound)
+{
+    wide::integer<Bits, unsigned> x;
+    for (auto & item : x.items)
+        item = rng();
+    return x % bound;
+}
+
+template <size_t Bits>
+wide::integer<Bits, unsigned> mulmod(
+    const wide::integer<Bits, unsigned> & a, const wide::integer<Bits, unsigned> & b, const wide::integer<Bits, unsigned> & m)
+{
+    using Wide = wide::integer<Bits * 2, unsigned>;
+    return wide::integer<Bits, unsigned>(Wide(a) * Wide(b) % Wide(m));
+}
+
+}
+
+TEST(WideIntegerMontgomery, MatchesMulMod)
+{
+    std::mt19937_64 rng(42);
+    const U256 moduli[] = {Secp256k1Prime::value, (U256(1) << 255) + U256(95), U256(1000000007ULL), (U256(1) << 130) - U256(5)};
+    for (const auto & m : moduli)
+    {
+        wide::montgomery<256> ctx(m);
+        for (int i = 0; i < 50; ++i)
+        {
+            U256 a = random_below(rng, m);
+            U256 b = random_below(rng, m);
+            U256 am = ctx.to_mont(a);
+            U256 bm = ctx.to_mont(b);
+            EXPECT_EQ(ctx.from_mont(am), a);
+            EXPECT_EQ(ctx.from_mont(ctx.mul(am, bm)), mulmod(a, b, m));
+            EXPECT_EQ(ctx.from_mont(ctx.sqr(am)), mulmod(a, a, m));
+            EXPECT_EQ(ctx.from_mont(ctx.add(am, bm)), U256((U512(a) + U512(b)) % U512(m)));
+            EXPECT_EQ(ctx.from_mont(ctx.sub(am, bm)), a >= b ? a - b : m - (b - a));
+        }
+    }
+}
+
+TEST(WideIntegerMontgomery, Pow)
+{
+    const U256 p = Secp256k1Prime::value;
+    wide::montgomery<256> ctx(p);
+    U256 a = ctx.to_mont(U256(123456789));
+    /// Fermat: a^(p-1) == 1 mod p.
+    EXPECT_EQ(ctx.from_mont(ctx.pow(a, p - U256(1))), U256(1));
+    EXPECT_EQ(ctx.from_mont(ctx.pow(a, 0)), U256(1));
+    EXPECT_EQ(ctx.from_mont(ctx.pow(ctx.to_mont(U256(3)), 5)), U256(243));
+    EXPECT_EQ(ctx.from_mont(ctx.pow(ctx.to_mont(U256(2)), 256)), U256(0x1000003D1ULL));
+}
+
+TEST(WideIntegerMontgomery, CompileTimeModulus)
+{
+    constexpr wide::montgomery<256, Secp256k1Prime> ctx;
+    constexpr U256 seven = ctx.to_mont(U256(7));
+    static_assert(ctx.from_mont(ctx.mul(seven, seven)) == 49, "compile-time Montgomery multiplication failed");
+
+    wide::montgomery<256> runtime(Secp256k1Prime::value);
+    EXPECT_EQ(ctx.one(), runtime.one());
+    U256 x = ctx.to_mont(U256(1) << 200);
+    EXPECT_EQ(ctx.mul(x, x), runtime.mul(x, x));
+    EXPECT_EQ(ctx.from_mont(ctx.pow(x, Secp256k1Prime::value - U256(1))), U256(1));
+}
+
+TEST(WideIntegerMontgomery, SmallWidthAndInvalidModulus)
+{
+    using U128 = wide::integer<128, unsigned>;
+    std::mt19937_64 rng(7);
+    const U128 m = (U128(1) << 127) - U128(1);
+    wide::montgomery<128> ctx(m);
+    for (int i = 0; i < 50; ++i)
+    {
+        U128 a = random_below(rng, m);
+        U128 b = random_below(rng, m);
+        EXPECT_EQ(ctx.from_mont(ctx.mul(ctx.to_mont(a), ctx.to_mont(b))), mulmod(a, b, m));
+    }
+
+    EXPECT_THROW(wide::montgomery<256>(U256(10)), std::runtime_error);
+    EXPECT_THROW(wide::montgomery<256>(U256(1)), std::runtime_error);
+}
+
+TEST(WideIntegerBarrett, MatchesMulMod)
+{
+    std::mt19937_64 rng(7);
+    const U256 moduli[] = {Secp256k1Prime::value, ~U256(0), U256(1) << 200, U256(1000000000ULL), U256(3), U256(1)};
+    for (const auto & m : moduli)
+    {
+        wide::barrett<256> ctx(m);
+        EXPECT_EQ(ctx.modulus(), m);
+        for (int i = 0; i < 50; ++i)
+        {
+            U256 a = random_below(rng, m);
+            U256 b = random_below(rng, m);
+            EXPECT_EQ(ctx.mul(a, b), mulmod(a, b, m));
+            EXPECT_EQ(ctx.reduce(U512(a)), a);
+        }
+        EXPECT_EQ(ctx.mul(m - U256(1), m - U256(1)), mulmod(m - U256(1), m - U256(1), m));
+    }
+
+    EXPECT_THROW(wide::barrett<256>(U256(0)), std::runtime_error);
+}
+
+namespace
+{
+
+template <size_t Bits, size_t ExpBits>
+wide::integer<Bits, unsigned>
+powmod_reference(wide::integer<Bits, unsigned> base, const wide::integer<ExpBits, unsigned> & exp, const wide::integer<Bits, unsigned> & m)
+{
+    wide::integer<Bits, unsigned> res = wide::integer<Bits, unsigned>(1) % m;
+    base %= m;
+    for (size_t i = 0; i < ExpBits; ++i)
+    {
+        if (((exp >> int(i)) & 1) != 0)
+            res = mulmod(res, base, m);
+        base = mulmod(base, base, m);
+    }
+    return res;
+}
+
+}
+
+TEST(WideIntegerPowMod, MatchesReference)
+{
+    std::mt19937_64 rng(11);
+    const U256 moduli[] = {Secp256k1Prime::value, (U256(1) << 255) + U256(95), U256(1) << 255, U256(1000000000ULL), ~U256(0), U256(2)};
+    for (const auto & m : moduli)
+    {
+        for (int i = 0; i < 8; ++i)
+        {
+            const U256 base = random_below(rng, ~U256(0));
+            U256 exp = random_below(rng, ~U256(0)) >> (i * 31);
+            EXPECT_EQ(wide::powmod(base, exp, m), powmod_reference(base, exp, m));
+            if (m.items[0] & 1)
+            {
+                EXPECT_EQ(wide::powmod_consttime(base, exp, m), powmod_reference(base, exp, m));
+            }
+        }
+        EXPECT_EQ(wide::powmod(U256(5), U256(0), m), U256(1));
+        EXPECT_EQ(wide::powmod(U256(5), uint64_t(1), m), U256(5) % m);
+        EXPECT_EQ(wide::powmod(U256(0), uint64_t(3), m), U256(0));
+    }
+
+    EXPECT_EQ(wide::powmod(U256(7), uint64_t(10), U256(1)), U256(0));
+    EXPECT_THROW(wide::powmod(U256(7), uint64_t(10), U256(0)), std::runtime_error);
+    EXPECT_THROW(wide::powmod_consttime(U256(7), U256(10), U256(10)), std::runtime_error);
+}
+
+TEST(WideIntegerPowMod, FermatAndWideExponent)
+{
+    const U256 p = Secp256k1Prime::value;
+    std::mt19937_64 rng(12);
+    for (int i = 0; i < 4; ++i)
+    {
+        const U256 a = random_below(rng, p - U256(1)) + U256(1);
+        EXPECT_EQ(wide::powmod(a, p - U256(1), p), U256(1));
+        EXPECT_EQ(wide::powmod_consttime(a, p - U256(1), p), U256(1));
+        /// a^(p+1) computed through a 512-bit exponent.
+        EXPECT_EQ(wide::powmod(a, U512(p) + U512(1), p), mulmod(a, a, p));
+    }
+}
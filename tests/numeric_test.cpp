@@ -0,0 +1,288 @@
+#include <cstdint>
+#include <random>
+#include <string>
+#include <vector>
+#include <gtest/gtest.h>
+#include <wide_integer/numeric.h>
+
+namespace
+{
+
+using U256 = wide::integer<256, unsigned>;
+using S256 = wide::integer<256, signed>;
+using U512 = wide::integer<512, unsigned>;
+
+template <size_t Bits>
+wide::integer<Bits, unsigned> random_bits(std::mt19937_64 & rng, unsigned bits)
+{
+    wide::integer<Bits, unsigned> x;
+    for (auto & item : x.items)
+        item = rng();
+    return bits == 0 ? wide::integer<Bits, unsigned>(0) : x >> int(Bits - bits);
+}
+
+}
+
+TEST(WideIntegerNumeric, Pow)
+{
+    U256 expected = 1;
+    for (unsigned k = 0; k < 78; ++k)
+    {
+        EXPECT_EQ(wide::pow(U256(10), k), expected);
+        expected *= 10;
+    }
+    EXPECT_EQ(wide::pow(U256(2), 255), U256(1) << 255);
+    EXPECT_EQ(wide::pow(U256(2), 256), U256(0));
+    EXPECT_EQ(wide::pow(U256(0), 0), U256(1));
+    EXPECT_EQ(wide::pow(S256(-3), 3), S256(-27));
+    EXPECT_EQ(wide::pow(S256(-3), 4), S256(81));
+}
+
+TEST(WideIntegerNumeric, Logarithms)
+{
+    EXPECT_EQ(wide::ilog2(U256(1)), 0u);
+    EXPECT_EQ(wide::ilog2(U256(1) << 200), 200u);
+    EXPECT_EQ(wide::ilog2(~U256(0)), 255u);
+    EXPECT_EQ(wide::ilog2(std::numeric_limits<S256>::max()), 254u);
+
+    U256 p = 1;
+    for (unsigned k = 0; k < 78; ++k)
+    {
+        EXPECT_EQ(wide::ilog10(p), k);
+        if (k > 0)
+        {
+            EXPECT_EQ(wide::ilog10(p - U256(1)), k - 1);
+        }
+        EXPECT_EQ(wide::ilog10(p + U256(1)), k);
+        p *= 10;
+    }
+    EXPECT_EQ(wide::ilog10(~U256(0)), 77u);
+    EXPECT_EQ(wide::ilog10(~U512(0)), 154u);
+
+    std::mt19937_64 rng(5);
+    for (unsigned bits = 1; bits <= 512; ++bits)
+    {
+        const U512 x = random_bits<512>(rng, bits) | (U512(1) << int(bits - 1));
+        EXPECT_EQ(wide::ilog2(x), bits - 1);
+        EXPECT_EQ(wide::ilog10(x), to_string(x).size() - 1);
+    }
+
+    EXPECT_THROW(wide::ilog2(U256(0)), std::runtime_error);
+    EXPECT_THROW(wide::ilog10(S256(-5)), std::runtime_error);
+}
+
+TEST(WideIntegerNumeric, Roots)
+{
+    std::mt19937_64 rng(6);
+    for (unsigned bits = 0; bits <= 512; bits += 7)
+    {
+        const U512 x = random_bits<512>(rng, bits);
+
+        const U512 s = wide::isqrt(x);
+        EXPECT_LE(s * s, x);
+        EXPECT_GT((s + U512(1)) * (s + U512(1)), x);
+
+        const U512 c = wide::icbrt(x);
+        EXPECT_LE(c * c * c, x);
+        EXPECT_GT((c + U512(1)) * (c + U512(1)) * (c + U512(1)), x);
+    }
+
+    /// Exact powers and their neighbours.
+    for (unsigned k = 1; k < 80; k += 3)
+    {
+        const U256 r = random_bits<256>(rng, k);
+        EXPECT_EQ(wide::isqrt(r * r), r);
+        if (r > 0)
+        {
+            EXPECT_EQ(wide::isqrt(r * r - U256(1)), r - U256(1));
+        }
+        EXPECT_EQ(wide::icbrt(r * r * r), r);
+        if (r > 0)
+        {
+            EXPECT_EQ(wide::icbrt(r * r * r - U256(1)), r - U256(1));
+        }
+    }
+
+    EXPECT_EQ(wide::isqrt(~U256(0)), ~U256(0) >> 128);
+    EXPECT_EQ(wide::icbrt(S256(-27)), S256(-3));
+    EXPECT_EQ(wide::icbrt(S256(-28)), S256(-3));
+    EXPECT_EQ(wide::icbrt(std::numeric_limits<S256>::min()), -(S256(1) << 85));
+    EXPECT_THROW(wide::isqrt(S256(-1)), std::runtime_error);
+}
+
+/// Past 1024 bits the roots no longer fit into a double, and past 4096 bits neither does the argument.
+template <size_t Bits>
+void expect_wide_roots(std::mt19937_64 & rng)
+{
+    using UInt = wide::integer<Bits, unsigned>;
+    using Wide = wide::integer<Bits * 2, unsigned>;
+    const UInt max = std::numeric_limits<UInt>::max();
+    EXPECT_EQ(wide::isqrt(max), max >> (Bits / 2));
+
+    std::vector<UInt> values = {max, max >> 1, UInt(1) << (Bits - 1), (UInt(1) << (Bits - 1)) - UInt(1)};
+    for (int i = 0; i < 8; ++i)
+        values.push_back(random_bits<Bits>(rng, Bits - static_cast<unsigned>(rng() % 1100)));
+    for (const UInt & x : values)
+    {
+        const Wide s(wide::isqrt(x));
+        EXPECT_LE(s * s, Wide(x));
+        EXPECT_GT((s + Wide(1)) * (s + Wide(1)), Wide(x));
+
+        const Wide c(wide::icbrt(x));
+        EXPECT_LE(c * c * c, Wide(x));
+        EXPECT_GT((c + Wide(1)) * (c + Wide(1)) * (c + Wide(1)), Wide(x));
+    }
+
+    const UInt r = random_bits<Bits>(rng, Bits / 3) | UInt(1);
+    EXPECT_EQ(wide::icbrt(r * r * r), r);
+    EXPECT_EQ(wide::icbrt(r * r * r - UInt(1)), r - UInt(1));
+}
+
+TEST(WideIntegerNumeric, WideRoots)
+{
+    std::mt19937_64 rng(7);
+    expect_wide_roots<2048>(rng);
+    expect_wide_roots<4096>(rng);
+    expect_wide_roots<8192>(rng);
+}
+
+TEST(WideIntegerNumeric, LongDivideMatchesOperator)
+{
+    std::mt19937_64 rng(8);
+    for (int i = 0; i < 2000; ++i)
+    {
+        const U512 num = random_bits<512>(rng, 1 + rng() % 512);
+        U512 den = random_bits<512>(rng, 1 + rng() % 512);
+        if (i % 7 == 0)
+            den = ~U512(0) >> int(rng() % 512);
+        if (den == 0)
+            den = 1;
+        EXPECT_EQ(wide::detail::long_divide(num, den), num / den);
+    }
+    /// Quotient digits that need the add-back step.
+    const U256 num{0ULL, 0ULL, 0ULL, 0x8000000000000000ULL};
+    const U256 den{1ULL, 0ULL, 0x8000000000000000ULL, 0ULL};
+    EXPECT_EQ(wide::detail::long_divide(num, den), num / den);
+}
+
+TEST(WideIntegerNumeric, Pow10Table)
+{
+    static_assert(wide::pow10<256>.size() == 78);
+    static_assert(wide::pow10<512>.size() == 155);
+    static_assert(wide::pow10<256>[3] == 1000);
+
+    U256 expected = 1;
+    for (const auto & p : wide::pow10<256>)
+    {
+        EXPECT_EQ(p, expected);
+        expected *= 10;
+    }
+    /// The next power does not fit any more.
+    EXPECT_LT(expected / 10, wide::pow10<256>.back());
+}
+
+TEST(WideIntegerNumeric, Digits10AndToChars)
+{
+    static_assert(wide::digits10(U256(0)) == 1);
+    static_assert(wide::digits10(U256(999)) == 3);
+
+    std::mt19937_64 rng(9);
+    char buffer[200];
+    for (unsigned bits = 0; bits <= 512; ++bits)
+    {
+        const U512 x = random_bits<512>(rng, bits);
+        const std::string expected = to_string(x);
+        EXPECT_EQ(wide::digits10(x), expected.size());
+
+        auto [end, ec] = wide::to_chars(buffer, buffer + sizeof(buffer), x);
+        EXPECT_EQ(ec, std::errc{});
+        EXPECT_EQ(std::string(buffer, end), expected);
+    }
+
+    for (const auto & p : wide::pow10<256>)
+    {
+        EXPECT_EQ(wide::digits10(p), to_string(p).size());
+        EXPECT_EQ(wide::digits10(p - U256(1)), to_string(p - U256(1)).size());
+    }
+
+    const S256 values[] = {S256(0), S256(-1), S256(-1234567890), std::numeric_limits<S256>::min(), std::numeric_limits<S256>::max()};
+    for (const auto & x : values)
+    {
+        auto [end, ec] = wide::to_chars(buffer, buffer + sizeof(buffer), x);
+        EXPECT_EQ(ec, std::errc{});
+        EXPECT_EQ(std::string(buffer, end), to_string(x));
+    }
+
+    auto [end, ec] = wide::to_chars(buffer, buffer + 3, S256(-1234));
+    EXPECT_EQ(ec, std::errc::value_too_large);
+    EXPECT_EQ(end, buffer + 3);
+}
+
+namespace
+{
+
+template <size_t Bits>
+wide::integer<Bits, unsigned> euclid_gcd(wide::integer<Bits, unsigned> a, wide::integer<Bits, unsigned> b)
+{
+    while (b != 0)
+    {
+        auto t = a % b;
+        a = b;
+        b = t;
+    }
+    return a;
+}
+
+}
+
+TEST(WideIntegerNumeric, GcdLcm)
+{
+    std::mt19937_64 rng(10);
+    for (int i = 0; i < 200; ++i)
+    {
+        /// A shared factor, so that the results are not almost always 1.
+        const U256 common = random_bits<256>(rng, 1 + rng() % 100);
+        const U256 a = random_bits<256>(rng, rng() % 150) * common;
+        const U256 b = random_bits<256>(rng, rng() % 150) * common;
+        const U256 g = wide::gcd(a, b);
+        EXPECT_EQ(g, euclid_gcd(a, b));
+        if (g != 0)
+        {
+            EXPECT_EQ(wide::lcm(a, b), a / g * b);
+        }
+    }
+
+    EXPECT_EQ(wide::gcd(U256(0), U256(0)), U256(0));
+    EXPECT_EQ(wide::gcd(U256(0), U256(12)), U256(12));
+    EXPECT_EQ(wide::gcd(U256(1) << 200, U256(3) << 150), U256(1) << 150);
+    EXPECT_EQ(wide::gcd(S256(-12), S256(18)), S256(6));
+    EXPECT_EQ(wide::lcm(S256(-4), S256(6)), S256(12));
+    EXPECT_EQ(wide::lcm(U256(0), U256(6)), U256(0));
+}
+
+TEST(WideIntegerNumeric, ModInv)
+{
+    std::mt19937_64 rng(11);
+    const U256 moduli[] = {(U256(1) << 255) + U256(95), U256(1) << 200, U256(1000000000ULL), ~U256(0), U256(2)};
+    for (const auto & m : moduli)
+    {
+        for (int i = 0; i < 100; ++i)
+        {
+            const U256 a = random_bits<256>(rng, 1 + rng() % 256);
+            const auto inv = wide::modinv(a, m);
+            if (euclid_gcd(a % m, m) == 1)
+            {
+                ASSERT_TRUE(inv.has_value());
+                EXPECT_LT(*inv, m);
+                EXPECT_EQ(U256(wide::mul_wide(a % m, *inv) % U512(m)), U256(1));
+            }
+            else
+                EXPECT_FALSE(inv.has_value());
+        }
+    }
+
+    EXPECT_EQ(wide::modinv(U256(3), U256(7)), U256(5));
+    EXPECT_FALSE(wide::modinv(U256(6), U256(9)).has_value());
+    EXPECT_FALSE(wide::modinv(U256(0), U256(9)).has_value());
+    EXPECT_THROW(wide::modinv(U256(3), U256(1)), std::runtime_error);
+}
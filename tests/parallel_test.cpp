@@ -0,0 +1,114 @@
+#include <atomic>
+#include <cstdint>
+#include <random>
+#include <string>
+#include <gtest/gtest.h>
+#include <wide_integer/parallel.h>
+
+namespace
+{
+
+using U8192 = wide::integer<8192, unsigned>;
+using S8192 = wide::integer<8192, signed>;
+using U16384 = wide::integer<16384, unsigned>;
+using U65536 = wide::integer<65536, unsigned>;
+
+template <size_t Bits, typename Signed>
+wide::integer<Bits, Signed> random_value(std::mt19937_64 & rng, unsigned bits)
+{
+    wide::integer<Bits, Signed> x;
+    for (auto & item : x.items)
+        item = rng();
+    return bits == 0 ? wide::integer<Bits, Signed>(0) : x >> int(Bits - bits);
+}
+
+/// Sums 0 ... n - 1 by recursive halving, forking at every level.
+uint64_t parallel_sum(wide::thread_pool & pool, uint64_t begin, uint64_t end)
+{
+    if (end - begin <= 16)
+    {
+        uint64_t sum = 0;
+        for (uint64_t i = begin; i < end; ++i)
+            sum += i;
+        return sum;
+    }
+    const uint64_t middle = begin + (end - begin) / 2;
+    uint64_t low = 0;
+    uint64_t high = 0;
+    pool.invoke([&] { low = parallel_sum(pool, begin, middle); }, [&] { high = parallel_sum(pool, middle, end); });
+    return low + high;
+}
+
+}
+
+TEST(WideIntegerParallel, ThreadPool)
+{
+    for (size_t threads : {1, 2, 4})
+    {
+        wide::thread_pool pool(threads);
+        EXPECT_EQ(pool.size(), threads);
+        EXPECT_EQ(parallel_sum(pool, 0, 100000), 100000ULL * 99999 / 2);
+    }
+    EXPECT_GE(wide::thread_pool().size(), 1U);
+}
+
+TEST(WideIntegerParallel, MulWide)
+{
+    std::mt19937_64 rng(48);
+    wide::thread_pool serial(1);
+    wide::thread_pool pool(4);
+    for (int i = 0; i < 20; ++i)
+    {
+        /// Operand sizes straddle the thresholds and are often unbalanced.
+        const auto a = random_value<8192, signed>(rng, 1 + rng() % 8191);
+        const auto b = random_value<8192, signed>(rng, 1 + rng() % 8191);
+        const auto x = i % 3 ? a : S8192(0) - a;
+        const auto expected = wide::mul_wide(x, b);
+        EXPECT_EQ(wide::mul_wide(x, b, serial), expected);
+        EXPECT_EQ(wide::mul_wide(x, b, pool), expected);
+    }
+
+    const U8192 max = ~U8192(0);
+    EXPECT_EQ(wide::mul_wide(max, max, pool), wide::mul_wide(max, max));
+    EXPECT_EQ(wide::mul_wide(max, U8192(0), pool), U16384(0));
+
+    const auto big_a = random_value<65536, unsigned>(rng, 65536);
+    const auto big_b = random_value<65536, unsigned>(rng, 60000);
+    const auto big = wide::mul_wide(big_a, big_b, pool);
+    EXPECT_EQ(big, wide::mul_wide(big_a, big_b));
+    EXPECT_EQ(big, wide::mul_wide(big_a, big_b, serial));
+}
+
+TEST(WideIntegerParallel, ToString)
+{
+    std::mt19937_64 rng(49);
+    wide::thread_pool pool(3);
+    const uint64_t x_small = 1234567890123456789ULL;
+    for (int i = 0; i < 20; ++i)
+    {
+        auto x = random_value<8192, signed>(rng, rng() % 8192);
+        if (i % 2)
+            x = S8192(0) - x;
+        EXPECT_EQ(wide::to_string(x, pool), wide::to_string(x));
+    }
+    EXPECT_EQ(wide::to_string(S8192(0), pool), "0");
+    EXPECT_EQ(wide::to_string(std::numeric_limits<S8192>::min(), pool), wide::to_string(std::numeric_limits<S8192>::min()));
+
+    /// Powers of ten put zeros on both sides of every split.
+    const U8192 power = wide::pow(U8192(10), 2000u);
+    EXPECT_EQ(wide::to_string(power, pool), "1" + std::string(2000, '0'));
+    EXPECT_EQ(wide::to_string(power - U8192(1), pool), std::string(2000, '9'));
+
+    /// The reference to_string divides by 10 per digit, too slow at this width; 10^19000 + x checks
+    /// the split at the top, and the pool sizes must agree on a random value.
+    const U65536 big_power = wide::pow(U65536(10), 19000u) + U65536(x_small);
+    EXPECT_EQ(wide::to_string(big_power, pool), "1" + std::string(19000 - 19, '0') + std::to_string(x_small));
+    const auto big = random_value<65536, unsigned>(rng, 65536) | (U65536(1) << 65535);
+    wide::thread_pool serial(1);
+    const std::string expected = wide::to_string(big, serial);
+    EXPECT_EQ(expected.size(), 19729U);
+    EXPECT_EQ(wide::to_string(big, pool), expected);
+
+    char small[10];
+    EXPECT_EQ(wide::to_chars(small, small + sizeof(small), big, pool).ec, std::errc::value_too_large);
+}
@@ -0,0 +1,172 @@
+#include <cstdint>
+#include <random>
+#include <vector>
+#include <gtest/gtest.h>
+#include <wide_integer/varint.h>
+
+namespace
+{
+
+using S256 = wide::integer<256, signed>;
+using U256 = wide::integer<256, unsigned>;
+using U512 = wide::integer<512, unsigned>;
+
+/// Byte-at-a-time LEB128 as in the DWARF specification.
+template <size_t Bits>
+std::vector<uint8_t> reference_leb128(wide::integer<Bits, unsigned> x)
+{
+    std::vector<uint8_t> out;
+    do
+    {
+        uint8_t byte = static_cast<uint8_t>(x) & 0x7F;
+        x >>= 7;
+        if (x != 0)
+            byte |= 0x80;
+        out.push_back(byte);
+    } while (x != 0);
+    return out;
+}
+
+template <size_t Bits>
+std::vector<wide::integer<Bits, unsigned>> random_values(uint64_t seed)
+{
+    std::mt19937_64 rng(seed);
+    std::vector<wide::integer<Bits, unsigned>> values;
+    for (int i = 0; i < 300; ++i)
+    {
+        wide::integer<Bits, unsigned> x;
+        for (auto & item : x.items)
+            item = rng();
+        values.push_back(x >> static_cast<int>(rng() % Bits));
+    }
+    values.push_back(0);
+    values.push_back(std::numeric_limits<wide::integer<Bits, unsigned>>::max());
+    return values;
+}
+
+template <wide::varint_format Format, size_t Bits, typename Signed>
+void expect_roundtrip(const wide::integer<Bits, Signed> & x)
+{
+    uint8_t buffer[wide::varint_max_size<Bits, Format> + 8];
+    const size_t size = wide::varint_encode<Format>(x, buffer);
+    ASSERT_LE(size, (wide::varint_max_length<Bits, Format>));
+
+    wide::integer<Bits, Signed> y;
+    EXPECT_EQ(wide::varint_decode<Format>(buffer, buffer + size, y), size);
+    EXPECT_EQ(y, x);
+    /// Also with trailing bytes, which takes the whole-word paths.
+    EXPECT_EQ(wide::varint_decode<Format>(buffer, buffer + sizeof(buffer), y), size);
+    EXPECT_EQ(y, x);
+}
+
+
+template <wide::varint_format Format>
+void expect_batch_roundtrip(const std::vector<S256> & values)
+{
+    std::vector<uint8_t> bytes(values.size() * wide::varint_max_size<256, Format>);
+    std::vector<S256> back(values.size());
+    const size_t size = wide::batch::varint_encode<Format>(values.data(), bytes.data(), values.size());
+    EXPECT_EQ(wide::batch::varint_decode<Format>(bytes.data(), bytes.data() + size, back.data(), back.size()), size);
+    EXPECT_EQ(back, values);
+    EXPECT_EQ(wide::batch::varint_decode<Format>(bytes.data(), bytes.data() + size - 1, back.data(), back.size()), 0U);
+}
+
+}
+
+TEST(WideIntegerVarint, Zigzag)
+{
+    EXPECT_EQ(wide::zigzag_encode(S256(0)), U256(0));
+    EXPECT_EQ(wide::zigzag_encode(S256(-1)), U256(1));
+    EXPECT_EQ(wide::zigzag_encode(S256(1)), U256(2));
+    EXPECT_EQ(wide::zigzag_encode(S256(-2)), U256(3));
+    EXPECT_EQ(wide::zigzag_encode(std::numeric_limits<S256>::max()), std::numeric_limits<U256>::max() - U256(1));
+    EXPECT_EQ(wide::zigzag_encode(std::numeric_limits<S256>::min()), std::numeric_limits<U256>::max());
+    for (const S256 x : {S256(0), S256(-7), S256(1) << 200, -(S256(1) << 200), std::numeric_limits<S256>::min()})
+        EXPECT_EQ(wide::zigzag_decode(wide::zigzag_encode(x)), x);
+    static_assert(wide::zigzag_encode(S256(-3)) == U256(5));
+}
+
+TEST(WideIntegerVarint, Leb128)
+{
+    constexpr auto leb128 = wide::varint_format::leb128;
+    uint8_t buffer[40];
+    EXPECT_EQ(wide::varint_encode<leb128>(U256(0), buffer), 1U);
+    EXPECT_EQ(buffer[0], 0);
+    EXPECT_EQ(wide::varint_encode<leb128>(U256(300), buffer), 2U);
+    EXPECT_EQ(buffer[0], 0xAC);
+    EXPECT_EQ(buffer[1], 0x02);
+
+    for (const auto & x : random_values<256>(42))
+    {
+        const auto expected = reference_leb128(x);
+        const size_t size = wide::varint_encode<leb128>(x, buffer);
+        ASSERT_EQ(size, expected.size());
+        EXPECT_EQ(std::vector<uint8_t>(buffer, buffer + size), expected);
+        expect_roundtrip<leb128>(x);
+    }
+    for (const auto & x : random_values<512>(43))
+        expect_roundtrip<leb128>(x);
+    expect_roundtrip<leb128>(S256(-1));
+    expect_roundtrip<leb128>(std::numeric_limits<S256>::min());
+}
+
+TEST(WideIntegerVarint, Prefix)
+{
+    constexpr auto prefix = wide::varint_format::prefix;
+    uint8_t buffer[40];
+    EXPECT_EQ(wide::varint_encode(U256(223), buffer), 1U);
+    EXPECT_EQ(wide::varint_encode(U256(224), buffer), 2U);
+    EXPECT_EQ(buffer[0], 224);
+    EXPECT_EQ(buffer[1], 224);
+    EXPECT_EQ(wide::varint_encode(S256(-100), buffer), 1U);
+    EXPECT_EQ(wide::varint_encode(std::numeric_limits<U256>::max(), buffer), 33U);
+    EXPECT_EQ(buffer[0], 255);
+
+    for (const auto & x : random_values<256>(44))
+        expect_roundtrip<prefix>(x);
+    for (const auto & x : random_values<512>(45))
+        expect_roundtrip<prefix>(x);
+    expect_roundtrip<prefix>(S256(-1) << 100);
+
+    /// At 2048 bits every header byte counts payload bytes, so zero is a header and one byte.
+    using U2048 = wide::integer<2048, unsigned>;
+    uint8_t wide_buffer[wide::varint_max_size<2048, prefix>];
+    EXPECT_EQ(wide::varint_encode(U2048(0), wide_buffer), 2U);
+    EXPECT_EQ(wide_buffer[0], 0);
+    expect_roundtrip<prefix>(U2048(0));
+    expect_roundtrip<prefix>(U2048(255));
+    expect_roundtrip<prefix>(std::numeric_limits<U2048>::max());
+}
+
+TEST(WideIntegerVarint, Malformed)
+{
+    constexpr auto leb128 = wide::varint_format::leb128;
+    U256 x;
+
+    const uint8_t truncated[] = {0x80, 0x80, 0x80};
+    EXPECT_EQ(wide::varint_decode<leb128>(truncated, truncated + 3, x), 0U);
+    const uint8_t empty[1] = {};
+    EXPECT_EQ(wide::varint_decode<leb128>(empty, empty, x), 0U);
+    EXPECT_EQ(wide::varint_decode(empty, empty, x), 0U);
+
+    /// 37 groups hold 259 bits: the top three must be clear.
+    std::vector<uint8_t> too_big(37, 0xFF);
+    too_big.back() = 0x1F;
+    EXPECT_EQ(wide::varint_decode<leb128>(too_big.data(), too_big.data() + too_big.size(), x), 0U);
+    too_big.back() = 0x0F;
+    EXPECT_EQ(wide::varint_decode<leb128>(too_big.data(), too_big.data() + too_big.size(), x), 37U);
+    EXPECT_EQ(x, std::numeric_limits<U256>::max());
+    std::vector<uint8_t> too_long(38, 0x80);
+    too_long.back() = 0;
+    EXPECT_EQ(wide::varint_decode<leb128>(too_long.data(), too_long.data() + too_long.size(), x), 0U);
+
+    const uint8_t short_prefix[] = {230, 1, 2};
+    EXPECT_EQ(wide::varint_decode(short_prefix, short_prefix + 3, x), 0U);
+}
+
+TEST(WideIntegerVarint, Batch)
+{
+    const std::vector<S256> values = {S256(0), S256(-1), S256(1) << 100, S256(123456), -(S256(1) << 250), S256(99)};
+    expect_batch_roundtrip<wide::varint_format::prefix>(values);
+    expect_batch_roundtrip<wide::varint_format::leb128>(values);
+}
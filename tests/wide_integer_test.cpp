@@ -1,4 +1,6 @@
+#include <cmath>
 #include <cstdint>
+#include <cstring>
 #include <limits>
 #include <fmt/format.h>
 #include <gtest/gtest.h>
@@ -576,6 +578,150 @@ TEST(WideIntegerExtra, FloatConversion)
     EXPECT_EQ(s, -789);
 }
 
+TEST(WideIntegerConversion, FloatingRounding)
+{
+    using U256 = wide::integer<256, unsigned>;
+    using S256 = wide::integer<256, signed>;
+    using U128 = wide::integer<128, unsigned>;
+    const U256 one = 1;
+    const U256 base = one << 200;
+
+    /// The spacing of doubles at 2^200 is 2^148: ties go to even, anything past a tie rounds up.
+    EXPECT_EQ(static_cast<double>(base + one), std::ldexp(1.0, 200));
+    EXPECT_EQ(static_cast<double>(base + (one << 147)), std::ldexp(1.0, 200));
+    EXPECT_EQ(static_cast<double>(base + (one << 147) + one), std::ldexp(1.0, 200) + std::ldexp(1.0, 148));
+    EXPECT_EQ(static_cast<double>(base + (U256(3) << 147)), std::ldexp(1.0, 200) + std::ldexp(1.0, 149));
+    EXPECT_EQ(static_cast<double>(-(S256(1) << 200) - (S256(1) << 147) - S256(1)), -(std::ldexp(1.0, 200) + std::ldexp(1.0, 148)));
+    EXPECT_EQ(static_cast<double>(std::numeric_limits<S256>::min()), -std::ldexp(1.0, 255));
+    EXPECT_EQ(static_cast<double>(std::numeric_limits<U256>::max()), std::ldexp(1.0, 256));
+    EXPECT_TRUE(std::isinf(static_cast<float>(std::numeric_limits<U256>::max())));
+
+    /// A 64-bit significand rounds on its own; all ones carries into the exponent.
+    EXPECT_EQ(static_cast<long double>(base + (one << 136)), std::ldexp(1.0L, 200));
+    EXPECT_EQ(static_cast<long double>(base + (one << 136) + one), std::ldexp(1.0L, 200) + std::ldexp(1.0L, 137));
+    EXPECT_EQ(static_cast<long double>(std::numeric_limits<U128>::max()), std::ldexp(1.0L, 128));
+
+    /// The hardware conversion from unsigned __int128 rounds correctly, and scaling by 2^k is exact.
+    uint64_t state = 0x9E3779B97F4A7C15ULL;
+    for (int i = 0; i < 200; ++i)
+    {
+        state = state * 6364136223846793005ULL + 1442695040888963407ULL;
+        const unsigned __int128 v = (static_cast<unsigned __int128>(state) << 64) | (state * 0xD1B54A32D192ED03ULL);
+        const int k = i % 128;
+        EXPECT_EQ(static_cast<double>(U256(v) << k), std::ldexp(static_cast<double>(v), k));
+        EXPECT_EQ(static_cast<float>(U256(v) << k), std::ldexp(static_cast<float>(v), k));
+    }
+}
+
+TEST(WideIntegerConversion, FromFloating)
+{
+    using U256 = wide::integer<256, unsigned>;
+    using S256 = wide::integer<256, signed>;
+
+    const double d = std::ldexp(static_cast<double>(0x123456789ABCDEULL), 150);
+    EXPECT_EQ(U256(d), U256(0x123456789ABCDEULL) << 150);
+    EXPECT_EQ(S256(-d), -(S256(0x123456789ABCDEULL) << 150));
+    EXPECT_EQ(static_cast<double>(U256(d)), d);
+    EXPECT_EQ(U256(std::ldexp(1.0, 63)), U256(1) << 63);
+    EXPECT_EQ(S256(-std::ldexp(1.0, 64)), -(S256(1) << 64));
+    EXPECT_EQ(S256(std::ldexp(3.0, 100) + std::ldexp(1.0, 60)), (S256(3) << 100) + (S256(1) << 60));
+    EXPECT_EQ(S256(-12345.75), S256(-12345));
+    EXPECT_EQ(U256(std::numeric_limits<double>::quiet_NaN()), U256(0));
+    EXPECT_EQ(U256(std::ldexp(1.0, 190) + std::ldexp(1.0, 140)), (U256(1) << 190) + (U256(1) << 140));
+
+#ifndef USE_CXX11_HEADER
+    static_assert(static_cast<double>((U256(1) << 200) + U256(1)) == 0x1p200);
+    static_assert(U256(0x1.8p130) == U256(3) << 129);
+#endif
+}
+
+TEST(WideIntegerConversion, Bytes)
+{
+    using U256 = wide::integer<256, unsigned>;
+    using S128 = wide::integer<128, signed>;
+
+    uint8_t counting[32];
+    for (int i = 0; i < 32; ++i)
+        counting[i] = static_cast<uint8_t>(i + 1);
+    U256 expected = 0;
+    for (int i = 0; i < 32; ++i)
+        expected = (expected << 8) | U256(i + 1);
+
+    EXPECT_EQ(wide::load_be<U256>(counting), expected);
+    EXPECT_EQ(wide::load_le<U256>(counting), wide::byteswap(expected));
+
+    uint8_t out[33] = {};
+    wide::store_be(expected, out + 1);
+    for (int i = 0; i < 32; ++i)
+        EXPECT_EQ(out[i + 1], counting[i]);
+    wide::store_le(expected, out);
+    for (int i = 0; i < 32; ++i)
+        EXPECT_EQ(out[i], counting[31 - i]);
+
+    uint8_t bytes[16];
+    wide::store_be(S128(-2), bytes);
+    EXPECT_EQ(bytes[0], 0xFF);
+    EXPECT_EQ(bytes[15], 0xFE);
+    EXPECT_EQ(wide::load_be<S128>(bytes), S128(-2));
+    wide::store_le(S128(-2), bytes);
+    EXPECT_EQ(bytes[0], 0xFE);
+    EXPECT_EQ(wide::load_le<S128>(bytes), S128(-2));
+}
+
+TEST(WideIntegerLayout, Limbs)
+{
+    using U256 = wide::integer<256, unsigned>;
+    static_assert(wide::has_plain_layout<256, unsigned>::value, "plain layout");
+    static_assert(wide::has_plain_layout<192, signed>::value, "plain layout");
+
+    U256 x = (U256(3) << 192) | U256(5);
+    auto view = wide::limbs(x);
+    ASSERT_EQ(view.size(), 4U);
+    uint64_t sum = 0;
+    for (uint64_t limb : view)
+        sum += limb;
+    EXPECT_EQ(sum, 8U);
+#if !defined(__BYTE_ORDER__) || __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__ || defined(USE_CXX11_HEADER)
+    EXPECT_EQ(view[0], 5U);
+    EXPECT_EQ(view[3], 3U);
+    view[1] = 1;
+    EXPECT_EQ(x, (U256(3) << 192) | (U256(1) << 64) | U256(5));
+#endif
+
+    /// The limbs are the whole object: a byte copy reproduces the value.
+    const U256 & cx = x;
+    U256 copy;
+    std::memcpy(wide::limbs(copy).data(), wide::limbs(cx).data(), sizeof(copy));
+    EXPECT_EQ(copy, x);
+}
+
+TEST(WideIntegerLayout, AlignedInteger)
+{
+    using S256 = wide::integer<256, signed>;
+    using A128 = wide::aligned_integer<128, unsigned>;
+    using A256 = wide::aligned_integer<256, signed>;
+    using A512 = wide::aligned_integer<512, unsigned>;
+    using A192 = wide::aligned_integer<192, unsigned>;
+    static_assert(alignof(A128) == 16 && sizeof(A128) == 16, "aligned 128");
+    static_assert(alignof(A256) == 32 && sizeof(A256) == 32, "aligned 256");
+    static_assert(alignof(A512) == 64 && sizeof(A512) == 64, "aligned 512");
+    static_assert(alignof(A192) == 32 && sizeof(A192) == 32, "aligned 192");
+    static_assert(alignof(wide::aligned_integer<256, unsigned, 64>) == 64, "explicit alignment");
+    static_assert(std::is_trivially_copyable<A256>::value, "trivially copyable");
+
+    A256 slots[4];
+    for (auto & slot : slots)
+        EXPECT_EQ(reinterpret_cast<uintptr_t>(&slot) % 32, 0U);
+
+    A256 a = -7;
+    A256 b = S256(3) << 200;
+    slots[1] = a + b;
+    EXPECT_EQ(slots[1] - b, S256(-7));
+    EXPECT_TRUE(a < b);
+    EXPECT_EQ(wide::to_string(a), "-7");
+    EXPECT_EQ(wide::limbs(a).size(), 4U);
+}
+
 TEST(WideIntegerConversion, UnsignedRoundtrip)
 {
     wide::integer<128, unsigned> w = 42;
@@ -785,3 +931,355 @@ TEST(WideInteger256, Division)
     EXPECT_EQ(wide::to_string(q), "1627024769791889844363837995440879160110719541703693");
     EXPECT_EQ(static_cast<uint64_t>(r), 865650712ULL);
 }
+
+TEST(WideIntegerOverflow, AddSub)
+{
+    using U = wide::integer<256, unsigned>;
+    using S = wide::integer<256, signed>;
+    U ures;
+    EXPECT_FALSE(wide::add_overflow(U(1) << 200, U(5), &ures));
+    EXPECT_EQ(ures, (U(1) << 200) + U(5));
+    EXPECT_TRUE(wide::add_overflow(std::numeric_limits<U>::max(), U(2), &ures));
+    EXPECT_EQ(ures, U(1));
+    EXPECT_TRUE(wide::sub_overflow(U(1), U(2), &ures));
+    EXPECT_EQ(ures, std::numeric_limits<U>::max());
+    EXPECT_FALSE(wide::sub_overflow(U(2), U(1), &ures));
+    EXPECT_EQ(ures, U(1));
+
+    S sres;
+    EXPECT_FALSE(wide::add_overflow(S(-5), S(3), &sres));
+    EXPECT_EQ(sres, S(-2));
+    EXPECT_TRUE(wide::add_overflow(std::numeric_limits<S>::max(), S(1), &sres));
+    EXPECT_EQ(sres, std::numeric_limits<S>::min());
+    EXPECT_TRUE(wide::add_overflow(std::numeric_limits<S>::min(), S(-1), &sres));
+    EXPECT_EQ(sres, std::numeric_limits<S>::max());
+    EXPECT_FALSE(wide::sub_overflow(S(-1), std::numeric_limits<S>::max(), &sres));
+    EXPECT_EQ(sres, std::numeric_limits<S>::min());
+    EXPECT_TRUE(wide::sub_overflow(S(0), std::numeric_limits<S>::min(), &sres));
+    EXPECT_EQ(sres, std::numeric_limits<S>::min());
+
+    /// The result may alias either operand.
+    S b = 7;
+    EXPECT_FALSE(wide::add_overflow(S(5), b, &b));
+    EXPECT_EQ(b, S(12));
+    EXPECT_FALSE(wide::add_overflow(b, S(-20), &b));
+    EXPECT_EQ(b, S(-8));
+    EXPECT_FALSE(wide::sub_overflow(S(5), b, &b));
+    EXPECT_EQ(b, S(13));
+    U u = std::numeric_limits<U>::max();
+    EXPECT_TRUE(wide::add_overflow(u, u, &u));
+    EXPECT_EQ(u, std::numeric_limits<U>::max() - U(1));
+    u = 3;
+    EXPECT_TRUE(wide::sub_overflow(U(1), u, &u));
+    EXPECT_EQ(u, std::numeric_limits<U>::max() - U(1));
+}
+
+TEST(WideIntegerOverflow, Mul)
+{
+    using U = wide::integer<256, unsigned>;
+    using S = wide::integer<256, signed>;
+    U ures;
+    EXPECT_FALSE(wide::mul_overflow(U(1) << 127, U(1) << 128, &ures));
+    EXPECT_EQ(ures, U(1) << 255);
+    EXPECT_TRUE(wide::mul_overflow(U(1) << 128, U(1) << 128, &ures));
+    EXPECT_EQ(ures, U(0));
+    EXPECT_TRUE(wide::mul_overflow(std::numeric_limits<U>::max(), U(3), &ures));
+    EXPECT_EQ(ures, std::numeric_limits<U>::max() - U(2));
+
+    S sres;
+    EXPECT_FALSE(wide::mul_overflow(S(-3), S(7), &sres));
+    EXPECT_EQ(sres, S(-21));
+    EXPECT_FALSE(wide::mul_overflow(S(-(S(1) << 127)), S(1) << 128, &sres));
+    EXPECT_EQ(sres, std::numeric_limits<S>::min());
+    EXPECT_TRUE(wide::mul_overflow(S(1) << 127, S(1) << 128, &sres));
+    EXPECT_EQ(sres, std::numeric_limits<S>::min());
+    EXPECT_TRUE(wide::mul_overflow(std::numeric_limits<S>::min(), S(-1), &sres));
+    EXPECT_EQ(sres, std::numeric_limits<S>::min());
+    EXPECT_FALSE(wide::mul_overflow(S(-(S(1) << 100)), S(-(S(1) << 100)), &sres));
+    EXPECT_EQ(sres, S(1) << 200);
+}
+
+TEST(WideIntegerOverflow, Checked)
+{
+    using C = wide::checked<128, signed>;
+    C a = wide::integer<128, signed>(1) << 125;
+    C b = a + a;
+    EXPECT_FALSE(b.overflowed());
+    EXPECT_THROW(b + b, std::overflow_error);
+    EXPECT_THROW(b * C(4), std::overflow_error);
+    EXPECT_THROW(C(std::numeric_limits<wide::integer<128, signed>>::min()) / C(-1), std::overflow_error);
+    EXPECT_THROW(b / C(0), std::runtime_error);
+    EXPECT_EQ((b - a).value(), a.value());
+
+    using R = wide::checked<128, unsigned, wide::record_overflow>;
+    R x = wide::integer<128, unsigned>(1);
+    R y = x - R(2);
+    EXPECT_TRUE(y.overflowed());
+    EXPECT_EQ(y.value(), (std::numeric_limits<wide::integer<128, unsigned>>::max()));
+    R z = y + R(5);
+    EXPECT_TRUE(z.overflowed());
+    EXPECT_EQ(z.value(), (wide::integer<128, unsigned>(4)));
+    EXPECT_FALSE((x * R(7)).overflowed());
+}
+
+TEST(WideIntegerOverflow, MulWide)
+{
+    using U256 = wide::integer<256, unsigned>;
+    using U512 = wide::integer<512, unsigned>;
+    using S256 = wide::integer<256, signed>;
+    using S512 = wide::integer<512, signed>;
+
+    const U256 max = std::numeric_limits<U256>::max();
+    /// (2^256 - 1)^2 = 2^512 - 2^257 + 1
+    EXPECT_EQ(wide::mul_wide(max, max), ~U512(0) - (U512(1) << 257) + U512(2));
+    EXPECT_EQ(wide::mul_wide(U256(3), U256(7)), U512(21));
+
+    const S256 min = std::numeric_limits<S256>::min();
+    EXPECT_EQ(wide::mul_wide(min, min), S512(1) << 510);
+    EXPECT_EQ(wide::mul_wide(min, S256(-1)), S512(1) << 255);
+    EXPECT_EQ(wide::mul_wide(min, S256(1)), -(S512(1) << 255));
+    EXPECT_EQ(wide::mul_wide(S256(-3), S256(7)), S512(-21));
+    EXPECT_EQ(wide::mul_wide(S256(-3), S256(-7)), S512(21));
+}
+
+TEST(WideIntegerFused, MatchesSeparateOperators)
+{
+    using U256 = wide::integer<256, unsigned>;
+    using S256 = wide::integer<256, signed>;
+
+    const U256 max = std::numeric_limits<U256>::max();
+    const U256 values[]
+        = {U256(0), U256(1), U256(7), max, max - U256(12345), (U256(1) << 200) + U256(3), U256(0xFFFFFFFFFFFFFFFFULL) << 64};
+    for (const U256 & a : values)
+        for (const U256 & b : values)
+            for (const U256 & c : values)
+            {
+                EXPECT_EQ(wide::fma(a, b, c), a * b + c);
+                U256 acc = c;
+                wide::mul_add(acc, a, b);
+                EXPECT_EQ(acc, a * b + c);
+                acc = c;
+                wide::mul_sub(acc, a, b);
+                EXPECT_EQ(acc, c - a * b);
+            }
+
+    const uint64_t scalars[] = {0, 1, 10, 0xFFFFFFFFFFFFFFFFULL};
+    for (const U256 & a : values)
+        for (uint64_t k : scalars)
+        {
+            U256 acc = max;
+            wide::add_mul_scalar(acc, a, k);
+            EXPECT_EQ(acc, max + a * U256(k));
+        }
+
+    const S256 x = -(S256(1) << 130) + S256(5);
+    const S256 y = S256(-3);
+    EXPECT_EQ(wide::fma(x, y, S256(-7)), x * y - S256(7));
+    S256 acc = S256(11);
+    wide::mul_sub(acc, x, y);
+    EXPECT_EQ(acc, S256(11) - x * y);
+    wide::add_mul_scalar(acc, x, 3);
+    EXPECT_EQ(acc, S256(11) - x * y + x * S256(3));
+
+    /// (2^256 - 1)^2 = 1 modulo 2^256.
+    EXPECT_EQ(wide::fma(max, max, U256(5)), U256(6));
+}
+
+TEST(WideIntegerSaturating, Scalar)
+{
+    using U = wide::integer<256, unsigned>;
+    using S = wide::integer<256, signed>;
+    const U umax = std::numeric_limits<U>::max();
+    const S smin = std::numeric_limits<S>::min();
+    const S smax = std::numeric_limits<S>::max();
+
+    EXPECT_EQ(wide::add_sat(umax, U(1)), umax);
+    EXPECT_EQ(wide::add_sat(U(1), U(2)), U(3));
+    EXPECT_EQ(wide::sub_sat(U(1), U(2)), U(0));
+    EXPECT_EQ(wide::mul_sat(U(1) << 128, U(1) << 128), umax);
+
+    EXPECT_EQ(wide::add_sat(smax, S(1)), smax);
+    EXPECT_EQ(wide::add_sat(smin, S(-1)), smin);
+    EXPECT_EQ(wide::sub_sat(smin, S(1)), smin);
+    EXPECT_EQ(wide::sub_sat(S(0), smin), smax);
+    EXPECT_EQ(wide::mul_sat(S(1) << 200, S(-(S(1) << 100))), smin);
+    EXPECT_EQ(wide::mul_sat(S(-(S(1) << 200)), S(-(S(1) << 100))), smax);
+    EXPECT_EQ(wide::mul_sat(S(-6), S(7)), S(-42));
+}
+
+TEST(WideIntegerSaturating, Wrapper)
+{
+    using S = wide::integer<128, signed>;
+    using Sat = wide::saturating<128, signed>;
+    Sat acc = std::numeric_limits<S>::max() - S(5);
+    acc += Sat(S(10));
+    EXPECT_EQ(acc.value(), std::numeric_limits<S>::max());
+    acc -= Sat(S(1));
+    EXPECT_EQ(acc.value(), std::numeric_limits<S>::max() - S(1));
+    EXPECT_EQ((-Sat(std::numeric_limits<S>::min())).value(), std::numeric_limits<S>::max());
+    EXPECT_EQ((Sat(std::numeric_limits<S>::min()) / Sat(S(-1))).value(), std::numeric_limits<S>::max());
+    EXPECT_EQ((Sat(S(-3)) * Sat(S(4))).value(), S(-12));
+}
+
+TEST(WideIntegerBits, CountsAndWidth)
+{
+    using U256 = wide::integer<256, unsigned>;
+
+    EXPECT_EQ(wide::popcount(U256(0)), 0);
+    EXPECT_EQ(wide::popcount(~U256(0)), 256);
+    EXPECT_EQ(wide::popcount((U256(1) << 200) | U256(0xFF)), 9);
+
+    EXPECT_EQ(wide::countl_zero(U256(0)), 256);
+    EXPECT_EQ(wide::countl_zero(U256(1)), 255);
+    EXPECT_EQ(wide::countl_zero(U256(1) << 130), 125);
+    EXPECT_EQ(wide::countr_zero(U256(0)), 256);
+    EXPECT_EQ(wide::countr_zero(U256(1) << 130), 130);
+    EXPECT_EQ(wide::countl_one(~U256(0) << 3), 253);
+    EXPECT_EQ(wide::countr_one(U256(0x7)), 3);
+
+    EXPECT_EQ(wide::bit_width(U256(0)), 0);
+    EXPECT_EQ(wide::bit_width(U256(1)), 1);
+    EXPECT_EQ(wide::bit_width((U256(1) << 255) + U256(3)), 256);
+
+    EXPECT_TRUE(wide::has_single_bit(U256(1) << 77));
+    EXPECT_FALSE(wide::has_single_bit(U256(0)));
+    EXPECT_FALSE(wide::has_single_bit((U256(1) << 77) | U256(4)));
+}
+
+TEST(WideIntegerBits, RotateAndByteswap)
+{
+    using U256 = wide::integer<256, unsigned>;
+    const U256 x = (U256(0x0123456789ABCDEFULL) << 192) | (U256(0xFEDCBA9876543210ULL) << 64) | U256(0x55);
+
+    const int shifts[] = {0, 1, 63, 64, 65, 128, 200, 255, 256, 300, -1, -70};
+    for (int s : shifts)
+    {
+        const int r = ((s % 256) + 256) % 256;
+        const U256 expected = r == 0 ? x : (x << r) | (x >> (256 - r));
+        EXPECT_EQ(wide::rotl(x, s), expected);
+        EXPECT_EQ(wide::rotr(wide::rotl(x, s), s), x);
+        EXPECT_EQ(wide::rotr(x, -s), expected);
+    }
+
+    const U256 swapped = wide::byteswap(x);
+    EXPECT_EQ(swapped >> 192, U256(0x5500000000000000ULL));
+    EXPECT_EQ(wide::byteswap(swapped), x);
+    EXPECT_EQ(wide::byteswap(U256(1)), U256(1) << 248);
+}
+
+namespace
+{
+
+template <typename T>
+T power_of_two(unsigned k)
+{
+    T res = 1;
+    for (unsigned i = 0; i < k; ++i)
+        res += res;
+    return res;
+}
+
+}
+
+TEST(WideIntegerShift, MatchesRotateMasks)
+{
+    using U256 = wide::integer<256, unsigned>;
+    const U256 x = (U256(0x0123456789ABCDEFULL) << 192) | (U256(0xFEDCBA9876543210ULL) << 64) | U256(0x8000000000000055ULL);
+
+    for (int n = 0; n < 256; ++n)
+    {
+        const U256 left = wide::rotl(x, n) & ~(power_of_two<U256>(n) - 1);
+        const U256 right = wide::rotr(x, n) & (power_of_two<U256>(256 - n) - 1);
+        EXPECT_EQ(x << n, left) << n;
+        EXPECT_EQ(x >> n, right) << n;
+
+        U256 y = x;
+        y <<= n;
+        EXPECT_EQ(y, left) << n;
+        y = x;
+        y >>= n;
+        EXPECT_EQ(y, right) << n;
+    }
+
+    U256 y = x;
+    y <<= 256;
+    EXPECT_EQ(y, U256(0));
+    y = x;
+    y >>= 300;
+    EXPECT_EQ(y, U256(0));
+}
+
+#define EXPECT_CONSTANT_SHIFT(x, N) \
+    EXPECT_EQ(wide::shl<N>(x), (x) << (N)); \
+    EXPECT_EQ(wide::shr<N>(x), (x) >> (N))
+
+TEST(WideIntegerShift, CompileTimeCount)
+{
+    using U256 = wide::integer<256, unsigned>;
+    using S128 = wide::integer<128, signed>;
+    const U256 x = (U256(0x0123456789ABCDEFULL) << 192) | (U256(0xFEDCBA9876543210ULL) << 64) | U256(0x8000000000000055ULL);
+    const S128 s = (S128(0x7EDCBA9876543210LL) << 64) | S128(0x1234);
+
+    EXPECT_CONSTANT_SHIFT(x, 0);
+    EXPECT_CONSTANT_SHIFT(x, 1);
+    EXPECT_CONSTANT_SHIFT(x, 63);
+    EXPECT_CONSTANT_SHIFT(x, 64);
+    EXPECT_CONSTANT_SHIFT(x, 65);
+    EXPECT_CONSTANT_SHIFT(x, 128);
+    EXPECT_CONSTANT_SHIFT(x, 130);
+    EXPECT_CONSTANT_SHIFT(x, 192);
+    EXPECT_CONSTANT_SHIFT(x, 255);
+    EXPECT_CONSTANT_SHIFT(s, 0);
+    EXPECT_CONSTANT_SHIFT(s, 5);
+    EXPECT_CONSTANT_SHIFT(s, 64);
+    EXPECT_CONSTANT_SHIFT(s, 100);
+    EXPECT_CONSTANT_SHIFT(s, 127);
+
+    EXPECT_EQ(wide::shl<256>(x), U256(0));
+    EXPECT_EQ(wide::shr<300>(x), U256(0));
+}
+
+#undef EXPECT_CONSTANT_SHIFT
+
+#ifndef USE_CXX11_HEADER
+TEST(WideIntegerShift, ArithmeticAndWideCounts)
+{
+    using U256 = wide::integer<256, unsigned>;
+    using S256 = wide::integer<256, signed>;
+    const S256 neg = -(S256(0x0123456789ABCDEFLL) << 100) - 12345;
+    for (int n = 0; n < 256; n += 7)
+    {
+        const S256 expected = ~S256(U256(~neg) >> n);
+        EXPECT_EQ(neg >> n, expected) << n;
+        S256 y = neg;
+        y >>= n;
+        EXPECT_EQ(y, expected) << n;
+    }
+    EXPECT_EQ(wide::shr<70>(neg), neg >> 70);
+    EXPECT_EQ(wide::shr<128>(neg), neg >> 128);
+
+    const U256 x = ~U256(0);
+    EXPECT_EQ(x << (size_t(1) << 32 | 1), U256(0));
+    EXPECT_EQ(x >> (uint64_t(1) << 40), U256(0));
+    EXPECT_EQ(x << 3u, x - 7);
+
+    static_assert(wide::shl<65>(U256(3)) == U256{0ULL, 6ULL, 0ULL, 0ULL});
+    static_assert(wide::shr<63>(U256{0ULL, 1ULL, 0ULL, 0ULL}) == U256(2));
+    static_assert((U256(1) << 200) == U256{0ULL, 0ULL, 0ULL, 1ULL << 8});
+}
+#endif
+
+#ifndef USE_CXX11_HEADER
+TEST(WideIntegerBits, Constexpr)
+{
+    using U256 = wide::integer<256, unsigned>;
+    static_assert(wide::popcount(U256(0xFF)) == 8);
+    static_assert(wide::countl_zero(U256(1)) == 255);
+    static_assert(wide::countr_zero(U256(8)) == 3);
+    static_assert(wide::bit_width(U256(5)) == 3);
+    static_assert(wide::has_single_bit(U256(64)));
+    /// Items are listed least significant first.
+    static_assert(wide::rotl(U256(1), -1) == U256{0ULL, 0ULL, 0ULL, 0x8000000000000000ULL});
+    static_assert(wide::byteswap(U256(1)) == U256{0ULL, 0ULL, 0ULL, 0x0100000000000000ULL});
+}
+#endif